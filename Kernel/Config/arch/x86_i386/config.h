@@ -119,5 +119,13 @@
 #define TEMP_DEBUG_ENABLED 0
 #define USER_HEAP_DEBUG_ENABLED 0
 #define SEMAPHORE_DEBUG_ENABLED 0
+#define RWLOCK_DEBUG_ENABLED 0
+#define COND_DEBUG_ENABLED 0
+#define BARRIER_DEBUG_ENABLED 0
+#define LATCH_DEBUG_ENABLED 0
+#define VDSO_DEBUG_ENABLED 0
+#define SOFTIRQ_DEBUG_ENABLED 0
+#define WORKQUEUE_DEBUG_ENABLED 0
+#define PROFILER_DEBUG_ENABLED 0
 
 #endif /* #ifndef __GLOBAL_CONFIG_H_ */
\ No newline at end of file
@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+################################################################################
+# UTK binary event log decoder
+#
+# Created: 04/04/2022
+#
+# Author: Alexy Torres Aurora Dugo
+#
+# Rebuilds the debug messages of a kernel compiled with EVENT_LOG=TRUE. The
+# event lines of the serial output are decoded with the call site descriptors
+# stored in the .kevent_desc and .kevent_str sections of the kernel ELF file.
+# The other lines are copied unchanged.
+#
+# Usage: decode_event_log.py <kernel ELF> [serial output file]
+################################################################################
+
+import struct
+import sys
+
+EVENT_LINE_TAG    = "#EVT"
+EVENT_HEADER_SIZE = 4
+EVENT_DESC_FORMAT = "<IIIII"
+EVENT_DESC_SIZE   = struct.calcsize(EVENT_DESC_FORMAT)
+
+SHF_ALLOC = 0x2
+
+
+class KernelElf:
+    """ Reads the sections of a 32 bits little endian ELF file. """
+
+    def __init__(self, path):
+        with open(path, "rb") as elf_file:
+            self.data = elf_file.read()
+
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1:
+            raise ValueError("{} is not a 32 bits ELF file".format(path))
+
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data,
+                                                        0x2E)
+
+        headers = []
+        for i in range(shnum):
+            headers.append(struct.unpack_from("<IIIIII", self.data,
+                                              shoff + i * shentsize))
+
+        names_offset = headers[shstrndx][4]
+        self.sections = {}
+        self.allocated = []
+        for name, _, flags, addr, offset, size in headers:
+            section_name = self.read_string(names_offset + name)
+            self.sections[section_name] = (addr, offset, size)
+            if flags & SHF_ALLOC:
+                self.allocated.append((addr, offset, size))
+
+    def read_string(self, offset):
+        end = self.data.index(b"\0", offset)
+        return self.data[offset:end].decode("ascii", "replace")
+
+    def section(self, name):
+        if name not in self.sections:
+            raise ValueError("Missing section {}, was the kernel compiled "
+                             "with EVENT_LOG=TRUE?".format(name))
+        return self.sections[name]
+
+    def read_kernel_string(self, address):
+        """ Reads a string from the kernel memory image if possible. """
+        for addr, offset, size in self.allocated:
+            if addr <= address < addr + size:
+                return self.read_string(offset + address - addr)
+        return None
+
+
+class EventDecoder:
+    """ Rebuilds the events text from their descriptors. """
+
+    def __init__(self, elf):
+        self.elf = elf
+        _, self.desc_offset, self.desc_size = elf.section(".kevent_desc")
+        _, self.str_offset, self.str_size = elf.section(".kevent_str")
+
+    def descriptor(self, event_id):
+        if event_id + EVENT_DESC_SIZE > self.desc_size:
+            return None
+        module, fmt, source, line, _ = struct.unpack_from(
+            EVENT_DESC_FORMAT, self.elf.data, self.desc_offset + event_id)
+        return (self.elf.read_string(self.str_offset + module),
+                self.elf.read_string(self.str_offset + fmt),
+                self.elf.read_string(self.str_offset + source),
+                line)
+
+    def format(self, fmt, words):
+        """ Formats the arguments the same way the kernel formater does. """
+        output = []
+        pos = 0
+        while pos < len(fmt):
+            if fmt[pos] != "%":
+                output.append(fmt[pos])
+                pos += 1
+                continue
+
+            pos += 1
+            length = 4
+            padding = 0
+            pad_char = " "
+            while pos < len(fmt):
+                char = fmt[pos]
+                pos += 1
+                if char == "%":
+                    output.append("%")
+                    break
+                elif char == "h":
+                    length //= 2
+                elif char == "l":
+                    length *= 2
+                elif char.isdigit():
+                    if char == "0" and padding == 0:
+                        pad_char = "0"
+                    else:
+                        padding = padding * 10 + int(char)
+                elif char in "sdiuxXpPc":
+                    if char in "pP":
+                        length = 4
+                        padding = 8
+                        pad_char = "0"
+                    value = 0
+                    if length >= 8 and char != "c":
+                        if len(words) >= 2:
+                            value = words[0] | (words[1] << 32)
+                        words = words[2:]
+                    else:
+                        if words:
+                            value = words[0]
+                        words = words[1:]
+                        if length == 1:
+                            value &= 0xFF
+                        elif length == 2:
+                            value &= 0xFFFF
+
+                    if char == "s":
+                        text = self.elf.read_kernel_string(value)
+                        if text is None:
+                            text = "<0x{:08x}>".format(value)
+                    elif char == "c":
+                        text = chr(value & 0xFF)
+                    elif char in "di":
+                        bits = 64 if length >= 8 else 32
+                        if value & (1 << (bits - 1)):
+                            value -= 1 << bits
+                        text = str(value)
+                    elif char == "u":
+                        text = str(value)
+                    elif char in "xp":
+                        text = "{:x}".format(value)
+                    else:
+                        text = "{:X}".format(value)
+
+                    if char not in "sc":
+                        text = text.rjust(padding, pad_char)
+                    output.append(text)
+                    break
+        return "".join(output)
+
+    def decode(self, line):
+        try:
+            words = [int(word, 16) for word in line.split()[1:]]
+        except ValueError:
+            return line
+
+        if len(words) < EVENT_HEADER_SIZE:
+            return line
+
+        event_id = words[0]
+        cpu_id = words[1] >> 16
+        timestamp = words[2] | (words[3] << 32)
+
+        desc = self.descriptor(event_id)
+        if desc is None:
+            return "[DEBUG] Unknown event 0x{:x} | CPU {} | {}".format(
+                event_id, cpu_id, timestamp)
+
+        module, fmt, source, source_line = desc
+        text = self.format(fmt, words[EVENT_HEADER_SIZE:])
+        return "[DEBUG] {} | {} | {}:{} | CPU {} | {}".format(
+            module, text, source, source_line, cpu_id, timestamp)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: {} <kernel ELF> [serial output file]".format(
+            sys.argv[0]))
+        return 1
+
+    decoder = EventDecoder(KernelElf(sys.argv[1]))
+
+    if len(sys.argv) > 2:
+        serial = open(sys.argv[2], "r", errors="replace")
+    else:
+        serial = sys.stdin
+
+    for line in serial:
+        line = line.rstrip("\r\n")
+        if line.startswith(EVENT_LINE_TAG):
+            print(decoder.decode(line))
+        else:
+            print(line)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -164,6 +164,40 @@ void uart_console_write_keyboard(const char* string, const size_t len);
  */
 const kernel_graphic_driver_t* uart_get_driver(void);
 
+/**
+ * @brief Enables the serial interrupts.
+ *
+ * @details Registers the serial interrupt handlers and unmasks the serial IRQ
+ * lines. From then on, the output port is interrupt driven: the characters are
+ * queued in a transmit ring and sent in bursts of FIFO depth by the
+ * transmitter empty interrupt. Received characters are buffered by the
+ * receive interrupt. The interrupt manager must be initialized before calling
+ * this function.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the interrupts are already
+ * enabled.
+ * - Other error codes returned by the IRQ handler registration.
+ */
+OS_RETURN_E uart_enable_interrupts(void);
+
+/**
+ * @brief Switches the output port back to polled output.
+ *
+ * @details Sends the queued characters and writes the following characters
+ * directly to the port. This function is used when interrupts will not be
+ * serviced anymore, for instance on panic.
+ */
+void uart_sync(void);
+
+/**
+ * @brief Returns the number of received characters dropped since boot.
+ *
+ * @return The number of characters dropped because a receive ring was full.
+ */
+uint32_t uart_get_recv_dropped(void);
+
 #endif /* #ifndef __BOARD_UART_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
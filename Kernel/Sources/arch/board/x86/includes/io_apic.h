@@ -35,7 +35,8 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Maximal number of IRQs considered by the IRQ balancer. */
+#define IOAPIC_BALANCE_MAX_IRQ 64
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -120,6 +121,67 @@ INTERRUPT_TYPE_E io_apic_handle_spurious_irq(const uint32_t int_number);
  */
 int32_t io_apic_get_irq_int_line(const uint32_t irq_number);
 
+/**
+ * @brief Sets the affinity of an IRQ.
+ *
+ * @details Sets the destination LAPIC of the IRQ in the IO-APIC redirection
+ * entry. The IRQ mask is not modified.
+ *
+ * @param[in] irq_number The IRQ number to set the affinity of.
+ * @param[in] lapic_id The identifier of the LAPIC receiving the IRQ.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NO_SUCH_IRQ is returned if no IO-APIC manages the IRQ.
+ * - OS_ERR_NO_SUCH_ID is returned if the LAPIC does not exist.
+ */
+OS_RETURN_E io_apic_set_irq_affinity(const uint32_t irq_number,
+                                     const uint32_t lapic_id);
+
+/**
+ * @brief Returns the affinity of an IRQ.
+ *
+ * @details Returns the destination LAPIC of the IRQ in the IO-APIC
+ * redirection entry.
+ *
+ * @param[in] irq_number The IRQ number to get the affinity of.
+ * @param[out] lapic_id The buffer receiving the LAPIC identifier.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ * - OS_ERR_NO_SUCH_IRQ is returned if no IO-APIC manages the IRQ.
+ */
+OS_RETURN_E io_apic_get_irq_affinity(const uint32_t irq_number,
+                                     uint32_t* lapic_id);
+
+/**
+ * @brief Spreads the busy IRQs across CPUs.
+ *
+ * @details Spreads the IRQs that received interrupts since the last balancing
+ * across the CPUs given as parameter. The busiest IRQ is routed first to the
+ * least loaded CPU. On equal load the first CPU of the list is selected, the
+ * CPU running latency sensitive threads should be placed last. The IRQs that
+ * received no interrupt keep their affinity. The balancer tracks the interrupt
+ * statistics generation, after a reset the load of an IRQ is the count
+ * received since the reset.
+ *
+ * @warning Only CPUs able to receive interrupts must be given to the
+ * balancer.
+ *
+ * @param[in] lapic_ids The LAPIC identifiers of the CPUs receiving the IRQs.
+ * @param[in] lapic_count The number of CPUs in the list.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the CPU list is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the CPU count is 0 or greater than the
+ * maximal CPU count.
+ * - OS_ERR_NO_SUCH_ID is returned if a LAPIC does not exist.
+ */
+OS_RETURN_E io_apic_balance_irqs(const uint32_t* lapic_ids,
+                                 const uint32_t lapic_count);
+
 /**
  * @brief Returns the IO-APIC availability.
  *
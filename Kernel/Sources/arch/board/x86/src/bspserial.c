@@ -15,6 +15,10 @@
  * output. The serial can be used to output data or communicate with other
  * prepherals that support this communication method. Only COM1 to COM4 are
  * supported by this driver.
+ * Once the serial interrupts are enabled, the output port is interrupt driven:
+ * characters are queued in a transmit ring and the transmitter empty interrupt
+ * refills the 16 bytes hardware FIFO in bursts. Received characters are moved
+ * to a receive ring by the receive interrupts.
  *
  * @copyright Alexy Torres Aurora Dugo
  *
@@ -26,13 +30,16 @@
  ******************************************************************************/
 
 /* Included headers */
-#include <stdint.h>        /* Generic int types */
-#include <string.h>        /* String manipulation */
-#include <cpu.h>           /* CPU manipulation */
-#include <graphic.h>       /* Graphic definitions */
-#include <kernel_output.h> /* Kernel output methods */
-#include <uart.h>          /* UART main header */
-#include <graphic.h>       /* Graphic driver manager */
+#include <stdint.h>             /* Generic int types */
+#include <string.h>             /* String manipulation */
+#include <cpu.h>                /* CPU manipulation */
+#include <graphic.h>            /* Graphic definitions */
+#include <kernel_output.h>      /* Kernel output methods */
+#include <uart.h>               /* UART main header */
+#include <graphic.h>            /* Graphic driver manager */
+#include <critical.h>           /* Critical sections */
+#include <interrupts.h>         /* Interrupts management */
+#include <interrupt_settings.h> /* Interrupts settings */
 
 /* Configuration files */
 #include <config.h>
@@ -115,6 +122,41 @@
 /** @brief Serial fifo depth flag: 64 bits. */
 #define SERIAL_FIFO_DEPTH_64     0x10
 
+/** @brief Serial interrupt enable flag: data received. */
+#define SERIAL_INT_RECV_DATA 0x01
+/** @brief Serial interrupt enable flag: transmitter holding register empty. */
+#define SERIAL_INT_SEND_EMPTY 0x02
+
+/** @brief Serial interrupt identification flag: no interrupt pending. */
+#define SERIAL_INT_ID_NONE         0x01
+/** @brief Serial interrupt identification mask. */
+#define SERIAL_INT_ID_MASK         0x0E
+/** @brief Serial interrupt identification: modem status. */
+#define SERIAL_INT_ID_MODEM_STATUS 0x00
+/** @brief Serial interrupt identification: transmitter holding register
+ * empty.
+ */
+#define SERIAL_INT_ID_SEND_EMPTY   0x02
+/** @brief Serial interrupt identification: data received. */
+#define SERIAL_INT_ID_RECV_DATA    0x04
+/** @brief Serial interrupt identification: line status. */
+#define SERIAL_INT_ID_LINE_STATUS  0x06
+/** @brief Serial interrupt identification: receive FIFO timeout. */
+#define SERIAL_INT_ID_RECV_TIMEOUT 0x0C
+
+/** @brief Serial line status flag: data ready. */
+#define SERIAL_LINE_DATA_READY 0x01
+/** @brief Serial line status flag: transmitter holding register empty. */
+#define SERIAL_LINE_SEND_EMPTY 0x20
+
+/** @brief Depth of the transmit hardware FIFO. */
+#define SERIAL_SEND_FIFO_DEPTH 16
+
+/** @brief Size of the transmit ring, must be a power of two. */
+#define SERIAL_SEND_RING_SIZE 0x1000
+/** @brief Size of the receive rings, must be a power of two. */
+#define SERIAL_RECV_RING_SIZE 0x100
+
 /**
  * @brief Computes the data port for the serial port which base port ID is
  * given as parameter.
@@ -157,6 +199,20 @@
  * @param[in] port The base port ID of the serial port.
  */
 #define SERIAL_LINE_STATUS_PORT(port)   (port + 5)
+/**
+ * @brief Computes the modem status port for the serial port which base port ID
+ * is given as parameter.
+ *
+ * @param[in] port The base port ID of the serial port.
+ */
+#define SERIAL_MODEM_STATUS_PORT(port)  (port + 6)
+/**
+ * @brief Computes the interrupt identification port for the serial port which
+ * base port ID is given as parameter.
+ *
+ * @param[in] port The base port ID of the serial port.
+ */
+#define SERIAL_INT_ID_PORT(port)        (port + 2)
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -201,6 +257,32 @@ typedef enum
     BAUDRATE_115200 = 1,
 } SERIAL_BAUDRATE_E;
 
+/** @brief Transmit ring of the output port. */
+typedef struct
+{
+    /** @brief The characters waiting to be sent. */
+    uint8_t buffer[SERIAL_SEND_RING_SIZE];
+
+    /** @brief Number of characters queued since boot. */
+    volatile uint32_t head;
+
+    /** @brief Number of characters sent to the FIFO since boot. */
+    volatile uint32_t tail;
+} uart_send_ring_t;
+
+/** @brief Receive ring of an input port. */
+typedef struct
+{
+    /** @brief The received characters. */
+    uint8_t buffer[SERIAL_RECV_RING_SIZE];
+
+    /** @brief Number of characters received since boot. */
+    volatile uint32_t head;
+
+    /** @brief Number of characters read since boot. */
+    volatile uint32_t tail;
+} uart_recv_ring_t;
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -235,6 +317,18 @@ static kernel_graphic_driver_t uart_text_driver =
     .console_write_keyboard = uart_console_write_keyboard
 };
 
+/** @brief Transmit ring of the output port. */
+static uart_send_ring_t send_ring;
+
+/** @brief Receive rings of COM1 and COM2. */
+static uart_recv_ring_t recv_rings[2];
+
+/** @brief Set when the output port is interrupt driven. */
+static volatile bool_t uart_irq_enabled = FALSE;
+
+/** @brief Number of received characters dropped because a ring was full. */
+static volatile uint32_t uart_recv_dropped = 0;
+
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
@@ -283,6 +377,68 @@ static void set_baudrate(SERIAL_BAUDRATE_E rate, const uint8_t com);
  */
 static void uart_write(const uint32_t port, const uint8_t data);
 
+/**
+ * @brief Returns the receive ring of a port.
+ *
+ * @param[in] port The port to get the receive ring of.
+ *
+ * @return The receive ring of the port, NULL if the port is not initialized
+ * for input.
+ */
+static inline uart_recv_ring_t* uart_get_recv_ring(const uint32_t port);
+
+/**
+ * @brief Moves the characters received by a port to its receive ring.
+ *
+ * @details Reads the receive FIFO of the port until it is empty. Interrupts
+ * must be disabled.
+ *
+ * @param[in] port The port to read.
+ * @param[in, out] ring The receive ring of the port.
+ */
+static void uart_receive(const uint32_t port, uart_recv_ring_t* ring);
+
+/**
+ * @brief Refills the transmit FIFO of the output port.
+ *
+ * @details Moves up to a FIFO depth of characters from the transmit ring to the
+ * FIFO if the transmitter is empty, then enables the transmitter empty
+ * interrupt while characters are left in the ring. Interrupts must be
+ * disabled.
+ */
+static void uart_send(void);
+
+/**
+ * @brief Queues a character in the transmit ring.
+ *
+ * @details Queues a character in the transmit ring, waiting for the FIFO to
+ * make room if the ring is full. Interrupts must be disabled.
+ *
+ * @param[in] data The character to queue.
+ */
+static void uart_queue(const uint8_t data);
+
+/**
+ * @brief Serial interrupt handler.
+ *
+ * @details Services the pending interrupts of the ports attached to the IRQ
+ * line.
+ *
+ * @param[in, out] cpu_state The cpu registers structure.
+ * @param[in] int_id The interrupt number.
+ * @param[in, out] stack_state The stack state before the interrupt.
+ */
+static void uart_interrupt_handler(cpu_state_t* cpu_state,
+                                   uintptr_t int_id,
+                                   stack_state_t* stack_state);
+
+/**
+ * @brief Services the pending interrupts of a port.
+ *
+ * @param[in] port The port to service.
+ */
+static void uart_service_port(const uint32_t port);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -316,9 +472,167 @@ static void set_baudrate(SERIAL_BAUDRATE_E rate, const uint8_t com)
                  com, rate);
 }
 
+static inline uart_recv_ring_t* uart_get_recv_ring(const uint32_t port)
+{
+    if(port == COM1)
+    {
+        return &recv_rings[0];
+    }
+    else if(port == COM2)
+    {
+        return &recv_rings[1];
+    }
+
+    return NULL;
+}
+
+static void uart_receive(const uint32_t port, uart_recv_ring_t* ring)
+{
+    uint8_t data;
+
+    while((cpu_inb(SERIAL_LINE_STATUS_PORT(port)) &
+           SERIAL_LINE_DATA_READY) != 0)
+    {
+        data = cpu_inb(SERIAL_DATA_PORT(port));
+        if(ring->head - ring->tail < SERIAL_RECV_RING_SIZE)
+        {
+            ring->buffer[ring->head & (SERIAL_RECV_RING_SIZE - 1)] = data;
+            ++ring->head;
+        }
+        else
+        {
+            ++uart_recv_dropped;
+        }
+    }
+}
+
+static void uart_send(void)
+{
+    uint32_t i;
+
+    if((cpu_inb(SERIAL_LINE_STATUS_PORT(SERIAL_OUTPUT_PORT)) &
+        SERIAL_LINE_SEND_EMPTY) != 0)
+    {
+        for(i = 0;
+            i < SERIAL_SEND_FIFO_DEPTH && send_ring.tail != send_ring.head;
+            ++i)
+        {
+            cpu_outb(send_ring.buffer[send_ring.tail &
+                                      (SERIAL_SEND_RING_SIZE - 1)],
+                     SERIAL_OUTPUT_PORT);
+            ++send_ring.tail;
+        }
+    }
+
+    /* Only wait for the transmitter while there is something to send */
+    if(send_ring.tail != send_ring.head)
+    {
+        cpu_outb(SERIAL_INT_RECV_DATA | SERIAL_INT_SEND_EMPTY,
+                 SERIAL_DATA_PORT_2(SERIAL_OUTPUT_PORT));
+    }
+    else
+    {
+        cpu_outb(SERIAL_INT_RECV_DATA, SERIAL_DATA_PORT_2(SERIAL_OUTPUT_PORT));
+    }
+}
+
+static void uart_queue(const uint8_t data)
+{
+    /* The interrupt cannot be serviced here, feed the FIFO ourselves */
+    while(send_ring.head - send_ring.tail == SERIAL_SEND_RING_SIZE)
+    {
+        uart_send();
+    }
+
+    send_ring.buffer[send_ring.head & (SERIAL_SEND_RING_SIZE - 1)] = data;
+    ++send_ring.head;
+}
+
+static void uart_service_port(const uint32_t port)
+{
+    uart_recv_ring_t* ring;
+    uint8_t           int_id;
+
+    ring = uart_get_recv_ring(port);
+
+    while(((int_id = cpu_inb(SERIAL_INT_ID_PORT(port))) &
+           SERIAL_INT_ID_NONE) == 0)
+    {
+        switch(int_id & SERIAL_INT_ID_MASK)
+        {
+            case SERIAL_INT_ID_SEND_EMPTY:
+                if(port == SERIAL_OUTPUT_PORT)
+                {
+                    uart_send();
+                }
+                else
+                {
+                    cpu_outb(SERIAL_INT_RECV_DATA, SERIAL_DATA_PORT_2(port));
+                }
+                break;
+            case SERIAL_INT_ID_RECV_DATA:
+            case SERIAL_INT_ID_RECV_TIMEOUT:
+                if(ring != NULL)
+                {
+                    uart_receive(port, ring);
+                }
+                else
+                {
+                    cpu_inb(SERIAL_DATA_PORT(port));
+                }
+                break;
+            case SERIAL_INT_ID_LINE_STATUS:
+                cpu_inb(SERIAL_LINE_STATUS_PORT(port));
+                break;
+            default:
+                cpu_inb(SERIAL_MODEM_STATUS_PORT(port));
+                break;
+        }
+    }
+}
+
+static void uart_interrupt_handler(cpu_state_t* cpu_state,
+                                   uintptr_t int_id,
+                                   stack_state_t* stack_state)
+{
+    uint32_t irq_number;
+
+    (void)cpu_state;
+    (void)stack_state;
+
+    /* COM1 and COM2 are the only ports with interrupts enabled */
+    if(int_id == (uintptr_t)kernel_interrupt_get_irq_int_line(
+                                SERIAL_1_3_IRQ_LINE))
+    {
+        irq_number = SERIAL_1_3_IRQ_LINE;
+        uart_service_port(COM1);
+    }
+    else
+    {
+        irq_number = SERIAL_2_4_IRQ_LINE;
+        uart_service_port(COM2);
+    }
+
+    kernel_interrupt_set_irq_eoi(irq_number);
+}
+
 static void uart_write(const uint32_t port, const uint8_t data)
 {
     uint32_t int_state;
+
+    if(uart_irq_enabled == TRUE && port == SERIAL_OUTPUT_PORT)
+    {
+        ENTER_CRITICAL(int_state);
+        if(data == '\n')
+        {
+            uart_queue('\r');
+        }
+        uart_queue(data);
+        uart_send();
+        EXIT_CRITICAL(int_state);
+        return;
+    }
+
     /* Wait for empty transmit */
     ENTER_CRITICAL(int_state);
     while((cpu_inb(SERIAL_LINE_STATUS_PORT(port)) & 0x20) == 0){}
@@ -427,28 +741,113 @@ void uart_console_write_keyboard(const char* string, const size_t len)
     }
 }
 
-uint8_t uart_read(const uint32_t port)
+OS_RETURN_E uart_enable_interrupts(void)
+{
+    OS_RETURN_E err;
+    uint32_t    int_state;
+
+    if(uart_irq_enabled == TRUE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    err = kernel_interrupt_register_irq_handler(SERIAL_1_3_IRQ_LINE,
+                                                uart_interrupt_handler);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    err = kernel_interrupt_register_irq_handler(SERIAL_2_4_IRQ_LINE,
+                                                uart_interrupt_handler);
+    if(err != OS_NO_ERR)
+    {
+        kernel_interrupt_remove_irq_handler(SERIAL_1_3_IRQ_LINE);
+        return err;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    /* Discard the stale interrupts before unmasking the lines */
+    uart_service_port(COM1);
+    uart_service_port(COM2);
+
+    kernel_interrupt_set_irq_mask(SERIAL_1_3_IRQ_LINE, 1);
+    kernel_interrupt_set_irq_mask(SERIAL_2_4_IRQ_LINE, 1);
+
+    uart_irq_enabled = TRUE;
+
+    EXIT_CRITICAL(int_state);
+
+    KERNEL_DEBUG(SERIAL_DEBUG_ENABLED, "SERIAL", "Serial interrupts enabled");
+
+    return OS_NO_ERR;
+}
+
+void uart_sync(void)
 {
     uint32_t int_state;
 
-    /* Wait for data to be received */
     ENTER_CRITICAL(int_state);
-    while(uart_received(port) == 0){}
 
+    uart_irq_enabled = FALSE;
+    while(send_ring.tail != send_ring.head)
+    {
+        uart_send();
+    }
+    cpu_outb(SERIAL_INT_RECV_DATA, SERIAL_DATA_PORT_2(SERIAL_OUTPUT_PORT));
 
-    /* Read available data on port */
-    uint8_t val = cpu_inb(SERIAL_DATA_PORT(port));
     EXIT_CRITICAL(int_state);
+}
 
-    return val;
+uint32_t uart_get_recv_dropped(void)
+{
+    return uart_recv_dropped;
+}
+
+uint8_t uart_read(const uint32_t port)
+{
+    uart_recv_ring_t* ring;
+    uint32_t          int_state;
+    uint8_t           val;
+
+    ring = uart_get_recv_ring(port);
+    if(ring == NULL)
+    {
+        /* Wait for data to be received */
+        ENTER_CRITICAL(int_state);
+        while((cpu_inb(SERIAL_LINE_STATUS_PORT(port)) &
+               SERIAL_LINE_DATA_READY) == 0){}
+
+        /* Read available data on port */
+        val = cpu_inb(SERIAL_DATA_PORT(port));
+        EXIT_CRITICAL(int_state);
+
+        return val;
+    }
+
+    /* Let the receive interrupt fill the ring between two checks */
+    while(TRUE)
+    {
+        ENTER_CRITICAL(int_state);
+        uart_receive(port, ring);
+        if(ring->tail != ring->head)
+        {
+            val = ring->buffer[ring->tail & (SERIAL_RECV_RING_SIZE - 1)];
+            ++ring->tail;
+            EXIT_CRITICAL(int_state);
+
+            return val;
+        }
+        EXIT_CRITICAL(int_state);
+    }
 }
 
 void uart_put_string(const char* string)
 {
-    size_t i;
-    for(i = 0; i < strlen(string); ++i)
+    while(*string != 0)
     {
-        uart_write(SERIAL_OUTPUT_PORT, string[i]);
+        uart_write(SERIAL_OUTPUT_PORT, *string);
+        ++string;
     }
 }
 
@@ -459,12 +858,16 @@ void uart_put_char(const char character)
 
 bool_t uart_received(const uint32_t port)
 {
-    bool_t   ret;
-    uint32_t int_state;
+    uart_recv_ring_t* ring;
+    bool_t            ret;
+    uint32_t          int_state;
+
+    ring = uart_get_recv_ring(port);
 
     /* Read on LINE status port */
     ENTER_CRITICAL(int_state);
-    ret = cpu_inb(SERIAL_LINE_STATUS_PORT(port)) & 0x01;
+    ret = (ring != NULL && ring->tail != ring->head) ||
+          (cpu_inb(SERIAL_LINE_STATUS_PORT(port)) & SERIAL_LINE_DATA_READY);
     EXIT_CRITICAL(int_state);
 
     return ret;
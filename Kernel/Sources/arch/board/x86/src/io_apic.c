@@ -38,6 +38,7 @@
 #include <kheap.h>              /* Kernel heap */
 #include <panic.h>              /* Kernel panic */
 #include <kernel_error.h>       /* Kernel error codes */
+#include <string.h>             /* Memory manipulation */
 
 /* Configuration files */
 #include <config.h>
@@ -64,6 +65,11 @@
 /** @brief IO-APIC redirection register. */
 #define IOREDTBL  0x10
 
+/** @brief IO-APIC redirection entry destination shift (high register). */
+#define IOREDTBL_DEST_SHIFT 24
+/** @brief IO-APIC redirection entry destination mask (high register). */
+#define IOREDTBL_DEST_MASK  0xFF000000
+
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
@@ -123,6 +129,15 @@ static io_apic_data_t*  io_apics;
 /** @brief Stores the number of IO APICS */
 static uint32_t io_apic_count;
 
+/** @brief Stores the number of IRQs handled by the IO APICS. */
+static uint32_t io_apic_irq_count;
+
+/** @brief Stores the IRQs interrupt count at the last balancing. */
+static uint64_t* io_apic_irq_last_count;
+
+/** @brief Stores the interrupt statistics generation of the snapshots. */
+static uint32_t io_apic_irq_last_generation;
+
 /** @brief IO_PIC driver instance. */
 static interrupt_driver_t io_apic_driver = {
     .driver_set_irq_mask     = io_apic_set_irq_mask,
@@ -161,6 +176,16 @@ inline static void io_apic_write(const uintptr_t base_addr,
 inline static uint32_t io_apic_read(const uintptr_t base_addr,
                                         const uint32_t reg);
 
+/**
+ * @brief Returns the base address of the IO-APIC managing an IRQ.
+ *
+ * @param[in] irq_number The IRQ number to get the IO-APIC of.
+ *
+ * @return The base address of the IO-APIC managing the IRQ, 0 if no IO-APIC
+ * manages the IRQ.
+ */
+static uintptr_t io_apic_get_base(const uint32_t irq_number);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -180,6 +205,25 @@ inline static uint32_t io_apic_read(const uintptr_t base_addr,
     return mapped_io_read_32((uint32_t*)(base_addr + IOWIN));
 }
 
+static uintptr_t io_apic_get_base(const uint32_t irq_number)
+{
+    uint32_t i;
+
+    for(i = 0; i < io_apic_count; ++i)
+    {
+        if(io_apics[i].gsib <= irq_number &&
+           io_apics[i].gsib + io_apics[i].max_redirect_count > irq_number)
+        {
+            KERNEL_DEBUG(IOAPIC_DEBUG_ENABLED, "IO-APIC",
+                         "IRQ %d on IO APIC %d",
+                         irq_number, io_apics[i].id);
+            return io_apics[i].base_addr;
+        }
+    }
+
+    return 0;
+}
+
 void io_apic_init(void)
 {
     uint32_t            i;
@@ -189,7 +233,8 @@ void io_apic_init(void)
     io_apic_t*          cursor_apic;
     OS_RETURN_E         err;
 
-    io_apics = NULL;
+    io_apics          = NULL;
+    io_apic_irq_count = 0;
 
     /* Check IO-APIC support */
     io_apic_count = acpi_get_io_apic_count();
@@ -235,6 +280,19 @@ void io_apic_init(void)
         read_count = io_apic_read(io_apics[i].base_addr, IOAPICVER);
         io_apics[i].max_redirect_count = ((read_count >> 16) & 0xff) + 1;
 
+        if(io_apics[i].gsib + io_apics[i].max_redirect_count >
+           io_apic_irq_count)
+        {
+            io_apic_irq_count = io_apics[i].gsib +
+                                io_apics[i].max_redirect_count;
+        }
+
+        /* Route all interrupts to the first CPU */
+        for (j = 0; j < io_apics[i].max_redirect_count; ++j)
+        {
+            io_apic_write(io_apics[i].base_addr, IOREDTBL + j * 2 + 1, 0);
+        }
+
         /* Redirect and disable all interrupts */
         for (j = 0; j < io_apics[i].max_redirect_count; ++j)
         {
@@ -242,8 +300,16 @@ void io_apic_init(void)
         }
     }
 
+    io_apic_irq_last_count = kmalloc(sizeof(uint64_t) * io_apic_irq_count);
+    IOAPIC_ASSERT(io_apic_irq_last_count != NULL,
+                  "Could not allocate memory for IO-APIC",
+                  OS_ERR_MALLOC);
+    memset(io_apic_irq_last_count, 0, sizeof(uint64_t) * io_apic_irq_count);
+    io_apic_irq_last_generation = kernel_interrupt_get_stats_generation();
+
     KERNEL_TEST_POINT(io_apic_test);
     KERNEL_TEST_POINT(io_apic_test2);
+    KERNEL_TEST_POINT(io_apic_test3);
 }
 
 void io_apic_set_irq_mask(const uint32_t irq_number, const bool_t enabled)
@@ -252,22 +318,10 @@ void io_apic_set_irq_mask(const uint32_t irq_number, const bool_t enabled)
     uint32_t  entry_hi;
     uint32_t  actual_irq;
     uint32_t  int_state;
-    uint32_t  i;
     uintptr_t base_addr;
 
     /* Find the IO APIC that manage this IRQ */
-    base_addr = 0;
-    for(i = 0; i < io_apic_count; ++i)
-    {
-        if(io_apics[i].gsib <= irq_number &&
-           io_apics[i].gsib + io_apics[i].max_redirect_count > irq_number)
-        {
-            base_addr = io_apics[i].base_addr;
-            KERNEL_DEBUG(IOAPIC_DEBUG_ENABLED, "IO-APIC",
-                 "Mask IRQ on IO APIC %d",
-                 io_apics[i].id);
-        }
-    }
+    base_addr = io_apic_get_base(irq_number);
 
     IOAPIC_ASSERT(base_addr != 0,
                   "Could not find IO-APIC IRQ",
@@ -276,13 +330,16 @@ void io_apic_set_irq_mask(const uint32_t irq_number, const bool_t enabled)
     /* Set the interrupt line */
     entry_lo = irq_number + INT_IOAPIC_IRQ_OFFSET;
     entry_lo |= (~(uint32_t)enabled & 0x1) << 16;
-    entry_hi = 0;
 
     ENTER_CRITICAL(int_state);
 
     /* Get the remapped value */
     actual_irq = acpi_get_remaped_irq(irq_number);
 
+    /* Keep the IRQ affinity */
+    entry_hi = io_apic_read(base_addr, IOREDTBL + actual_irq * 2 + 1) &
+               IOREDTBL_DEST_MASK;
+
     io_apic_write(base_addr, IOREDTBL + actual_irq * 2, entry_lo);
     io_apic_write(base_addr, IOREDTBL + actual_irq * 2 + 1, entry_hi);
 
@@ -348,6 +405,180 @@ int32_t io_apic_get_irq_int_line(const uint32_t irq_number)
     return -1;
 }
 
+OS_RETURN_E io_apic_set_irq_affinity(const uint32_t irq_number,
+                                     const uint32_t lapic_id)
+{
+    uint32_t    entry_hi;
+    uint32_t    actual_irq;
+    uint32_t    int_state;
+    uintptr_t   base_addr;
+    OS_RETURN_E err;
+
+    base_addr = io_apic_get_base(irq_number);
+    if(base_addr == 0)
+    {
+        return OS_ERR_NO_SUCH_IRQ;
+    }
+
+    err = acpi_check_lapic_id(lapic_id);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    entry_hi = lapic_id << IOREDTBL_DEST_SHIFT;
+
+    ENTER_CRITICAL(int_state);
+
+    actual_irq = acpi_get_remaped_irq(irq_number);
+    io_apic_write(base_addr, IOREDTBL + actual_irq * 2 + 1, entry_hi);
+
+    EXIT_CRITICAL(int_state);
+
+    KERNEL_DEBUG(IOAPIC_DEBUG_ENABLED, "IO-APIC",
+                 "IRQ %d (%d) routed to LAPIC %d",
+                 irq_number, actual_irq, lapic_id);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E io_apic_get_irq_affinity(const uint32_t irq_number,
+                                     uint32_t* lapic_id)
+{
+    uint32_t  actual_irq;
+    uint32_t  int_state;
+    uintptr_t base_addr;
+
+    if(lapic_id == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    base_addr = io_apic_get_base(irq_number);
+    if(base_addr == 0)
+    {
+        return OS_ERR_NO_SUCH_IRQ;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    actual_irq = acpi_get_remaped_irq(irq_number);
+    *lapic_id  = io_apic_read(base_addr, IOREDTBL + actual_irq * 2 + 1) >>
+                 IOREDTBL_DEST_SHIFT;
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E io_apic_balance_irqs(const uint32_t* lapic_ids,
+                                 const uint32_t lapic_count)
+{
+    uint64_t    irq_load[IOAPIC_BALANCE_MAX_IRQ];
+    uint64_t    cpu_load[MAX_CPU_COUNT];
+    uint64_t    count;
+    uint64_t    cycles;
+    uint32_t    irq_count;
+    uint32_t    busiest;
+    uint32_t    target;
+    uint32_t    i;
+    uint32_t    int_state;
+    OS_RETURN_E err;
+
+    if(lapic_ids == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(lapic_count == 0 || lapic_count > MAX_CPU_COUNT)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    for(i = 0; i < lapic_count; ++i)
+    {
+        err = acpi_check_lapic_id(lapic_ids[i]);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+        cpu_load[i] = 0;
+    }
+
+    irq_count = io_apic_irq_count;
+    if(irq_count > IOAPIC_BALANCE_MAX_IRQ)
+    {
+        irq_count = IOAPIC_BALANCE_MAX_IRQ;
+    }
+
+    /* Keep the statistics from being reset while taking the snapshots */
+    ENTER_CRITICAL(int_state);
+
+    /* The statistics were reset since the last balancing, the snapshots are
+     * taken back from zero
+     */
+    if(kernel_interrupt_get_stats_generation() != io_apic_irq_last_generation)
+    {
+        memset(io_apic_irq_last_count, 0,
+               sizeof(uint64_t) * io_apic_irq_count);
+        io_apic_irq_last_generation = kernel_interrupt_get_stats_generation();
+    }
+
+    /* Get the number of interrupts received since the last balancing */
+    for(i = 0; i < irq_count; ++i)
+    {
+        irq_load[i] = 0;
+        if(kernel_interrupt_get_dispatch_cost(i + INT_IOAPIC_IRQ_OFFSET,
+                                              &count,
+                                              &cycles) == OS_NO_ERR)
+        {
+            irq_load[i] = count - io_apic_irq_last_count[i];
+            io_apic_irq_last_count[i] = count;
+        }
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    /* Greedy placement, busiest IRQ first on the least loaded CPU. On equal
+     * load the first CPU of the list is selected.
+     */
+    while(TRUE)
+    {
+        busiest = irq_count;
+        for(i = 0; i < irq_count; ++i)
+        {
+            if(irq_load[i] != 0 &&
+               (busiest == irq_count || irq_load[i] > irq_load[busiest]))
+            {
+                busiest = i;
+            }
+        }
+        if(busiest == irq_count)
+        {
+            break;
+        }
+
+        target = 0;
+        for(i = 1; i < lapic_count; ++i)
+        {
+            if(cpu_load[i] < cpu_load[target])
+            {
+                target = i;
+            }
+        }
+
+        err = io_apic_set_irq_affinity(busiest, lapic_ids[target]);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+
+        cpu_load[target] += irq_load[busiest];
+        irq_load[busiest] = 0;
+    }
+
+    return OS_NO_ERR;
+}
+
 bool_t io_apic_capable(void)
 {
     return (acpi_get_io_apic_count() != 0 && acpi_get_lapic_count() != 0);
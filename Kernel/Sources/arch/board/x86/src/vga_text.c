@@ -13,7 +13,10 @@
  *
  * @details Allows the kernel to display text and general ASCII characters to be
  * displayed on the screen. Includes cursor management, screen colors management
- * and other fancy screen driver things.
+ * and other fancy screen driver things. The characters are written in a shadow
+ * buffer in RAM whose lines are used as a ring, scrolling only moves the ring
+ * offset. The modified lines and the hardware cursor are copied to the frame
+ * buffer once per driver call.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -63,6 +66,9 @@
 /** @brief VGA cursor position command high. */
 #define VGA_TEXT_CURSOR_COMM_HIGH 0x0E
 
+/** @brief Dirty lines mask with all the screen lines set. */
+#define VGA_TEXT_ALL_LINES_DIRTY ((1U << VGA_TEXT_SCREEN_LINE_SIZE) - 1)
+
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
@@ -126,6 +132,19 @@ static uint8_t last_columns[VGA_TEXT_SCREEN_LINE_SIZE] = {0};
 /** @brief VGA frame buffer address. */
 static uint16_t* vga_framebuffer = (uint16_t*)VGA_TEXT_FRAMEBUFFER;
 
+/** @brief Shadow of the frame buffer, the lines are used as a ring. */
+static uint16_t shadow_buffer[VGA_TEXT_SCREEN_LINE_SIZE]
+                             [VGA_TEXT_SCREEN_COL_SIZE];
+
+/** @brief Shadow buffer line displayed on the first screen line. */
+static uint32_t shadow_top = 0;
+
+/** @brief Screen lines modified since the last flush, one bit per line. */
+static uint32_t dirty_lines = 0;
+
+/** @brief Cursor position last sent to the hardware, -1 if unknown. */
+static int32_t hw_cursor_position = -1;
+
 /**
  * @brief VGA text driver instance.
  */
@@ -175,6 +194,42 @@ inline static void vga_print_char(const uint32_t line,
 inline static uint16_t* vga_get_framebuffer(const uint32_t line,
                                             const uint32_t column);
 
+/**
+ * @brief Returns the shadow buffer address of a screen position.
+ *
+ * @param[in] line The screen line.
+ * @param[in] column The screen column.
+ *
+ * @return The shadow buffer address of the screen position.
+ */
+inline static uint16_t* vga_get_shadow(const uint32_t line,
+                                       const uint32_t column);
+
+/**
+ * @brief Sets the cursor position without updating the hardware cursor.
+ *
+ * @param[in] line The line index where to place the cursor.
+ * @param[in] column The column index where to place the cursor.
+ */
+static void vga_set_cursor(const uint32_t line, const uint32_t column);
+
+/**
+ * @brief Scrolls the shadow buffer without updating the frame buffer.
+ *
+ * @param[in] direction The direction to which the console should be scrolled.
+ * @param[in] lines_count The number of lines to scroll.
+ */
+static void vga_scroll_lines(const SCROLL_DIRECTION_E direction,
+                             const uint32_t lines_count);
+
+/**
+ * @brief Copies the dirty lines and the cursor to the hardware.
+ *
+ * @details Copies each dirty line of the shadow buffer to the frame buffer in
+ * one copy and updates the hardware cursor if it moved.
+ */
+static void vga_flush(void);
+
 /**
  * @brief Processes the character in parameters.
  *
@@ -203,12 +258,14 @@ inline static void vga_print_char(const uint32_t line,
     }
 
     /* Get address to inject */
-    screen_mem = vga_get_framebuffer(line, column);
+    screen_mem = vga_get_shadow(line, column);
 
     /* Inject the character with the current colorscheme */
     *screen_mem = character |
                   ((screen_scheme.background << 8) & 0xF000) |
                   ((screen_scheme.foreground << 8) & 0x0F00);
+
+    dirty_lines |= 1U << line;
 }
 
 static void vga_process_char(const char character)
@@ -224,20 +281,27 @@ static void vga_process_char(const char character)
          /* Manage end of line cursor position */
         if(screen_cursor.x > VGA_TEXT_SCREEN_COL_SIZE - 1)
         {
-            vga_put_cursor_at(screen_cursor.y + 1, 0);
-            last_columns[screen_cursor.y] = screen_cursor.x;
+            if(screen_cursor.y < VGA_TEXT_SCREEN_LINE_SIZE - 1)
+            {
+                vga_set_cursor(screen_cursor.y + 1, 0);
+                last_columns[screen_cursor.y] = screen_cursor.x;
+            }
+            else
+            {
+                vga_scroll_lines(SCROLL_DOWN, 1);
+            }
         }
 
         /* Manage end of screen cursor position */
         if(screen_cursor.y >= VGA_TEXT_SCREEN_LINE_SIZE)
         {
-            vga_scroll(SCROLL_DOWN, 1);
+            vga_scroll_lines(SCROLL_DOWN, 1);
 
         }
         else
         {
             /* Move cursor */
-            vga_put_cursor_at(screen_cursor.y, screen_cursor.x);
+            vga_set_cursor(screen_cursor.y, screen_cursor.x);
             last_columns[screen_cursor.y] = screen_cursor.x;
         }
 
@@ -256,7 +320,7 @@ static void vga_process_char(const char character)
                 {
                     if(screen_cursor.x > last_printed_cursor.x)
                     {
-                        vga_put_cursor_at(screen_cursor.y, screen_cursor.x - 1);
+                        vga_set_cursor(screen_cursor.y, screen_cursor.x - 1);
                         last_columns[screen_cursor.y] = screen_cursor.x;
                         vga_print_char(screen_cursor.y, screen_cursor.x, ' ');
                     }
@@ -265,7 +329,7 @@ static void vga_process_char(const char character)
                 {
                     if(screen_cursor.x > 0)
                     {
-                        vga_put_cursor_at(screen_cursor.y, screen_cursor.x - 1);
+                        vga_set_cursor(screen_cursor.y, screen_cursor.x - 1);
                         last_columns[screen_cursor.y] = screen_cursor.x;
                         vga_print_char(screen_cursor.y, screen_cursor.x, ' ');
                     }
@@ -278,8 +342,8 @@ static void vga_process_char(const char character)
                                VGA_TEXT_SCREEN_COL_SIZE - 1;
                         }
 
-                        vga_put_cursor_at(screen_cursor.y - 1,
-                                      last_columns[screen_cursor.y - 1]);
+                        vga_set_cursor(screen_cursor.y - 1,
+                                       last_columns[screen_cursor.y - 1]);
                         vga_print_char(screen_cursor.y, screen_cursor.x, ' ');
                     }
                 }
@@ -288,13 +352,13 @@ static void vga_process_char(const char character)
             case '\t':
                 if(screen_cursor.x + 8 < VGA_TEXT_SCREEN_COL_SIZE - 1)
                 {
-                    vga_put_cursor_at(screen_cursor.y,
+                    vga_set_cursor(screen_cursor.y,
                             screen_cursor.x  +
                             (8 - screen_cursor.x % 8));
                 }
                 else
                 {
-                    vga_put_cursor_at(screen_cursor.y,
+                    vga_set_cursor(screen_cursor.y,
                            VGA_TEXT_SCREEN_COL_SIZE - 1);
                 }
                 last_columns[screen_cursor.y] = screen_cursor.x;
@@ -303,12 +367,12 @@ static void vga_process_char(const char character)
             case '\n':
                 if(screen_cursor.y < VGA_TEXT_SCREEN_LINE_SIZE - 1)
                 {
-                    vga_put_cursor_at(screen_cursor.y + 1, 0);
+                    vga_set_cursor(screen_cursor.y + 1, 0);
                     last_columns[screen_cursor.y] = screen_cursor.x;
                 }
                 else
                 {
-                    vga_scroll(SCROLL_DOWN, 1);
+                    vga_scroll_lines(SCROLL_DOWN, 1);
                 }
                 break;
             /* Clear screen */
@@ -317,7 +381,7 @@ static void vga_process_char(const char character)
                 break;
             /* Line return */
             case '\r':
-                vga_put_cursor_at(screen_cursor.y, 0);
+                vga_set_cursor(screen_cursor.y, 0);
                 last_columns[screen_cursor.y] = screen_cursor.x;
                 break;
             /* Undefined */
@@ -342,9 +406,138 @@ static inline uint16_t* vga_get_framebuffer(const uint32_t line,
            (column + line * VGA_TEXT_SCREEN_COL_SIZE);
 }
 
+inline static uint16_t* vga_get_shadow(const uint32_t line,
+                                       const uint32_t column)
+{
+    uint32_t shadow_line;
+
+    /* Both values are below the screen size, avoid the modulo */
+    shadow_line = shadow_top + line;
+    if(shadow_line >= VGA_TEXT_SCREEN_LINE_SIZE)
+    {
+        shadow_line -= VGA_TEXT_SCREEN_LINE_SIZE;
+    }
+
+    return &shadow_buffer[shadow_line][column];
+}
+
+static void vga_set_cursor(const uint32_t line, const uint32_t column)
+{
+    /* Checks the values of line and column */
+    if(column > VGA_TEXT_SCREEN_COL_SIZE ||
+       line > VGA_TEXT_SCREEN_LINE_SIZE)
+    {
+        return;
+    }
+
+    /* Set new cursor position, the hardware is updated on flush */
+    screen_cursor.x = column;
+    screen_cursor.y = line;
+}
+
+static void vga_scroll_lines(const SCROLL_DIRECTION_E direction,
+                             const uint32_t lines_count)
+{
+    uint32_t to_scroll;
+    uint32_t i;
+    uint32_t j;
+    uint16_t blank;
+
+    if(VGA_TEXT_SCREEN_LINE_SIZE < lines_count)
+    {
+        to_scroll = VGA_TEXT_SCREEN_LINE_SIZE;
+    }
+    else
+    {
+        to_scroll = lines_count;
+    }
+
+    /* Select scroll direction */
+    if(direction == SCROLL_DOWN && to_scroll != 0)
+    {
+        /* Move the ring, the top lines become the new bottom lines */
+        shadow_top += to_scroll;
+        if(shadow_top >= VGA_TEXT_SCREEN_LINE_SIZE)
+        {
+            shadow_top -= VGA_TEXT_SCREEN_LINE_SIZE;
+        }
+
+        /* Clear the new lines */
+        blank = ' ' |
+                ((screen_scheme.background << 8) & 0xF000) |
+                ((screen_scheme.foreground << 8) & 0x0F00);
+        for(i = VGA_TEXT_SCREEN_LINE_SIZE - to_scroll;
+            i < VGA_TEXT_SCREEN_LINE_SIZE;
+            ++i)
+        {
+            for(j = 0; j < VGA_TEXT_SCREEN_COL_SIZE; ++j)
+            {
+                *vga_get_shadow(i, j) = blank;
+            }
+        }
+
+        memmove(last_columns, last_columns + to_scroll,
+                VGA_TEXT_SCREEN_LINE_SIZE - to_scroll);
+        memset(last_columns + VGA_TEXT_SCREEN_LINE_SIZE - to_scroll, 0,
+               to_scroll);
+
+        /* Every screen line now displays another shadow line */
+        dirty_lines = VGA_TEXT_ALL_LINES_DIRTY;
+    }
+
+    /* Replace cursor */
+    vga_set_cursor(VGA_TEXT_SCREEN_LINE_SIZE - to_scroll, 0);
+
+    if(to_scroll <= last_printed_cursor.y)
+    {
+        last_printed_cursor.y -= to_scroll;
+    }
+    else
+    {
+        last_printed_cursor.x = 0;
+        last_printed_cursor.y = 0;
+    }
+}
+
+static void vga_flush(void)
+{
+    int32_t  cursor_position;
+    uint32_t i;
+
+    /* Copy the dirty lines, one copy per line */
+    for(i = 0; dirty_lines != 0; ++i)
+    {
+        if((dirty_lines & (1U << i)) != 0)
+        {
+            memcpy(vga_get_framebuffer(i, 0), vga_get_shadow(i, 0),
+                   sizeof(uint16_t) * VGA_TEXT_SCREEN_COL_SIZE);
+            dirty_lines &= ~(1U << i);
+        }
+    }
+
+    /* Only update the hardware cursor if it moved */
+    cursor_position = screen_cursor.x +
+                      screen_cursor.y * VGA_TEXT_SCREEN_COL_SIZE;
+    if(cursor_position == hw_cursor_position)
+    {
+        return;
+    }
+    hw_cursor_position = cursor_position;
+
+    /* Send low part to the screen */
+    cpu_outb(VGA_TEXT_CURSOR_COMM_LOW, VGA_TEXT_SCREEN_COMM_PORT);
+    cpu_outb((int8_t)(cursor_position & 0x00FF), VGA_TEXT_SCREEN_DATA_PORT);
+
+    /* Send high part to the screen */
+    cpu_outb(VGA_TEXT_CURSOR_COMM_HIGH, VGA_TEXT_SCREEN_COMM_PORT);
+    cpu_outb((int8_t)((cursor_position & 0xFF00) >> 8),
+             VGA_TEXT_SCREEN_DATA_PORT);
+}
+
 void vga_init(void)
 {
     OS_RETURN_E err;
+    uint32_t    i;
 
     KERNEL_DEBUG(VGA_DEBUG_ENABLED, "VGA", "Initializing VGA text driver");
 
@@ -365,6 +558,15 @@ void vga_init(void)
                        0,
                        1,
                        NULL);
+
+    /* Keep what is already displayed in the shadow buffer */
+    for(i = 0; i < VGA_TEXT_SCREEN_LINE_SIZE; ++i)
+    {
+        memcpy(vga_get_shadow(i, 0), vga_get_framebuffer(i, 0),
+               sizeof(uint16_t) * VGA_TEXT_SCREEN_COL_SIZE);
+    }
+    dirty_lines        = 0;
+    hw_cursor_position = -1;
 }
 
 void vga_clear_screen(void)
@@ -380,38 +582,19 @@ void vga_clear_screen(void)
     {
         for(j = 0; j < VGA_TEXT_SCREEN_COL_SIZE; ++j)
         {
-            *(vga_get_framebuffer(i, j)) = blank;
+            shadow_buffer[i][j] = blank;
         }
         last_columns[i] = 0;
     }
+    dirty_lines = VGA_TEXT_ALL_LINES_DIRTY;
+
+    vga_flush();
 }
 
 void vga_put_cursor_at(const uint32_t line, const uint32_t column)
 {
-    int16_t  cursor_position;
-
-    /* Checks the values of line and column */
-    if(column > VGA_TEXT_SCREEN_COL_SIZE ||
-       line > VGA_TEXT_SCREEN_LINE_SIZE)
-    {
-        return;
-    }
-
-    /* Set new cursor position */
-    screen_cursor.x = column;
-    screen_cursor.y = line;
-
-    /* Display new position on screen */
-    cursor_position = column + line * VGA_TEXT_SCREEN_COL_SIZE;
-
-    /* Send low part to the screen */
-    cpu_outb(VGA_TEXT_CURSOR_COMM_LOW, VGA_TEXT_SCREEN_COMM_PORT);
-    cpu_outb((int8_t)(cursor_position & 0x00FF), VGA_TEXT_SCREEN_DATA_PORT);
-
-    /* Send high part to the screen */
-    cpu_outb(VGA_TEXT_CURSOR_COMM_HIGH, VGA_TEXT_SCREEN_COMM_PORT);
-    cpu_outb((int8_t)((cursor_position & 0xFF00) >> 8),
-             VGA_TEXT_SCREEN_DATA_PORT);
+    vga_set_cursor(line, column);
+    vga_flush();
 }
 
 void vga_save_cursor(cursor_t* buffer)
@@ -437,57 +620,8 @@ void vga_restore_cursor(const cursor_t buffer)
 
 void vga_scroll(const SCROLL_DIRECTION_E direction, const uint32_t lines_count)
 {
-    uint32_t to_scroll;
-
-    if(VGA_TEXT_SCREEN_LINE_SIZE < lines_count)
-    {
-        to_scroll = VGA_TEXT_SCREEN_LINE_SIZE;
-    }
-    else
-    {
-        to_scroll = lines_count;
-    }
-
-    /* Select scroll direction */
-    if(direction == SCROLL_DOWN)
-    {
-        uint32_t i;
-        uint32_t j;
-
-
-        /* For each line scroll we want */
-        for(j = 0; j < to_scroll; ++j)
-        {
-            /* Copy all the lines to the above one */
-            for(i = 0; i < VGA_TEXT_SCREEN_LINE_SIZE - 1; ++i)
-            {
-                memmove(vga_get_framebuffer(i, 0),
-                        vga_get_framebuffer(i + 1, 0),
-                        sizeof(uint16_t) * VGA_TEXT_SCREEN_COL_SIZE);
-                last_columns[i] = last_columns[i+1];
-            }
-            last_columns[VGA_TEXT_SCREEN_LINE_SIZE - 1] = 0;
-        }
-        /* Clear last line */
-        for(i = 0; i < VGA_TEXT_SCREEN_COL_SIZE; ++i)
-        {
-            vga_print_char(VGA_TEXT_SCREEN_LINE_SIZE - 1, i, ' ');
-        }
-
-    }
-
-    /* Replace cursor */
-    vga_put_cursor_at(VGA_TEXT_SCREEN_LINE_SIZE - to_scroll, 0);
-
-    if(to_scroll <= last_printed_cursor.y)
-    {
-        last_printed_cursor.y -= to_scroll;
-    }
-    else
-    {
-        last_printed_cursor.x = 0;
-        last_printed_cursor.y = 0;
-    }
+    vga_scroll_lines(direction, lines_count);
+    vga_flush();
 }
 
 void vga_set_color_scheme(const colorscheme_t color_scheme)
@@ -508,19 +642,23 @@ void vga_save_color_scheme(colorscheme_t* buffer)
 
 void vga_put_string(const char* string)
 {
-    size_t i;
-
     /* Output each character of the string */
-    for(i = 0; i < strlen(string); ++i)
+    while(*string != 0)
     {
-        vga_put_char(string[i]);
+        vga_process_char(*string);
+        last_printed_cursor = screen_cursor;
+        ++string;
     }
+
+    vga_flush();
 }
 
 void vga_put_char(const char character)
 {
     vga_process_char(character);
     last_printed_cursor = screen_cursor;
+
+    vga_flush();
 }
 
 void vga_console_write_keyboard(const char* string, const size_t size)
@@ -532,6 +670,8 @@ void vga_console_write_keyboard(const char* string, const size_t size)
     {
         vga_process_char(string[i]);
     }
+
+    vga_flush();
 }
 
 const kernel_graphic_driver_t* vga_text_get_driver(void)
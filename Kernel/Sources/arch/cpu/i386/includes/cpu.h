@@ -133,6 +133,12 @@ inline static void cpu_hlt(void)
     __asm__ __volatile__ ("hlt":::"memory");
 }
 
+/** @brief Hints the CPU that the current thread is in a spin-wait loop. */
+inline static void cpu_pause(void)
+{
+    __asm__ __volatile__ ("pause":::"memory");
+}
+
 /**
  * @brief Returns the current CPU flags.
  *
@@ -31,6 +31,8 @@
 #include <cpu_settings.h>       /* CPU structures */
 #include <interrupts.h>         /* Interrupt manager */
 #include <cpu_api.h>            /* CPU API */
+#include <critical.h>           /* Critical sections */
+#include <syscall.h>            /* System call manager */
 
 /* Configuration files */
 #include <config.h>
@@ -1229,6 +1231,58 @@ uint32_t cpu_get_saved_interrupt_state(const cpu_state_t* cpu_state,
     return stack_state->eflags & CPU_EFLAGS_IF;
 }
 
+uintptr_t cpu_get_saved_pc(const cpu_state_t* cpu_state,
+                           const stack_state_t* stack_state)
+{
+    (void) cpu_state;
+    return stack_state->eip;
+}
+
+uint32_t cpu_get_saved_backtrace(const cpu_state_t* cpu_state,
+                                 const stack_state_t* stack_state,
+                                 uintptr_t* frames,
+                                 const uint32_t max_depth,
+                                 const uintptr_t stack_start,
+                                 const uintptr_t stack_end)
+{
+    uintptr_t* frame;
+    uintptr_t  next_frame;
+    uint32_t   depth;
+
+    (void) stack_state;
+
+    if(frames == NULL)
+    {
+        return 0;
+    }
+
+    /* Frames grow toward the stack end, any other frame is corrupted or does
+     * not belong to the stack.
+     */
+    frame = (uintptr_t*)cpu_state->ebp;
+    depth = 0;
+    while(depth < max_depth &&
+          ((uintptr_t)frame & (sizeof(uintptr_t) - 1)) == 0 &&
+          (uintptr_t)frame >= stack_start &&
+          (uintptr_t)(frame + 2) <= stack_end)
+    {
+        if(frame[1] == 0)
+        {
+            break;
+        }
+        frames[depth++] = frame[1];
+
+        next_frame = frame[0];
+        if(next_frame <= (uintptr_t)frame)
+        {
+            break;
+        }
+        frame = (uintptr_t*)next_frame;
+    }
+
+    return depth;
+}
+
 void cpu_init_thread_context(void (*entry_point)(void),
                              kernel_thread_t* thread)
 {
@@ -1345,6 +1399,31 @@ void cpu_syscall(uint32_t syscall_id, void* params)
         : "ecx", "edx");
 }
 
+void cpu_syscall_fast(uint32_t syscall_id, void* params)
+{
+    uint32_t int_state;
+    uint32_t cs;
+
+    KERNEL_DEBUG(CPU_DEBUG_ENABLED, "CPU",
+                 "Requesting fast syscall %d", syscall_id);
+
+    __asm__ __volatile__("mov %%cs, %0" : "=r" (cs));
+
+    if((cs & 0x3) == 0)
+    {
+        /* Already in kernel mode, no privilege change is needed. Interrupts
+         * are disabled as they would be by the system call interrupt gate.
+         */
+        ENTER_CRITICAL(int_state);
+        syscall_fast_handler(syscall_id, params, int_state);
+        EXIT_CRITICAL(int_state);
+    }
+    else
+    {
+        cpu_syscall(syscall_id, params);
+    }
+}
+
 void cpu_get_syscall_data(const cpu_state_t* cpu_state,
                           const stack_state_t* stack_state,
                           uint32_t* syscall_id,
@@ -1699,4 +1778,21 @@ void cpu_atomic_store(volatile int32_t* memory, const int32_t val)
     *memory = val;
 }
 
+uint64_t cpu_get_timestamp(void)
+{
+    return cpu_rdtsc();
+}
+
+int32_t cpu_atomic_swap(volatile int32_t* memory, const int32_t val)
+{
+    int32_t prev;
+    /* xchg with a memory operand is always locked */
+    __asm__ __volatile__ (
+            "xchg %0, %1\n\t"
+            : "=r" (prev), "+m" (*memory)
+            : "0" (val)
+            : "memory");
+    return prev;
+}
+
 /************************************ EOF *************************************/
\ No newline at end of file
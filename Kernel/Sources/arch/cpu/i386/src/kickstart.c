@@ -48,6 +48,7 @@
 #include <syscall.h>               /* System calls manager */
 #include <init_rd.h>               /* Init ram disk */
 #include <futex.h>                 /* FUtex API */
+#include <profiler.h>              /* Kernel profiler */
 
 /* Configuration files */
 #include <config.h>
@@ -194,12 +195,21 @@ void kernel_kickstart(void)
     rtc_init();
     KERNEL_SUCCESS("RTC initialized\n");
 
+    err = uart_enable_interrupts();
+    KICKSTART_ASSERT(err == OS_NO_ERR, "Could not enable serial interrupts",
+                     err);
+    KERNEL_SUCCESS("Serial interrupts enabled\n");
+
     lapic_timer_init();
     KERNEL_SUCCESS("LAPIC timer initialized\n");
 
     time_init(lapic_timer_get_driver(), rtc_get_driver());
     KERNEL_SUCCESS("Timer factory initialized\n");
 
+    err = profiler_init(pit_get_driver());
+    KICKSTART_ASSERT(err == OS_NO_ERR, "Could not init the profiler", err);
+    KERNEL_SUCCESS("Profiler initialized\n");
+
     syscall_init();
     KERNEL_SUCCESS("System calls initialized\n");
 
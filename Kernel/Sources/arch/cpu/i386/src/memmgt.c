@@ -38,6 +38,7 @@
 #include <cpu.h>                  /* CPU management */
 #include <ctrl_block.h>           /* Kernel process structure */
 #include <sys/syscall_api.h>      /* System call API */
+#include <kstats.h>                 /* Kernel phase statistics */
 
 /* Configuration files */
 #include <config.h>
@@ -2189,6 +2190,8 @@ static OS_RETURN_E memory_copy_self_stack(mem_copy_self_data_t* data,
     uintptr_t*  new_data_frame;
     OS_RETURN_E err;
 
+    KSTATS_PHASE_START(phase_start);
+
     curr_addr = (uintptr_t)kstack_addr;
     while(curr_addr < (uintptr_t)kstack_addr + kstack_size)
     {
@@ -2325,6 +2328,8 @@ static OS_RETURN_E memory_copy_self_stack(mem_copy_self_data_t* data,
         return OS_ERR_MEMORY_NOT_MAPPED;
     }
 
+    KSTATS_PHASE_END(KSTATS_PHASE_COPY_STACK, phase_start);
+
     return OS_NO_ERR;
 }
 
@@ -2655,6 +2660,8 @@ OS_RETURN_E memory_copy_self_mapping(kernel_process_t* dst_process,
     OS_RETURN_E          err;
     mem_copy_self_data_t data;
 
+    KSTATS_PHASE_START(phase_start);
+
     if(dst_process == NULL)
     {
         return OS_ERR_NULL_POINTER;
@@ -2713,6 +2720,8 @@ OS_RETURN_E memory_copy_self_mapping(kernel_process_t* dst_process,
         return memory_copy_self_clean(&data, err);
     }
 
+    KSTATS_PHASE_END(KSTATS_PHASE_COPY_MAPPING, phase_start);
+
     return OS_NO_ERR;
 }
 
@@ -2874,6 +2883,8 @@ void memory_clean_process_memory(uintptr_t pg_dir)
     uintptr_t* pgdir_page;
     uintptr_t* pgtable_page;
 
+    KSTATS_PHASE_START(phase_start);
+
     /* Allocate temporary tables */
     pgdir_page   = memory_alloc_pages_from(free_kernel_pages,
                                            1,
@@ -2932,6 +2943,8 @@ void memory_clean_process_memory(uintptr_t pg_dir)
 
     memory_free_pages_to(free_kernel_pages, pgdir_page, 1);
     memory_free_pages_to(free_kernel_pages, pgtable_page, 1);
+
+    KSTATS_PHASE_END(KSTATS_PHASE_CLEAN_MEMORY, phase_start);
 }
 
 void memory_free_process_data(const void* virt_addr,
@@ -32,6 +32,7 @@
 #include <string.h>               /* Memset */
 #include <rt_clock.h>             /* RTC driver */
 #include <scheduler.h>            /* Scheduler */
+#include <trace.h>                /* Function tracer */
 
 /* Configuration files */
 #include <config.h>
@@ -383,8 +384,6 @@ static void print_stack_trace(void)
     size_t        i;
     uintptr_t*    call_addr;
     uintptr_t*    last_ebp;
-    elf_symtab_t* tab_entry;
-    uintptr_t     tab_end;
     char*         symbol;
     char          buff[PANIC_SYM_LENGTH + 1];
 
@@ -396,28 +395,7 @@ static void print_stack_trace(void)
     for(i = 0; i < STACK_TRACE_SIZE && call_addr != NULL; ++i)
     {
         /* Get the associated symbol */
-        symbol = NULL;
-        tab_entry = (elf_symtab_t*)_KERNEL_SYMTAB_ADDR;
-        tab_end   = _KERNEL_SYMTAB_ADDR + _KERNEL_SYMTAB_SIZE;
-
-        while((uintptr_t)tab_entry < tab_end)
-        {
-            /* Check bounds */
-            if(tab_entry->st_value <= (uint32_t)call_addr &&
-               tab_entry->st_value + tab_entry->st_size > (uint32_t)call_addr)
-            {
-                symbol = (char*)_KERNEL_STRTAB_ADDR + tab_entry->st_name;
-
-                /* Check that we do not overflow the str tab */
-                if((uintptr_t)symbol >
-                   _KERNEL_STRTAB_ADDR + _KERNEL_STRTAB_SIZE)
-                {
-                    symbol = NULL;
-                }
-                break;
-            }
-            ++tab_entry;
-        }
+        symbol = (char*)kernel_get_symbol((uintptr_t)call_addr, NULL);
 
         if(symbol != NULL && strlen(symbol) > PANIC_SYM_LENGTH)
         {
@@ -436,6 +414,41 @@ static void print_stack_trace(void)
     }
 }
 
+const char* kernel_get_symbol(const uintptr_t address, uintptr_t* symbol_start)
+{
+    elf_symtab_t* tab_entry;
+    uintptr_t     tab_end;
+    const char*   symbol;
+
+    tab_entry = (elf_symtab_t*)_KERNEL_SYMTAB_ADDR;
+    tab_end   = _KERNEL_SYMTAB_ADDR + _KERNEL_SYMTAB_SIZE;
+
+    while((uintptr_t)tab_entry < tab_end)
+    {
+        /* Check bounds */
+        if(tab_entry->st_value <= (uint32_t)address &&
+           tab_entry->st_value + tab_entry->st_size > (uint32_t)address)
+        {
+            symbol = (char*)_KERNEL_STRTAB_ADDR + tab_entry->st_name;
+
+            /* Check that we do not overflow the str tab */
+            if((uintptr_t)symbol > _KERNEL_STRTAB_ADDR + _KERNEL_STRTAB_SIZE)
+            {
+                return NULL;
+            }
+
+            if(symbol_start != NULL)
+            {
+                *symbol_start = tab_entry->st_value;
+            }
+            return symbol;
+        }
+        ++tab_entry;
+    }
+
+    return NULL;
+}
+
 void panic_handler(cpu_state_t* cpu_state,
                    uintptr_t int_id,
                    stack_state_t* stack_state)
@@ -453,6 +466,12 @@ void panic_handler(cpu_state_t* cpu_state,
     kernel_process_t* process;
     kernel_thread_t*  thread;
 
+    /* Keep the functions trace that led to the panic */
+    trace_stop();
+
+    /* The log drain thread will not run anymore */
+    kernel_log_sync();
+
     time    = rtc_get_current_daytime();
     hours   = time / 3600;
     minutes = (time / 60) % 60;
@@ -512,6 +531,9 @@ void panic_handler(cpu_state_t* cpu_state,
 
     print_stack_trace();
 
+    /* Decode the functions trace on the uart port, if the tracer is built */
+    trace_dump(TRACE_PANIC_EVENTS);
+
     /* Hide cursor */
     panic_scheme.background = BG_BLACK;
     panic_scheme.foreground = FG_BLACK;
@@ -123,6 +123,45 @@ uint32_t cpu_get_interrupt_state(void);
 uint32_t cpu_get_saved_interrupt_state(const cpu_state_t* cpu_state,
                                        const stack_state_t* stack_state);
 
+/**
+ * @brief Returns the saved program counter.
+ *
+ * @details Returns the address of the instruction that was interrupted based
+ * on the stack state.
+ *
+ * @param[in] cpu_state The current CPU state.
+ * @param[in] stack_state The current stack state.
+ *
+ * @return The address of the interrupted instruction.
+ */
+uintptr_t cpu_get_saved_pc(const cpu_state_t* cpu_state,
+                           const stack_state_t* stack_state);
+
+/**
+ * @brief Unwinds the saved context call stack.
+ *
+ * @details Follows the frame pointers chain of the interrupted context and
+ * stores the return addresses found. The walk stops when a frame is not
+ * contained in the stack boundaries given as parameter, which allows the
+ * function to be called from an interrupt handler on any context.
+ *
+ * @param[in] cpu_state The current CPU state.
+ * @param[in] stack_state The current stack state.
+ * @param[out] frames The buffer receiving the return addresses.
+ * @param[in] max_depth The maximal number of return addresses to store.
+ * @param[in] stack_start The lowest address of the interrupted stack.
+ * @param[in] stack_end The address following the end of the interrupted
+ * stack.
+ *
+ * @return The number of return addresses stored in the buffer.
+ */
+uint32_t cpu_get_saved_backtrace(const cpu_state_t* cpu_state,
+                                 const stack_state_t* stack_state,
+                                 uintptr_t* frames,
+                                 const uint32_t max_depth,
+                                 const uintptr_t stack_start,
+                                 const uintptr_t stack_end);
+
 /**
  * @brief Initializes the thread's context.
  *
@@ -175,6 +214,21 @@ void cpu_restore_context(cpu_state_t* cpu_state,
  */
 void cpu_syscall(uint32_t syscall_id, void* params);
 
+/**
+ * @brief Generates a system call through the fast entry path.
+ *
+ * @details Generates a system call without going through the interrupt
+ * mechanism. Callers already running in kernel mode dispatch the system call
+ * directly with interrupts disabled. Callers running in user mode raise the
+ * system call with cpu_syscall. Unlike cpu_syscall, which is dropped as a
+ * blocked interrupt when raised with interrupts disabled, a kernel mode
+ * caller's system call is always executed.
+ *
+ * @param[in] syscall_id The system call function ID to pass to the handler.
+ * @param[in] params The pointer to the parameters to pass to the handler.
+ */
+void cpu_syscall_fast(uint32_t syscall_id, void* params);
+
 /**
  * @brief Retreives system call parameters.
  *
@@ -201,13 +255,51 @@ void cpu_get_syscall_data(const cpu_state_t* cpu_state,
 void cpu_switch_user_mode(void);
 
 /**
- * @brief Lock a spinlock.
+ * @brief Returns the CPU cycle counter.
  *
- * @details Lock the spinlock passed in parameters.
+ * @details Returns the CPU cycle counter. The value is monotonic on the
+ * current CPU and is meant to measure short durations.
+ *
+ * @return The current value of the CPU cycle counter.
+ */
+uint64_t cpu_get_timestamp(void);
+
+/**
+ * @brief Lock a ticket spinlock.
+ *
+ * @details Lock the ticket spinlock passed in parameters. The lock word
+ * contains the ticket currently served in its low 16 bits and the next ticket
+ * to distribute in its high 16 bits. Threads acquire the lock in the order they
+ * requested it.
  *
  * @param[in, out] lockword The spinlock to use.
+ *
+ * @return 0 is returned if the lock was acquired without waiting, another value
+ * is returned otherwise.
  */
-void cpu_lock_spinlock(volatile uint32_t* lockword);
+uint32_t cpu_lock_spinlock(volatile uint32_t* lockword);
+
+/**
+ * @brief Unlock a ticket spinlock.
+ *
+ * @details Unlock the ticket spinlock passed in parameters, the next waiting
+ * ticket acquires the lock.
+ *
+ * @param[in, out] lockword The spinlock to use.
+ */
+void cpu_unlock_spinlock(volatile uint32_t* lockword);
+
+/**
+ * @brief Try to lock a ticket spinlock.
+ *
+ * @details Try to lock the ticket spinlock passed in parameters. This function
+ * does not wait if the lock is held or if other threads wait for it.
+ *
+ * @param[in, out] lockword The spinlock to use.
+ *
+ * @return 1 is returned if the lock was acquired, 0 otherwise.
+ */
+uint32_t cpu_trylock_spinlock(volatile uint32_t* lockword);
 
 /**
  * @brief Compare and swap primitive.
@@ -251,6 +343,19 @@ int32_t cpu_fetch_and_add(volatile int32_t* memory, const int32_t val);
  */
 void cpu_atomic_store(volatile int32_t* memory, const int32_t val);
 
+/**
+ * @brief Atomically exchanges a value in the memory.
+ *
+ * @details Atomically stores a value in the memory and returns the value that
+ * was stored before.
+ *
+ * @param[out] memory The memory region to modify.
+ * @param[in] val The value to store.
+ *
+ * @returns The previous value contained in the memory region is returned.
+ */
+int32_t cpu_atomic_swap(volatile int32_t* memory, const int32_t val);
+
 #endif /* #ifndef __CPU_API_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -119,6 +119,20 @@ void kernel_panic(const uint32_t error_code,
                   const char* file,
                   const size_t line);
 
+/**
+ * @brief Returns the kernel symbol containing an address.
+ *
+ * @details Searches the kernel symbol table passed by multiboot at
+ * initialization time for the symbol containing the address.
+ *
+ * @param[in] address The address to resolve.
+ * @param[out] symbol_start The buffer receiving the address of the symbol. Can
+ * be NULL when not needed.
+ *
+ * @return The name of the symbol or NULL if no symbol contains the address.
+ */
+const char* kernel_get_symbol(const uintptr_t address, uintptr_t* symbol_start);
+
 #endif /* #ifndef __CPU_PANIC_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
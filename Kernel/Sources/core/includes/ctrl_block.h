@@ -98,6 +98,27 @@ typedef enum
     THREAD_TYPE_USER
 } THREAD_TYPE_E;
 
+/** @brief Thread's scheduling statistics, times are in CPU cycles. */
+typedef struct
+{
+    /** @brief Time spent running the thread's own code. */
+    uint64_t user_time;
+
+    /** @brief Time spent running system calls on behalf of the thread. */
+    uint64_t kernel_time;
+
+    /** @brief Time spent in the ready queues, waiting for the CPU. */
+    uint64_t wait_time;
+
+    /** @brief Number of times the thread gave the CPU away by blocking or
+     * yielding.
+     */
+    uint32_t voluntary_switches;
+
+    /** @brief Number of times the thread was preempted while still runnable. */
+    uint32_t involuntary_switches;
+} thread_stats_t;
+
 /** @brief Kernel process structure. */
 typedef struct kernel_process
 {
@@ -204,8 +225,32 @@ typedef struct
     /** @brief Thread's end time. */
     uint64_t end_time;
 
+    /** @brief Thread's scheduling statistics. */
+    thread_stats_t stats;
+
+    /** @brief Timestamp of the last statistics update: when the thread got
+     * the CPU, entered or left a system call, or became ready.
+     */
+    uint64_t stats_time;
+
+    /** @brief Set when the thread became ready after waiting, its next
+     * election is accounted in the wake up latency histograms.
+     */
+    bool_t stats_woken;
+
+    /** @brief System call nesting depth, the run time is accounted as kernel
+     * time when not 0.
+     */
+    uint32_t syscall_depth;
+
     /** @brief Thread's resource queue. */
     kqueue_t* resources;
+
+    /** @brief Thread's registered system call ring. */
+    struct syscall_ring* syscall_ring;
+
+    /** @brief Set while the thread executes the pending tasklets. */
+    volatile bool_t softirq_running;
 } kernel_thread_t;
 
 /** @brief This is the representation of a thread's resource. */
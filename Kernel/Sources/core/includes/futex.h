@@ -51,6 +51,31 @@ typedef struct
     OS_RETURN_E error;
 } futex_t;
 
+/** @brief Futex requeue structure definition. */
+typedef struct
+{
+    /** @brief Futex atomic memory region the threads are waiting on */
+    uint32_t* addr;
+
+    /** @brief Number of threads to wake */
+    uint32_t wake_count;
+
+    /** @brief Futex atomic memory region to requeue the other threads on */
+    uint32_t* requeue_addr;
+
+    /**
+     * @brief Expected value at the requeue memory region. The requeue is
+     * aborted if the current value differs.
+     */
+    uint32_t requeue_val;
+
+    /** @brief Maximal number of threads to requeue */
+    uint32_t requeue_count;
+
+    /** @brief The futex's error state */
+    OS_RETURN_E error;
+} futex_requeue_t;
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -109,6 +134,23 @@ void futex_wait(const SYSCALL_FUNCTION_E func, void* params);
  */
 void futex_wake(const SYSCALL_FUNCTION_E func, void* params);
 
+/**
+ * @brief System call handler to wake and requeue threads on a given futex.
+ *
+ * @details System call handler to wake and requeue threads on a given futex.
+ * Up to wake_count threads waiting on the futex are woken, then up to
+ * requeue_count of the remaining waiting threads are moved to the futex located
+ * at requeue_addr without being woken. The requeued threads will be woken by a
+ * future wake on the requeue futex. If the value at requeue_addr is not
+ * requeue_val, nothing is done and the error is set to OS_ERR_INCORRECT_VALUE.
+ *
+ * @param[in] func The syscall function ID, must correspond to the
+ * futex_requeue call.
+ * @param[in, out] params The parameters used by the function, must be of type
+ * futex_requeue_t.
+ */
+void futex_requeue(const SYSCALL_FUNCTION_E func, void* params);
+
 #endif /* #ifndef __CORE_FUTEX_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
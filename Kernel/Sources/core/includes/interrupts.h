@@ -60,6 +60,29 @@ typedef struct
     void(*handler)(cpu_state_t*, uintptr_t, stack_state_t*);
 } custom_handler_t;
 
+/** @brief Interrupt line statistics. */
+typedef struct
+{
+    /** @brief Number of dispatched interrupts. */
+    uint64_t count;
+
+    /** @brief Cumulated cycles spent from the dispatcher entry to the handler
+     * call.
+     */
+    uint64_t dispatch_cycles;
+
+    /** @brief Number of handler executions accounted in the handler cycles.
+     * Handlers that switched context are not accounted.
+     */
+    uint64_t handler_count;
+
+    /** @brief Cumulated cycles spent in the handler. */
+    uint64_t handler_cycles;
+
+    /** @brief Maximal cycles spent in the handler. */
+    uint64_t handler_max_cycles;
+} interrupt_stats_t;
+
 /** @brief Defines the basic interface for an interrupt management driver (let
  * it be PIC or IO APIC for instance).
  */
@@ -160,6 +183,23 @@ void kernel_interrupt_handler(cpu_state_t cpu_state,
                               uintptr_t int_id,
                               stack_state_t stack_state);
 
+/**
+ * @brief Kernel's direct interrupt handler.
+ *
+ * @details Interrupt handler used by the interrupt lines that cannot be
+ * spurious: exceptions, scheduler software interrupt, panic and system call
+ * interrupts. The function skips the spurious interrupt check and dispatches
+ * the interrupt to the desired function. This function should only be called
+ * by an assembly interrupt handler.
+ *
+ * @param[in, out] cpu_state The cpu registers structure.
+ * @param[in] int_id The interrupt number.
+ * @param[in, out] stack_state The stack state before the interrupt.
+ */
+void kernel_direct_interrupt_handler(cpu_state_t cpu_state,
+                                     uintptr_t int_id,
+                                     stack_state_t stack_state);
+
 /**
  * @brief Set the driver to be used by the kernel to manage interrupts.
  *
@@ -222,6 +262,19 @@ OS_RETURN_E kernel_interrupt_register_irq_handler(const uint32_t irq_number,
  */
 OS_RETURN_E kernel_interrupt_remove_irq_handler(const uint32_t irq_number);
 
+/**
+ * @brief Returns the interrupt line attached to an IRQ.
+ *
+ * @details Returns the interrupt line attached to an IRQ by the current
+ * interrupt driver.
+ *
+ * @param[in] irq_number The IRQ number to get the interrupt line of.
+ *
+ * @return The interrupt line attached to the IRQ. -1 is returned if the IRQ
+ * number is not supported by the driver.
+ */
+int32_t kernel_interrupt_get_irq_int_line(const uint32_t irq_number);
+
 /**
  * @brief Registers an interrupt handler for the desired interrupt line.
  *
@@ -267,6 +320,83 @@ OS_RETURN_E kernel_interrupt_register_int_handler(const uint32_t interrupt_line,
  */
 OS_RETURN_E kernel_interrupt_remove_int_handler(const uint32_t interrupt_line);
 
+/**
+ * @brief Returns the dispatch cost of an interrupt line.
+ *
+ * @details Returns the number of interrupts dispatched on the interrupt line
+ * and the cumulated number of CPU cycles spent between the C dispatcher entry
+ * and the handler call. Blocked and spurious interrupts are not accounted.
+ *
+ * @param[in] interrupt_line The interrupt line to get the cost of.
+ * @param[out] count The buffer receiving the number of dispatched interrupts.
+ * @param[out] cycles The buffer receiving the cumulated dispatch cycles.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OR_ERR_UNAUTHORIZED_INTERRUPT_LINE is returned if the desired
+ * interrupt line is not allowed.
+ * - OS_ERR_NULL_POINTER is returned if a buffer is NULL.
+ */
+OS_RETURN_E kernel_interrupt_get_dispatch_cost(const uint32_t interrupt_line,
+                                               uint64_t* count,
+                                               uint64_t* cycles);
+
+/**
+ * @brief Returns the statistics of an interrupt line on a CPU.
+ *
+ * @details Returns the number of interrupts dispatched on the interrupt line
+ * by the CPU, the dispatch cost and the handler cost. The handler cost is
+ * only accounted when the handler did not switch context.
+ *
+ * @param[in] cpu_id The CPU identifier.
+ * @param[in] interrupt_line The interrupt line to get the statistics of.
+ * @param[out] stats The buffer receiving the statistics.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_OUT_OF_BOUND is returned if the CPU identifier is not valid.
+ * - OR_ERR_UNAUTHORIZED_INTERRUPT_LINE is returned if the desired
+ * interrupt line is not allowed.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ */
+OS_RETURN_E kernel_interrupt_get_stats(const uint32_t cpu_id,
+                                       const uint32_t interrupt_line,
+                                       interrupt_stats_t* stats);
+
+/**
+ * @brief Returns the number of spurious interrupts.
+ *
+ * @return The number of spurious interrupts since the statistics were reset.
+ */
+uint32_t kernel_interrupt_get_spurious_count(void);
+
+/**
+ * @brief Resets the interrupt statistics.
+ *
+ * @details Resets the interrupt statistics of all the CPUs and the spurious
+ * interrupts counter.
+ */
+void kernel_interrupt_reset_stats(void);
+
+/**
+ * @brief Returns the interrupt statistics generation.
+ *
+ * @details The generation is incremented each time the interrupt statistics
+ * are reset. A snapshot of the statistics taken under another generation is
+ * no longer comparable to the current statistics.
+ *
+ * @return The number of times the interrupt statistics were reset.
+ */
+uint32_t kernel_interrupt_get_stats_generation(void);
+
+/**
+ * @brief Prints the interrupt statistics.
+ *
+ * @details Prints the statistics of every interrupt line that received an
+ * interrupt, for each CPU. The costs are printed as average cycles.
+ */
+void kernel_interrupt_dump_stats(void);
+
 /**
  * @brief Restores the CPU interrupts state.
  *
@@ -105,6 +105,24 @@ void kfree(void* ptr);
  */
 uint32_t kheap_get_free(void);
 
+/**
+ * @brief Returns the kernel heap memory used by the chunks meta data.
+ *
+ * @return The kernel heap memory used by the chunks meta data is returned.
+ */
+uint32_t kheap_get_meta(void);
+
+/**
+ * @brief Returns the size of the largest free chunk of the kernel heap.
+ *
+ * @details Returns the size of the largest free chunk of the kernel heap, which
+ * is the largest allocation that can succeed. Compared to the free memory, it
+ * gives the heap fragmentation.
+ *
+ * @return The size of the largest free chunk of the kernel heap is returned.
+ */
+uint32_t kheap_get_largest_free(void);
+
 #endif /* #ifndef __CORE_KHEAP_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
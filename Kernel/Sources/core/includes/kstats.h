@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * @file kstats.h
+ *
+ * @see kstats.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 06/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel phase statistics.
+ *
+ * @details Kernel phase statistics. When the kernel is built with STATS=TRUE,
+ * the process management paths measure the cycles spent in each of their
+ * phases and accumulate them in per CPU counters. The phases nest: the copy
+ * of the process mapping is part of the fork and the copy of the kernel stack
+ * is part of the mapping copy. The measures are compiled out otherwise.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_KSTATS_H_
+#define __CORE_KSTATS_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>       /* Generic int types */
+#include <stddef.h>       /* Standard definitions */
+#include <cpu_api.h>      /* CPU API */
+#include <kernel_error.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Measured kernel phases. */
+typedef enum
+{
+    /** @brief Fork system call, from entry to the child creation. */
+    KSTATS_PHASE_FORK         = 0,
+    /** @brief Copy of the process page directory and tables. */
+    KSTATS_PHASE_COPY_MAPPING = 1,
+    /** @brief Copy of the forking thread kernel stack. */
+    KSTATS_PHASE_COPY_STACK   = 2,
+    /** @brief Exit system call, from entry to the last context switch. */
+    KSTATS_PHASE_EXIT         = 3,
+    /** @brief Release of the process page directory, tables and frames. */
+    KSTATS_PHASE_CLEAN_MEMORY = 4,
+    /** @brief Waitpid child reaping, once the child has been joined. */
+    KSTATS_PHASE_WAITPID      = 5,
+    /** @brief Number of phases. */
+    KSTATS_PHASE_COUNT
+} KSTATS_PHASE_E;
+
+/** @brief Statistics of a kernel phase, in CPU cycles. */
+typedef struct
+{
+    /** @brief Number of times the phase was completed. */
+    uint64_t count;
+
+    /** @brief Total cycles spent in the phase. */
+    uint64_t cycles;
+
+    /** @brief Slowest execution of the phase. */
+    uint64_t max;
+} kstats_phase_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#ifdef KERNEL_STATS_ENABLED
+
+/**
+ * @brief Starts measuring a phase.
+ *
+ * @param[in] START The name of the variable declared to keep the start
+ * timestamp.
+ */
+#define KSTATS_PHASE_START(START) uint64_t START = cpu_get_timestamp()
+
+/**
+ * @brief Ends measuring a phase and accounts it.
+ *
+ * @param[in] PHASE The measured phase.
+ * @param[in] START The variable given to KSTATS_PHASE_START.
+ */
+#define KSTATS_PHASE_END(PHASE, START) \
+    kstats_phase_record((PHASE), cpu_get_timestamp() - (START))
+
+#else
+
+#define KSTATS_PHASE_START(START)
+#define KSTATS_PHASE_END(PHASE, START)
+
+#endif
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Accounts an execution of a phase.
+ *
+ * @details Accounts the execution in the counters of the current CPU. This
+ * function should only be called through KSTATS_PHASE_END.
+ *
+ * @param[in] phase The measured phase.
+ * @param[in] cycles The cycles spent in the phase.
+ */
+void kstats_phase_record(const KSTATS_PHASE_E phase, const uint64_t cycles);
+
+/**
+ * @brief Returns the statistics of a phase.
+ *
+ * @param[in] phase The phase to get the statistics of.
+ * @param[out] stats The buffer receiving the statistics of all the CPUs.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the kernel is built without the
+ * phase statistics.
+ * - OS_ERR_OUT_OF_BOUND is returned if the phase is not valid.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ */
+OS_RETURN_E kstats_get_phase(const KSTATS_PHASE_E phase,
+                             kstats_phase_t* stats);
+
+/**
+ * @brief Clears the statistics of all the phases.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the kernel is built without the
+ * phase statistics.
+ */
+OS_RETURN_E kstats_clear(void);
+
+#endif /* #ifndef __CORE_KSTATS_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * @file profiler.h
+ *
+ * @see profiler.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 02/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel sampling profiler.
+ *
+ * @details Kernel sampling profiler. On each sampling interrupt the profiler
+ * records the interrupted instruction address and optionally the call stack
+ * of the interrupted context in a per CPU ring buffer. Samples are taken
+ * either on the main timer ticks or on a dedicated sampling timer running at
+ * a higher frequency. The samples are resolved against the kernel symbol
+ * table and dumped as a flat profile on the uart port.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_PROFILER_H_
+#define __CORE_PROFILER_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>          /* Generic int types */
+#include <stddef.h>          /* Standard definitions */
+#include <cpu_settings.h>    /* CPU structures */
+#include <time_management.h> /* Timer driver abstraction */
+#include <kernel_error.h>    /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of samples kept per CPU, older samples are overwritten. */
+#define PROFILER_RING_SIZE 512
+
+/** @brief Maximal number of return addresses recorded per sample. */
+#define PROFILER_BACKTRACE_DEPTH 4
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the profiler.
+ *
+ * @details Initializes the profiler and sets the dedicated sampling timer. The
+ * sampling timer can be NULL, in this case samples can only be taken on the
+ * main timer ticks.
+ *
+ * @param[in] sampling_timer The dedicated sampling timer driver.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the sampling timer driver has NULL
+ * function pointers.
+ */
+OS_RETURN_E profiler_init(const kernel_timer_t* sampling_timer);
+
+/**
+ * @brief Starts the profiler.
+ *
+ * @details Clears the previous samples and starts sampling. When the frequency
+ * is 0, samples are taken on each main timer tick. Otherwise the dedicated
+ * sampling timer is set to the frequency, which must be supported by the
+ * timer, and restored when the profiler is stopped.
+ *
+ * @param[in] frequency The sampling frequency in Hz, 0 to sample on the main
+ * timer ticks.
+ * @param[in] backtrace Set to TRUE to record the call stack of each sample.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the profiler is already
+ * started.
+ * - OS_ERR_NOT_SUPPORTED is returned if a frequency is requested but no
+ * sampling timer is set.
+ * - Other error codes returned by the sampling timer driver.
+ */
+OS_RETURN_E profiler_start(const uint32_t frequency, const bool_t backtrace);
+
+/**
+ * @brief Stops the profiler.
+ *
+ * @details Stops sampling, the samples are kept until the next start.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the profiler is not started.
+ * - Other error codes returned by the sampling timer driver.
+ */
+OS_RETURN_E profiler_stop(void);
+
+/**
+ * @brief Takes a sample on a main timer tick.
+ *
+ * @details Records a sample of the interrupted context when the profiler
+ * samples on the main timer ticks. This function should only be called by
+ * the main timer handler.
+ *
+ * @param[in] cpu_state The interrupted CPU state.
+ * @param[in] stack_state The interrupted stack state.
+ */
+void profiler_update(const cpu_state_t* cpu_state,
+                     const stack_state_t* stack_state);
+
+/**
+ * @brief Returns the number of samples taken.
+ *
+ * @return The number of samples taken on all the CPUs since the profiler was
+ * started, including the overwritten ones.
+ */
+uint64_t profiler_get_sample_count(void);
+
+/**
+ * @brief Prints the flat profile on the uart port.
+ *
+ * @details Resolves the samples kept in the ring buffers against the kernel
+ * symbol table and prints, for each symbol, the share of samples that
+ * interrupted the symbol (self) and, when backtraces are recorded, the share
+ * of samples where the symbol was on the call stack (total).
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the profiler is started.
+ */
+OS_RETURN_E profiler_dump(void);
+
+#endif /* #ifndef __CORE_PROFILER_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -38,6 +38,12 @@
 /** @brief Scheduler's thread highest priority. */
 #define KERNEL_HIGHEST_PRIORITY 0
 
+/** @brief Number of buckets of the wake up latency histograms, bucket n
+ * counts the latencies in [2^n, 2^(n + 1)) cycles, the last bucket also
+ * counts the longer ones.
+ */
+#define SCHED_LATENCY_BUCKETS 32
+
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
@@ -83,11 +89,33 @@ void sched_init(void);
  * @brief Calls the scheduler dispatch function.
  *
  * @details Calls the scheduler. This will raise an interrupt since we should
- * never call the scheduler routine outside of an interrupt context.
+ * never call the scheduler routine outside of an interrupt context. The
+ * calling thread yields the CPU, the switch is accounted as voluntary.
  */
 
 void sched_schedule(void);
 
+/**
+ * @brief Preempts the current thread.
+ *
+ * @details Calls the scheduler like sched_schedule but the switch is accounted
+ * as involuntary if the current thread is still ready. Used by the interrupt
+ * and system call exit paths when sched_need_resched is set.
+ */
+void sched_preempt(void);
+
+/**
+ * @brief Tells if the current thread must be preempted.
+ *
+ * @details Tells if a thread with a higher priority than the current thread
+ * became ready since the last scheduling. The interrupt and system call exit
+ * path uses this to preempt the current thread without waiting for the next
+ * scheduler tick.
+ *
+ * @return TRUE is returned if the scheduler must be called, FALSE otherwise.
+ */
+bool_t sched_need_resched(void);
+
 /**
  * @brief Puts the calling thread to sleep.
  *
@@ -313,6 +341,39 @@ void sched_get_thread_params(const SYSCALL_FUNCTION_E func, void* params);
  */
 void sched_set_thread_params(const SYSCALL_FUNCTION_E func, void* params);
 
+/**
+ * @brief System call handler to get the scheduling statistics.
+ *
+ * @details System call handler to get the scheduling statistics of a thread
+ * of the current process and the wake up latency histogram of a priority.
+ * The wake up latency is the time between a blocked or sleeping thread
+ * becoming ready and the thread getting the CPU. This system call fills a
+ * sched_stats_param_t structure given as parameter.
+ *
+ * @param[in] func The syscall function ID, must correspond to the get_stats
+ * call.
+ * @param[in, out] params The parameters used by the function, must be of type
+ * sched_stats_param_t.
+ */
+void sched_get_stats(const SYSCALL_FUNCTION_E func, void* params);
+
+/**
+ * @brief Accounts the entry of the current thread in a system call.
+ *
+ * @details The run time of the current thread is accounted as kernel time
+ * until the matching call to sched_syscall_exit. Nested system calls are
+ * accounted once.
+ */
+void sched_syscall_enter(void);
+
+/**
+ * @brief Accounts the exit of the current thread from a system call.
+ *
+ * @details The run time of the current thread is accounted as user time once
+ * the outermost system call exited.
+ */
+void sched_syscall_exit(void);
+
 /**
  * @brief Locks a thread from being scheduled.
  *
@@ -331,7 +392,9 @@ kqueue_node_t* sched_lock_thread(const THREAD_WAIT_TYPE_E block_type);
  *
  * @details Unlocks a thread from behing scheduled. Adds a thread to the active
  * threads table, the thread might be contained in an other structure such as a
- * mutex.
+ * mutex. If the unlocked thread has a higher priority than the current thread
+ * and do_schedule is not set, the current thread is preempted when returning
+ * from the current interrupt or system call.
  *
  * @param[in] node The node containing the thread to unlock.
  * @param[in] block_type The type of block (mutex, sem, ...)
@@ -0,0 +1,181 @@
+/*******************************************************************************
+ * @file softirq.h
+ *
+ * @see softirq.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 30/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel deferred interrupt work.
+ *
+ * @details Kernel deferred interrupt work. Interrupt handlers only do the
+ * minimal work (top half) and defer the rest (bottom half) either to a tasklet
+ * or to an interrupt thread. Tasklets are executed with interrupts enabled
+ * when the kernel returns from an interrupt to an interruptible context.
+ * Interrupt threads are kernel threads woken by the interrupt of their IRQ and
+ * scheduled at their own priority.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_SOFTIRQ_H_
+#define __CORE_SOFTIRQ_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>       /* Generic int types */
+#include <stddef.h>       /* Standard definitions */
+#include <kernel_error.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Stack size of the interrupt threads. */
+#define SOFTIRQ_THREAD_STACK_SIZE 0x1000
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Tasklet structure, a deferred routine scheduled by an interrupt
+ * handler.
+ */
+typedef struct tasklet
+{
+    /** @brief The routine executed by the tasklet. */
+    void (*routine)(void* args);
+
+    /** @brief The arguments given to the routine. */
+    void* args;
+
+    /** @brief Set when the tasklet is scheduled and not yet executed. */
+    volatile bool_t scheduled;
+
+    /** @brief Set while the tasklet routine is executed. */
+    volatile bool_t running;
+
+    /** @brief Next tasklet in the pending queue. */
+    struct tasklet* next;
+} tasklet_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a tasklet.
+ *
+ * @details Initializes a tasklet with the routine to execute and its
+ * arguments. A tasklet must not be initialized while it is scheduled.
+ *
+ * @param[out] tasklet The tasklet to initialize.
+ * @param[in] routine The routine executed by the tasklet.
+ * @param[in] args The arguments given to the routine.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the tasklet or the routine is NULL.
+ */
+OS_RETURN_E tasklet_init(tasklet_t* tasklet,
+                         void (*routine)(void* args),
+                         void* args);
+
+/**
+ * @brief Schedules a tasklet.
+ *
+ * @details Queues the tasklet for execution. This function can be called
+ * from an interrupt handler. Scheduling a tasklet that is already queued has
+ * no effect, the tasklet is executed only once. Tasklets are executed in the
+ * order they were scheduled. A tasklet scheduled while it is running is
+ * queued again once the running execution returns, a tasklet is never
+ * executed twice at the same time.
+ *
+ * @param[in, out] tasklet The tasklet to schedule.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the tasklet is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the tasklet has no routine.
+ */
+OS_RETURN_E tasklet_schedule(tasklet_t* tasklet);
+
+/**
+ * @brief Tells if tasklets are waiting to be executed.
+ *
+ * @return TRUE if tasklets are waiting to be executed, FALSE otherwise.
+ */
+bool_t softirq_pending(void);
+
+/**
+ * @brief Executes the pending tasklets.
+ *
+ * @details Executes the pending tasklets with interrupts enabled until the
+ * pending queue is empty. This function should only be called by the
+ * interrupt manager, with interrupts disabled, when returning to an
+ * interruptible context. Nested calls in the thread executing the tasklets
+ * return immediately, the outer call executes the tasklets scheduled by the
+ * nested interrupts. A thread preempted while executing a tasklet does not
+ * prevent the other threads from executing the pending tasklets.
+ */
+void softirq_run(void);
+
+/**
+ * @brief Registers an interrupt thread for an IRQ.
+ *
+ * @details Registers an interrupt handler for the IRQ and creates a kernel
+ * thread executing the routine each time the IRQ is raised. The interrupt
+ * handler masks the IRQ, acknowledges it and wakes the thread. The IRQ is
+ * unmasked once the routine returned. Interrupts raised before the thread ran
+ * are coalesced in a single execution of the routine. The IRQ must be
+ * unmasked by the caller to start receiving interrupts.
+ *
+ * @warning The scheduler must be initialized before registering an interrupt
+ * thread.
+ *
+ * @param[in] irq_number The IRQ number to attach the thread to.
+ * @param[in] priority The priority of the interrupt thread.
+ * @param[in] routine The routine executed by the thread for each interrupt.
+ * @param[in] args The arguments given to the routine.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the routine is NULL.
+ * - OS_ERR_NO_SUCH_IRQ is returned if the IRQ number is not supported.
+ * - OS_ERR_INTERRUPT_ALREADY_REGISTERED is returned if a handler is already
+ * registered for this IRQ.
+ * - OS_ERR_MALLOC is returned if the thread data could not be allocated.
+ * - Other error codes returned by the thread creation.
+ */
+OS_RETURN_E softirq_register_irq_thread(const uint32_t irq_number,
+                                        const uint32_t priority,
+                                        void (*routine)(void* args),
+                                        void* args);
+
+#endif /* #ifndef __CORE_SOFTIRQ_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
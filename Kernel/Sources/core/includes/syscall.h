@@ -32,7 +32,10 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Number of entries in the system call submission and completion
+ * queues, must be a power of two.
+ */
+#define SYSCALL_RING_SIZE 16
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -49,7 +52,11 @@ typedef enum
     SYSCALL_SCHED_GET_PARAMS,
     SYSCALL_SCHED_SET_PARAMS,
     SYSCALL_PAGE_ALLOC,
-    /* 7 */
+    SYSCALL_FUTEX_REQUEUE,
+    SYSCALL_RING_REGISTER,
+    SYSCALL_RING_ENTER,
+    /* 10 */
+    SYSCALL_SCHED_GET_STATS,
     SYSCALL_MAX_ID
 } SYSCALL_FUNCTION_E;
 
@@ -58,8 +65,80 @@ typedef struct
 {
     /** @brief System call handler routine. */
     void(*handler)(SYSCALL_FUNCTION_E, void*);
+
+    /**
+     * @brief Tells if the system call can use the fast entry path. System
+     * calls relying on the interrupt context, such as fork, must be raised
+     * through the system call interrupt.
+     */
+    bool_t fast;
 } syscall_handler_t;
 
+/** @brief System call ring submission entry. */
+typedef struct
+{
+    /** @brief The system call to execute. */
+    SYSCALL_FUNCTION_E func;
+
+    /** @brief The system call parameters. */
+    void* params;
+
+    /** @brief Caller's data, copied in the completion entry. */
+    uint32_t user_data;
+} syscall_ring_sqe_t;
+
+/** @brief System call ring completion entry. */
+typedef struct
+{
+    /** @brief Caller's data of the completed submission entry. */
+    uint32_t user_data;
+
+    /**
+     * @brief Dispatch status. The system call own error is reported in its
+     * parameters.
+     */
+    OS_RETURN_E status;
+} syscall_ring_cqe_t;
+
+/**
+ * @brief System call ring shared between a thread and the kernel. The thread
+ * produces submission entries and consumes completion entries, the kernel
+ * does the opposite. Indexes are free running and masked on access.
+ */
+typedef struct syscall_ring
+{
+    /** @brief Next submission entry to execute, written by the kernel. */
+    volatile uint32_t sq_head;
+
+    /** @brief Next free submission entry, written by the thread. */
+    volatile uint32_t sq_tail;
+
+    /** @brief Next completion entry to read, written by the thread. */
+    volatile uint32_t cq_head;
+
+    /** @brief Next free completion entry, written by the kernel. */
+    volatile uint32_t cq_tail;
+
+    /** @brief Submission queue. */
+    volatile syscall_ring_sqe_t sq[SYSCALL_RING_SIZE];
+
+    /** @brief Completion queue. */
+    volatile syscall_ring_cqe_t cq[SYSCALL_RING_SIZE];
+} syscall_ring_t;
+
+/** @brief System call ring management parameters. */
+typedef struct
+{
+    /** @brief The ring to register, NULL unregisters the current ring. */
+    syscall_ring_t* ring;
+
+    /** @brief Receives the number of executed submission entries. */
+    uint32_t processed;
+
+    /** @brief Receives the system call error status. */
+    OS_RETURN_E error;
+} syscall_ring_params_t;
+
 
 /*******************************************************************************
  * MACROS
@@ -92,6 +171,64 @@ typedef struct
  */
 void syscall_init(void);
 
+/**
+ * @brief SYSCALL_RING_REGISTER system call handler.
+ *
+ * @details Registers the system call ring of the calling thread. Each thread
+ * owns at most one ring, registering a new ring replaces the previous one.
+ *
+ * @param[in] func The syscall function ID, must correspond to the
+ * SYSCALL_RING_REGISTER call.
+ * @param[in, out] params The ring parameters, see syscall_ring_params_t.
+ */
+void syscall_ring_register(const SYSCALL_FUNCTION_E func, void* params);
+
+/**
+ * @brief SYSCALL_RING_ENTER system call handler.
+ *
+ * @details Executes, in order, the pending submission entries of the calling
+ * thread's ring and posts a completion entry for each of them. Only the system
+ * calls allowed on the fast path can be submitted. The execution stops early
+ * when the completion queue is full, the remaining entries stay queued.
+ *
+ * @param[in] func The syscall function ID, must correspond to the
+ * SYSCALL_RING_ENTER call.
+ * @param[in, out] params The ring parameters, see syscall_ring_params_t.
+ */
+void syscall_ring_enter(const SYSCALL_FUNCTION_E func, void* params);
+
+/**
+ * @brief Tells if a system call can use the fast entry path.
+ *
+ * @details Tells if a system call can use the fast entry path. The fast path
+ * does not build an interrupt frame, system calls that need to read or copy
+ * the caller's interrupt context are only available through the system call
+ * interrupt.
+ *
+ * @param[in] func The system call ID.
+ *
+ * @return TRUE if the system call can use the fast entry path, FALSE
+ * otherwise.
+ */
+bool_t syscall_fast_allowed(const uint32_t func);
+
+/**
+ * @brief Fast system call entry point.
+ *
+ * @details Fast system call entry point. This function is called by the CPU
+ * fast system call mechanism with interrupts disabled and dispatches the
+ * request directly to the system call handler. On return, the scheduler is
+ * called if a higher priority thread was made ready by the system call and
+ * the caller had interrupts enabled.
+ *
+ * @param[in] func The system call ID.
+ * @param[in, out] params The system call parameters.
+ * @param[in] int_state The caller's interrupt state.
+ */
+void syscall_fast_handler(const uint32_t func,
+                          void* params,
+                          const uint32_t int_state);
+
 #endif /* #ifndef __CORE_SYSCALL_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
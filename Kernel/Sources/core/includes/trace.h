@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * @file trace.h
+ *
+ * @see trace.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 03/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel function tracer.
+ *
+ * @details Kernel function tracer. When the kernel is built with TRACE=TRUE,
+ * the modules listed in TRACE_MODULES are compiled with the function
+ * instrumentation hooks. Each function entry and exit is recorded as a fixed
+ * size binary event in the ring buffer of the current CPU. No formatting is
+ * done when recording, the events are decoded after the fact, on demand or
+ * when the kernel panics.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_TRACE_H_
+#define __CORE_TRACE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>       /* Generic int types */
+#include <stddef.h>       /* Standard definitions */
+#include <kernel_error.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of events kept per CPU, must be a power of two. */
+#define TRACE_RING_SIZE 2048
+
+/** @brief Number of events decoded per CPU when the kernel panics. */
+#define TRACE_PANIC_EVENTS 32
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Trace event types. */
+typedef enum
+{
+    /** @brief Function entry. */
+    TRACE_EVENT_ENTRY = 0,
+    /** @brief Function exit. */
+    TRACE_EVENT_EXIT  = 1
+} TRACE_EVENT_TYPE_E;
+
+/** @brief Trace event. */
+typedef struct
+{
+    /** @brief Timestamp of the event. */
+    uint64_t timestamp;
+
+    /** @brief Address of the traced function. */
+    uintptr_t function;
+
+    /** @brief Address the traced function was called from. */
+    uintptr_t call_site;
+
+    /** @brief Identifier of the thread running the function, -1 before the
+     * scheduler starts.
+     */
+    int32_t tid;
+
+    /** @brief Identifier of the CPU running the function. */
+    uint16_t cpu_id;
+
+    /** @brief Event type, see TRACE_EVENT_TYPE_E. */
+    uint16_t type;
+} trace_event_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Starts recording the trace events.
+ *
+ * @details Starts recording the trace events. The recording is started at
+ * boot when the kernel is built with the tracer.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the kernel is built without the
+ * tracer.
+ */
+OS_RETURN_E trace_start(void);
+
+/**
+ * @brief Stops recording the trace events.
+ *
+ * @details Stops recording the trace events, the recorded events are kept.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the kernel is built without the
+ * tracer.
+ */
+OS_RETURN_E trace_stop(void);
+
+/**
+ * @brief Clears the recorded trace events.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the kernel is built without the
+ * tracer.
+ */
+OS_RETURN_E trace_clear(void);
+
+/**
+ * @brief Returns the number of events recorded on a CPU.
+ *
+ * @param[in] cpu_id The CPU identifier.
+ * @param[out] count The buffer receiving the number of events recorded since
+ * the last clear, including the overwritten ones.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the kernel is built without the
+ * tracer.
+ * - OS_ERR_OUT_OF_BOUND is returned if the CPU identifier is not valid.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ */
+OS_RETURN_E trace_get_event_count(const uint32_t cpu_id, uint32_t* count);
+
+/**
+ * @brief Returns a recorded event.
+ *
+ * @param[in] cpu_id The CPU identifier.
+ * @param[in] index The index of the event, 0 being the most recent one.
+ * @param[out] event The buffer receiving the event.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the kernel is built without the
+ * tracer.
+ * - OS_ERR_OUT_OF_BOUND is returned if the CPU identifier is not valid or the
+ * event is not available.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ */
+OS_RETURN_E trace_get_event(const uint32_t cpu_id,
+                            const uint32_t index,
+                            trace_event_t* event);
+
+/**
+ * @brief Decodes the recorded events on the uart port.
+ *
+ * @details Stops the recording and prints the most recent events of each CPU
+ * in chronological order, with the functions resolved against the kernel
+ * symbol table and indented by call depth.
+ *
+ * @param[in] count The maximal number of events printed per CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the kernel is built without the
+ * tracer.
+ */
+OS_RETURN_E trace_dump(const uint32_t count);
+
+#endif /* #ifndef __CORE_TRACE_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * @file vdso.h
+ *
+ * @see vdso.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 29/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel shared data page.
+ *
+ * @details Kernel shared data page. The kernel publishes the running thread
+ * identity and the system time in a page visible from every process. The
+ * readers only perform memory loads, no system call is needed to get the
+ * current thread identifiers, the tick count or the uptime.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_VDSO_H_
+#define __CORE_VDSO_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>  /* Generic int types */
+#include <cpu_api.h> /* CPU API */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Kernel shared data page layout. */
+typedef struct
+{
+    /**
+     * @brief Time data update sequence. The value is odd while the kernel
+     * updates the time data.
+     */
+    volatile uint32_t sequence;
+
+    /** @brief Running thread identifier. */
+    volatile int32_t tid;
+
+    /** @brief Running thread process identifier. */
+    volatile int32_t pid;
+
+    /** @brief Running thread priority. */
+    volatile uint32_t priority;
+
+    /** @brief Number of main timer ticks since the system started. */
+    volatile uint64_t tick_count;
+
+    /** @brief Uptime in nanoseconds at the last tick. */
+    volatile uint64_t tick_uptime;
+
+    /** @brief CPU timestamp at the last tick. */
+    volatile uint64_t tick_timestamp;
+
+    /** @brief Main timer period in nanoseconds. */
+    volatile uint64_t tick_period;
+
+    /**
+     * @brief Timestamp to nanoseconds multiplier, 0 until the timestamp
+     * counter is calibrated.
+     */
+    volatile uint32_t tsc_mult;
+
+    /** @brief Timestamp to nanoseconds shift. */
+    volatile uint32_t tsc_shift;
+} vdso_data_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/** @brief Read only view of the kernel shared data page. */
+extern const vdso_data_t* const vdso_data;
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Sets the running thread identity in the shared data page.
+ *
+ * @details Sets the running thread identity in the shared data page. This
+ * function is called by the scheduler each time a thread is elected.
+ *
+ * @param[in] tid The elected thread identifier.
+ * @param[in] pid The elected thread process identifier.
+ * @param[in] priority The elected thread priority.
+ */
+void vdso_set_thread(const int32_t tid,
+                     const int32_t pid,
+                     const uint32_t priority);
+
+/**
+ * @brief Sets the running thread priority in the shared data page.
+ *
+ * @param[in] priority The running thread new priority.
+ */
+void vdso_set_priority(const uint32_t priority);
+
+/**
+ * @brief Updates the time data of the shared data page.
+ *
+ * @details Updates the time data of the shared data page. This function is
+ * called by the time manager on each main timer tick. The timestamp counter
+ * frequency is calibrated against the main timer during the first ticks.
+ *
+ * @param[in] tick_count The current tick count.
+ * @param[in] tick_period The main timer period in nanoseconds.
+ */
+void vdso_update_tick(const uint64_t tick_count, const uint64_t tick_period);
+
+/**
+ * @brief Returns the running thread identifier.
+ *
+ * @return The running thread identifier.
+ */
+inline static int32_t vdso_get_tid(void)
+{
+    return vdso_data->tid;
+}
+
+/**
+ * @brief Returns the running thread process identifier.
+ *
+ * @return The running thread process identifier.
+ */
+inline static int32_t vdso_get_pid(void)
+{
+    return vdso_data->pid;
+}
+
+/**
+ * @brief Returns the running thread priority.
+ *
+ * @return The running thread priority.
+ */
+inline static uint32_t vdso_get_priority(void)
+{
+    return vdso_data->priority;
+}
+
+/**
+ * @brief Returns the number of main timer ticks since the system started.
+ *
+ * @return The number of main timer ticks since the system started.
+ */
+inline static uint64_t vdso_get_tick_count(void)
+{
+    uint32_t sequence;
+    uint64_t tick_count;
+
+    do
+    {
+        sequence   = vdso_data->sequence;
+        tick_count = vdso_data->tick_count;
+    } while((sequence & 1) != 0 || sequence != vdso_data->sequence);
+
+    return tick_count;
+}
+
+/**
+ * @brief Returns the system uptime in nanoseconds.
+ *
+ * @details Returns the system uptime in nanoseconds. Once the timestamp
+ * counter is calibrated, the time elapsed since the last tick is added to the
+ * tick based uptime. The result never goes past the next tick.
+ *
+ * @return The system uptime in nanoseconds.
+ */
+inline static uint64_t vdso_get_uptime(void)
+{
+    uint32_t sequence;
+    uint32_t mult;
+    uint32_t shift;
+    uint64_t uptime;
+    uint64_t timestamp;
+    uint64_t period;
+    uint64_t elapsed;
+
+    do
+    {
+        sequence  = vdso_data->sequence;
+        uptime    = vdso_data->tick_uptime;
+        timestamp = vdso_data->tick_timestamp;
+        period    = vdso_data->tick_period;
+        mult      = vdso_data->tsc_mult;
+        shift     = vdso_data->tsc_shift;
+    } while((sequence & 1) != 0 || sequence != vdso_data->sequence);
+
+    if(mult == 0 || period == 0)
+    {
+        return uptime;
+    }
+
+    /* Large deltas would overflow, the tick was missed anyway */
+    elapsed = cpu_get_timestamp() - timestamp;
+    if((elapsed >> 32) != 0)
+    {
+        return uptime + period - 1;
+    }
+
+    elapsed = (elapsed * mult) >> shift;
+    if(elapsed >= period)
+    {
+        elapsed = period - 1;
+    }
+
+    return uptime + elapsed;
+}
+
+#endif /* #ifndef __CORE_VDSO_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * @file workqueue.h
+ *
+ * @see workqueue.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 31/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel workqueue.
+ *
+ * @details Kernel workqueue. Work items are executed by worker kernel threads,
+ * one worker per CPU. Work items are queued on the worker of the CPU queuing
+ * them, either immediately or after a delay, and executed in order. The
+ * workqueue allows to push expensive work off the current thread.
+ *
+ * @warning The workqueue can only be used once the scheduler is initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_WORKQUEUE_H_
+#define __CORE_WORKQUEUE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>       /* Generic int types */
+#include <stddef.h>       /* Standard definitions */
+#include <kernel_error.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Priority of the worker threads. */
+#define WORKQUEUE_WORKER_PRIORITY 10
+
+/** @brief Stack size of the worker threads. */
+#define WORKQUEUE_WORKER_STACK_SIZE 0x1000
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Work item structure. */
+typedef struct work
+{
+    /** @brief The routine executed by the worker. */
+    void (*routine)(void* args);
+
+    /** @brief The arguments given to the routine. */
+    void* args;
+
+    /** @brief Set when the work is queued and not yet executed. */
+    volatile bool_t queued;
+
+    /** @brief Uptime in nanoseconds after which a delayed work is executed. */
+    uint64_t expire_time;
+
+    /** @brief Next work in the queue. */
+    struct work* next;
+} work_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the workqueue.
+ *
+ * @details Creates one worker thread per CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the workqueue is already
+ * initialized.
+ * - OS_ERR_MALLOC is returned if the workers data could not be allocated.
+ * - Other error codes returned by the thread creation.
+ */
+OS_RETURN_E workqueue_init(void);
+
+/**
+ * @brief Initializes a work item.
+ *
+ * @details Initializes a work item with the routine to execute and its
+ * arguments. A work item must not be initialized while it is queued.
+ *
+ * @param[out] work The work item to initialize.
+ * @param[in] routine The routine executed by the worker.
+ * @param[in] args The arguments given to the routine.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the work or the routine is NULL.
+ */
+OS_RETURN_E work_init(work_t* work, void (*routine)(void* args), void* args);
+
+/**
+ * @brief Queues a work item.
+ *
+ * @details Queues a work item on the worker of the current CPU. This function
+ * can be called from an interrupt handler. Queuing a work item that is
+ * already queued has no effect. The work item can be freed by its own
+ * routine.
+ *
+ * @param[in, out] work The work item to queue.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the work is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the workqueue or the work item is
+ * not initialized.
+ */
+OS_RETURN_E workqueue_queue_work(work_t* work);
+
+/**
+ * @brief Queues a delayed work item.
+ *
+ * @details Queues a work item on the worker of the current CPU once the
+ * delay expired. The delay is checked on each main timer tick. Queuing a work
+ * item that is already queued has no effect.
+ *
+ * @param[in, out] work The work item to queue.
+ * @param[in] delay_ms The delay in milliseconds.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the work is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the workqueue or the work item is
+ * not initialized.
+ */
+OS_RETURN_E workqueue_queue_delayed_work(work_t* work, const uint32_t delay_ms);
+
+/**
+ * @brief Waits for the queued work items.
+ *
+ * @details Blocks the calling thread until all the work items queued before
+ * the call are executed. Delayed work items whose delay did not expire are
+ * not waited for.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_INITIALIZED is returned if the workqueue is not initialized.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if called by a worker thread.
+ */
+OS_RETURN_E workqueue_flush(void);
+
+/**
+ * @brief Moves the expired delayed work items to the worker queue.
+ *
+ * @details Moves the expired delayed work items of the current CPU to its
+ * worker queue and wakes the worker. This function should only be called by
+ * the main timer handler.
+ */
+void workqueue_update(void);
+
+#endif /* #ifndef __CORE_WORKQUEUE_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -54,6 +54,12 @@ typedef struct
     /** @brief Futex waiting value */
     uint32_t wait;
 
+    /**
+     * @brief The futex Id the thread is currently waiting on, updated when the
+     * thread is requeued.
+     */
+    uintptr_t futex_id;
+
     /** @brief The thread's node waiting on the futex */
     kqueue_node_t* waiting_thread;
 
@@ -67,9 +73,6 @@ typedef struct
 /** @brief Futex thread resource structure, used for cleanup. */
 typedef struct
 {
-    /** @brief The futex Id */
-    uintptr_t futex_id;
-
     /** @brief The futex data create when the futex was used. */
     futex_data_t* associated_data;
 } futex_resource_t;
@@ -183,6 +186,18 @@ static void futex_recover(futex_t* futex,
  */
 static void futex_cleanup(void* futex_resource);
 
+/**
+ * @brief Releases a thread waiting on a futex.
+ *
+ * @details Releases a thread waiting on a futex. The thread's futex resource
+ * is removed, the thread is put back in the scheduler and its wait node is
+ * removed from the futex wait queue and deleted.
+ *
+ * @param[in,out] wait_queue The wait queue that contains the node.
+ * @param[in,out] wait_node The wait node of the thread to release.
+ */
+static void futex_release_waiter(kqueue_t* wait_queue, kqueue_node_t* wait_node);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -269,7 +284,7 @@ static void futex_cleanup(void* futex_resource)
 
     /* Get the futex waiting list */
     err = uhashtable_get(futex_table,
-                         resource->futex_id,
+                         resource->associated_data->futex_id,
                          (void**)(&wait_queue));
     FUTEX_ASSERT(err == OS_NO_ERR, "Could not cleanup futex", err);
 
@@ -286,7 +301,7 @@ static void futex_cleanup(void* futex_resource)
     {
         /* Remove from the hash table */
         err = uhashtable_remove(futex_table,
-                                resource->futex_id,
+                                resource->associated_data->futex_id,
                                 NULL);
         FUTEX_ASSERT(err == OS_NO_ERR, "Could not cleanup futex", err);
 
@@ -297,6 +312,31 @@ static void futex_cleanup(void* futex_resource)
     EXIT_CRITICAL(int_state);
 }
 
+static void futex_release_waiter(kqueue_t* wait_queue, kqueue_node_t* wait_node)
+{
+    OS_RETURN_E      err;
+    futex_data_t*    data_info;
+    kernel_thread_t* thread;
+
+    data_info = (futex_data_t*)wait_node->data;
+
+    /* Remove the futex from the thread's resources */
+    thread = (kernel_thread_t*)data_info->waiting_thread->data;
+    err = sched_thread_remove_resource(thread,
+                                       &data_info->resource_node);
+    FUTEX_ASSERT(err == OS_NO_ERR, "Could not remove futex resource", err);
+
+    /* Put back the thread in the scheduler */
+    err = sched_unlock_thread(data_info->waiting_thread,
+                              THREAD_WAIT_TYPE_RESOURCE,
+                              FALSE);
+    FUTEX_ASSERT(err == OS_NO_ERR, "Unlock futex thread", err);
+
+    /* Delete the node */
+    kqueue_remove(wait_queue, wait_node, TRUE);
+    kqueue_delete_node(&wait_node);
+}
+
 void futex_init(void)
 {
     OS_RETURN_E err;
@@ -373,6 +413,7 @@ void futex_wait(const SYSCALL_FUNCTION_E func, void* params)
 
     /* Block the thread from scheduling */
     data_info.wait           = func_params->val;
+    data_info.futex_id       = futex_phys;
     data_info.owner_died     = FALSE;
     data_info.waiting_thread = sched_lock_thread(THREAD_WAIT_TYPE_RESOURCE);
 
@@ -390,7 +431,6 @@ void futex_wait(const SYSCALL_FUNCTION_E func, void* params)
 
     /* Add the resource to the thread */
     resource.associated_data = &data_info;
-    resource.futex_id        = futex_phys;
 
     err = sched_thread_add_resource(thread,
                                     &resource,
@@ -425,7 +465,6 @@ void futex_wake(const SYSCALL_FUNCTION_E func, void* params)
     uint32_t          int_state;
     size_t            i;
     recover_data_t    recover_data;
-    kernel_thread_t*  thread;
     uintptr_t         futex_phys;
 
     func_params = (futex_t*)params;
@@ -480,21 +519,7 @@ void futex_wake(const SYSCALL_FUNCTION_E func, void* params)
         save_node = wait_node;
         wait_node = wait_node->next;
 
-        /* Remove the futex from the thread's resources */
-        thread = (kernel_thread_t*)data_info->waiting_thread->data;
-        err = sched_thread_remove_resource(thread,
-                                           &data_info->resource_node);
-        FUTEX_ASSERT(err == OS_NO_ERR, "Could not remove futex resource", err);
-
-        /* Put back the thread in the scheduler */
-        err = sched_unlock_thread(data_info->waiting_thread,
-                                  THREAD_WAIT_TYPE_RESOURCE,
-                                  FALSE);
-        FUTEX_ASSERT(err == OS_NO_ERR, "Unlock futex thread", err);
-
-        /* Delete the node */
-        kqueue_remove(wait_queue, save_node, TRUE);
-        kqueue_delete_node(&save_node);
+        futex_release_waiter(wait_queue, save_node);
 
         /* If this was the last entry in the queue, delete the queue */
         if(wait_queue->size == 0)
@@ -516,4 +541,143 @@ void futex_wake(const SYSCALL_FUNCTION_E func, void* params)
     EXIT_CRITICAL(int_state);
 }
 
+void futex_requeue(const SYSCALL_FUNCTION_E func, void* params)
+{
+    OS_RETURN_E       err;
+    futex_requeue_t*  func_params;
+    kqueue_t*         wait_queue;
+    kqueue_t*         requeue_queue;
+    kqueue_node_t*    wait_node;
+    kqueue_node_t*    save_node;
+    futex_data_t*     data_info;
+    uint32_t          int_state;
+    uint32_t          woken;
+    uint32_t          requeued;
+    uintptr_t         futex_phys;
+    uintptr_t         requeue_phys;
+
+    func_params = (futex_requeue_t*)params;
+
+    FUTEX_ASSERT(func == SYSCALL_FUTEX_REQUEUE,
+                 "Wrong system call invocated", OS_ERR_INCORRECT_VALUE);
+
+    FUTEX_ASSERT(func_params != NULL,
+                 "NULL system call parameters", OS_ERR_NULL_POINTER);
+
+    FUTEX_ASSERT(is_init != FALSE,
+                 "Futex have not been initialized", OS_ERR_NOT_INITIALIZED);
+
+    /* Initialize data */
+    func_params->error = OS_NO_ERR;
+    futex_phys   = memory_get_phys_addr((uintptr_t)func_params->addr);
+    requeue_phys = memory_get_phys_addr((uintptr_t)func_params->requeue_addr);
+
+    if(futex_phys == requeue_phys)
+    {
+        func_params->error = OS_ERR_UNAUTHORIZED_ACTION;
+        return;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    /* Check if the requeue value has changed */
+    if(*func_params->requeue_addr != func_params->requeue_val)
+    {
+        func_params->error = OS_ERR_INCORRECT_VALUE;
+        EXIT_CRITICAL(int_state);
+        return;
+    }
+
+    /* Get the futex waiting list */
+    err = uhashtable_get(futex_table,
+                         futex_phys,
+                         (void**)(&wait_queue));
+    if(err != OS_NO_ERR)
+    {
+        func_params->error = err;
+        EXIT_CRITICAL(int_state);
+        return;
+    }
+
+    requeue_queue = NULL;
+    woken         = 0;
+    requeued      = 0;
+
+    /* Walk from the oldest waiter to the newest one, this keeps the relative
+     * order of the requeued threads in the new wait queue.
+     */
+    wait_node = wait_queue->tail;
+    while(wait_node != NULL &&
+          (woken < func_params->wake_count ||
+           requeued < func_params->requeue_count))
+    {
+        data_info = (futex_data_t*)wait_node->data;
+        save_node = wait_node;
+        wait_node = wait_node->prev;
+
+        /* Only consider the threads for which the value has changed */
+        if(data_info->wait == *func_params->addr)
+        {
+            continue;
+        }
+
+        if(woken < func_params->wake_count)
+        {
+            futex_release_waiter(wait_queue, save_node);
+            ++woken;
+            continue;
+        }
+
+        /* Get or create the requeue futex waiting list */
+        if(requeue_queue == NULL)
+        {
+            err = uhashtable_get(futex_table,
+                                 requeue_phys,
+                                 (void**)(&requeue_queue));
+            if(err == OS_ERR_NO_SUCH_ID)
+            {
+                requeue_queue = kqueue_create_queue();
+                err = uhashtable_set(futex_table,
+                                     requeue_phys,
+                                     requeue_queue);
+                if(err != OS_NO_ERR)
+                {
+                    kqueue_delete_queue(&requeue_queue);
+                }
+            }
+        }
+
+        if(requeue_queue == NULL)
+        {
+            /* We cannot requeue, wake the thread, it will have to wait on
+             * the requeue futex by itself.
+             */
+            futex_release_waiter(wait_queue, save_node);
+        }
+        else
+        {
+            kqueue_remove(wait_queue, save_node, TRUE);
+            data_info->wait     = func_params->requeue_val;
+            data_info->futex_id = requeue_phys;
+            kqueue_push(save_node, requeue_queue);
+        }
+        ++requeued;
+    }
+
+    /* If this was the last entry in the queue, delete the queue */
+    if(wait_queue->size == 0)
+    {
+        /* Remove from the hash table */
+        err = uhashtable_remove(futex_table,
+                                futex_phys,
+                                NULL);
+        FUTEX_ASSERT(err == OS_NO_ERR, "Could not remove futex", err);
+
+        /* Delete the queue */
+        kqueue_delete_queue(&wait_queue);
+    }
+
+    EXIT_CRITICAL(int_state);
+}
+
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -30,6 +30,7 @@
 #include <vga_text.h>      /* VGA colors */
 #include <scheduler.h>     /* Scheduler API */
 #include <cpu_api.h>       /* CPU API */
+#include <workqueue.h>     /* Kernel workqueue */
 
 /* Configuration files */
 #include <config.h>
@@ -168,6 +169,12 @@ void* init_sys(void* args)
                 sched_get_pid(),
                 sched_get_tid());
 
+    err = workqueue_init();
+    INIT_ASSERT(err == OS_NO_ERR, "Could not initialize the workqueue", err);
+
+    err = kernel_log_init();
+    INIT_ASSERT(err == OS_NO_ERR, "Could not initialize the kernel log", err);
+
     KERNEL_TEST_POINT(ustar_test);
     KERNEL_TEST_POINT(fork_test);
     KERNEL_TEST_POINT(exit_test);
@@ -177,10 +184,35 @@ void* init_sys(void* args)
     KERNEL_TEST_POINT(scheduler_load_test);
     KERNEL_TEST_POINT(scheduler_preempt_test);
     KERNEL_TEST_POINT(scheduler_sleep_test);
+    KERNEL_TEST_POINT(scheduler_wakeup_test);
     KERNEL_TEST_POINT(futex_test);
     KERNEL_TEST_POINT(spinlock_test);
     KERNEL_TEST_POINT(mutex_test);
     KERNEL_TEST_POINT(semaphore_test);
+    KERNEL_TEST_POINT(rwlock_test);
+    KERNEL_TEST_POINT(cond_test);
+    KERNEL_TEST_POINT(barrier_test);
+    KERNEL_TEST_POINT(syscall_ring_test);
+    KERNEL_TEST_POINT(vdso_test);
+    KERNEL_TEST_POINT(softirq_test);
+    KERNEL_TEST_POINT(workqueue_test);
+    KERNEL_TEST_POINT(interrupt_stats_test);
+    KERNEL_TEST_POINT(profiler_test);
+    KERNEL_TEST_POINT(trace_test);
+    KERNEL_TEST_POINT(kernel_log_test);
+    KERNEL_TEST_POINT(uart_irq_test);
+    KERNEL_TEST_POINT(event_log_test);
+    KERNEL_TEST_POINT(sched_stats_test);
+
+    KERNEL_BENCH_POINT(futex_bench);
+    KERNEL_BENCH_POINT(kheap_bench);
+    KERNEL_BENCH_POINT(context_switch_bench);
+    KERNEL_BENCH_POINT(alloc_bench);
+    KERNEL_BENCH_POINT(process_bench);
+    KERNEL_BENCH_POINT(barrier_bench);
+    KERNEL_BENCH_POINT(syscall_bench);
+    KERNEL_BENCH_POINT(interrupt_dispatch_bench);
+    KERNEL_BENCH_POINT(printf_bench);
 
     pid = fork();
 
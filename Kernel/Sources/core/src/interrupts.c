@@ -33,6 +33,8 @@
 #include <kernel_output.h>      /* Kernel output methods */
 #include <critical.h>           /* Critical sections */
 #include <scheduler.h>          /* Kernel scheduler */
+#include <softirq.h>            /* Deferred interrupt work */
+#include <bsp_api.h>            /* BSP API */
 
 /* Configuration files */
 #include <config.h>
@@ -81,6 +83,12 @@ static interrupt_driver_t interrupt_driver;
  */
 static uint32_t spurious_interrupt;
 
+/** @brief Stores the interrupt statistics of each interrupt line per CPU. */
+static interrupt_stats_t interrupt_stats[MAX_CPU_COUNT][INT_ENTRY_COUNT];
+
+/** @brief Stores the number of times the interrupt statistics were reset. */
+static uint32_t interrupt_stats_generation;
+
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
@@ -124,6 +132,23 @@ static int32_t init_driver_get_irq_int_line(const uint32_t irq_number);
  */
 static void spurious_handler(void);
 
+/**
+ * @brief Dispatches an interrupt to its handler.
+ *
+ * @details Selects the handler of the interrupt line, records the dispatch
+ * cost and the handler cost, executes the handler and reschedules if the
+ * handler woke a thread with a higher priority than the current one.
+ *
+ * @param[in, out] cpu_state The cpu registers structure.
+ * @param[in] int_id The interrupt number.
+ * @param[in, out] stack_state The stack state before the interrupt.
+ * @param[in] entry_time The timestamp taken at the dispatcher entry.
+ */
+static inline void interrupt_dispatch(cpu_state_t* cpu_state,
+                                      const uintptr_t int_id,
+                                      stack_state_t* stack_state,
+                                      const uint64_t entry_time);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -162,12 +187,85 @@ static void spurious_handler(void)
     return;
 }
 
+static inline void interrupt_dispatch(cpu_state_t* cpu_state,
+                                      const uintptr_t int_id,
+                                      stack_state_t* stack_state,
+                                      const uint64_t entry_time)
+{
+    interrupt_stats_t* stats;
+    uint64_t           schedule_count;
+    uint64_t           handler_time;
+    int32_t            cpu_id;
+    void(*handler)(cpu_state_t*, uintptr_t, stack_state_t*);
+
+    /* Select custom handlers */
+    if(kernel_interrupt_handlers[int_id].handler != NULL)
+    {
+        handler = kernel_interrupt_handlers[int_id].handler;
+    }
+    else
+    {
+        handler = panic_handler;
+    }
+
+    /* The handler might never return (context switch), account the dispatch
+     * cost before calling it.
+     */
+    cpu_id = cpu_get_id();
+    if(cpu_id < 0 || cpu_id >= MAX_CPU_COUNT)
+    {
+        cpu_id = 0;
+    }
+    stats = &interrupt_stats[cpu_id][int_id];
+    ++stats->count;
+    stats->dispatch_cycles += cpu_get_timestamp() - entry_time;
+
+    /* Execute the handler */
+    schedule_count = sched_get_schedule_count();
+    handler_time   = cpu_get_timestamp();
+
+    handler(cpu_state, int_id, stack_state);
+
+    /* When the handler switched context, we only come back here once the
+     * thread is scheduled again, the elapsed time is meaningless.
+     */
+    if(schedule_count == sched_get_schedule_count())
+    {
+        handler_time = cpu_get_timestamp() - handler_time;
+
+        ++stats->handler_count;
+        stats->handler_cycles += handler_time;
+        if(handler_time > stats->handler_max_cycles)
+        {
+            stats->handler_max_cycles = handler_time;
+        }
+    }
+
+    /* Execute the deferred work when returning to an interruptible context */
+    if(softirq_pending() == TRUE &&
+       cpu_get_saved_interrupt_state(cpu_state, stack_state) != 0)
+    {
+        softirq_run();
+    }
+
+    /* The handler might have woken a thread with a higher priority than the
+     * current one, do not wait for the next scheduler tick to run it.
+     */
+    if(sched_need_resched() == TRUE &&
+       cpu_get_saved_interrupt_state(cpu_state, stack_state) != 0)
+    {
+        sched_preempt();
+    }
+}
+
 void kernel_interrupt_handler(cpu_state_t cpu_state,
                               uintptr_t int_id,
                               stack_state_t stack_state)
 {
     kernel_thread_t* curr_thread;
-    void(*handler)(cpu_state_t*, uintptr_t, stack_state_t*);
+    uint64_t         entry_time;
+
+    entry_time = cpu_get_timestamp();
 
     /* Save the thread context if exists */
     curr_thread = sched_get_current_thread();
@@ -205,19 +303,43 @@ void kernel_interrupt_handler(cpu_state_t cpu_state,
     KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, "INTERRUPTS", "Non spurious %d",
                  int_id);
 
-    /* Select custom handlers */
-    if(int_id < INT_ENTRY_COUNT &&
-       kernel_interrupt_handlers[int_id].handler != NULL)
+    interrupt_dispatch(&cpu_state, int_id, &stack_state, entry_time);
+}
+
+void kernel_direct_interrupt_handler(cpu_state_t cpu_state,
+                                     uintptr_t int_id,
+                                     stack_state_t stack_state)
+{
+    kernel_thread_t* curr_thread;
+    uint64_t         entry_time;
+
+    entry_time = cpu_get_timestamp();
+
+    /* Save the thread context if exists */
+    curr_thread = sched_get_current_thread();
+    if(curr_thread != NULL)
     {
-        handler = kernel_interrupt_handlers[int_id].handler;
+        cpu_save_context(&cpu_state, &stack_state, curr_thread);
     }
-    else
+
+    /* Exceptions, panic and scheduler interrupts are never blocked */
+    if(int_id == SYSCALL_INT_LINE &&
+       cpu_get_saved_interrupt_state(&cpu_state, &stack_state) == 0)
     {
-        handler = panic_handler;
+        KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, "INTERRUPTS",
+                     "Blocked interrupt %u", int_id);
+        return;
     }
 
-    /* Execute the handler */
-    handler(&cpu_state, int_id, &stack_state);
+    if(int_id == PANIC_INT_LINE)
+    {
+        panic_handler(&cpu_state, int_id, &stack_state);
+    }
+
+    KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, "INTERRUPTS", "Direct int %d",
+                 int_id);
+
+    interrupt_dispatch(&cpu_state, int_id, &stack_state, entry_time);
 }
 
 void kernel_interrupt_init(void)
@@ -236,6 +358,7 @@ void kernel_interrupt_init(void)
     /* Init state */
     kernel_interrupt_disable();
     spurious_interrupt = 0;
+    memset(interrupt_stats, 0, sizeof(interrupt_stats));
 
     /* Init driver */
     interrupt_driver.driver_get_irq_int_line = init_driver_get_irq_int_line;
@@ -337,6 +460,128 @@ OS_RETURN_E kernel_interrupt_remove_int_handler(const uint32_t interrupt_line)
     return OS_NO_ERR;
 }
 
+OS_RETURN_E kernel_interrupt_get_dispatch_cost(const uint32_t interrupt_line,
+                                               uint64_t* count,
+                                               uint64_t* cycles)
+{
+    uint32_t int_state;
+    uint32_t i;
+
+    if(interrupt_line > MAX_INTERRUPT_LINE)
+    {
+        return OR_ERR_UNAUTHORIZED_INTERRUPT_LINE;
+    }
+    if(count == NULL || cycles == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    *count  = 0;
+    *cycles = 0;
+
+    ENTER_CRITICAL(int_state);
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        *count  += interrupt_stats[i][interrupt_line].count;
+        *cycles += interrupt_stats[i][interrupt_line].dispatch_cycles;
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E kernel_interrupt_get_stats(const uint32_t cpu_id,
+                                       const uint32_t interrupt_line,
+                                       interrupt_stats_t* stats)
+{
+    uint32_t int_state;
+
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+    if(interrupt_line > MAX_INTERRUPT_LINE)
+    {
+        return OR_ERR_UNAUTHORIZED_INTERRUPT_LINE;
+    }
+    if(stats == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    *stats = interrupt_stats[cpu_id][interrupt_line];
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+uint32_t kernel_interrupt_get_spurious_count(void)
+{
+    return spurious_interrupt;
+}
+
+void kernel_interrupt_reset_stats(void)
+{
+    uint32_t int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    memset(interrupt_stats, 0, sizeof(interrupt_stats));
+    spurious_interrupt = 0;
+    ++interrupt_stats_generation;
+
+    EXIT_CRITICAL(int_state);
+}
+
+uint32_t kernel_interrupt_get_stats_generation(void)
+{
+    return interrupt_stats_generation;
+}
+
+void kernel_interrupt_dump_stats(void)
+{
+    interrupt_stats_t stats;
+    uint32_t          cpu_count;
+    uint32_t          cpu_id;
+    uint32_t          i;
+
+    cpu_count = get_cpu_count();
+    if(cpu_count > MAX_CPU_COUNT)
+    {
+        cpu_count = MAX_CPU_COUNT;
+    }
+
+    kernel_printf("Interrupt statistics (spurious: %u)\n", spurious_interrupt);
+    kernel_printf("CPU | Line | Count      | Dispatch | Handler  | Max\n");
+
+    for(cpu_id = 0; cpu_id < cpu_count; ++cpu_id)
+    {
+        for(i = 0; i < INT_ENTRY_COUNT; ++i)
+        {
+            kernel_interrupt_get_stats(cpu_id, i, &stats);
+            if(stats.count == 0)
+            {
+                continue;
+            }
+
+            /* Average cycles, the handler cost is only known when the handler
+             * did not switch context.
+             */
+            kernel_printf("%3u | 0x%02x | %10llu | %8llu | %8llu | %llu\n",
+                          cpu_id, i, stats.count,
+                          stats.dispatch_cycles / stats.count,
+                          stats.handler_count == 0 ?
+                            0 : stats.handler_cycles / stats.handler_count,
+                          stats.handler_max_cycles);
+        }
+    }
+}
+
 OS_RETURN_E kernel_interrupt_register_irq_handler(const uint32_t irq_number,
                                        void(*handler)(
                                              cpu_state_t*,
@@ -358,6 +603,11 @@ OS_RETURN_E kernel_interrupt_register_irq_handler(const uint32_t irq_number,
     return kernel_interrupt_register_int_handler(int_line, handler);
 }
 
+int32_t kernel_interrupt_get_irq_int_line(const uint32_t irq_number)
+{
+    return interrupt_driver.driver_get_irq_int_line(irq_number);
+}
+
 OS_RETURN_E kernel_interrupt_remove_irq_handler(const uint32_t irq_number)
 {
     int32_t int_line;
@@ -620,4 +620,52 @@ uint32_t kheap_get_free(void)
     return mem_free;
 }
 
+uint32_t kheap_get_meta(void)
+{
+    return mem_meta;
+}
+
+uint32_t kheap_get_largest_free(void)
+{
+    list_t*      node;
+    mem_chunk_t* chunk;
+    uint32_t     largest;
+    uint32_t     size;
+    int32_t      n;
+    uint32_t     int_state;
+
+    if(init == FALSE)
+    {
+        return 0;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    /* The largest chunk is in the highest non empty size class */
+    largest = 0;
+    for(n = NUM_SIZES - 1; n >= 0 && largest == 0; --n)
+    {
+        if(free_chunk[n] == NULL)
+        {
+            continue;
+        }
+
+        node = &free_chunk[n]->free;
+        do
+        {
+            chunk = CONTAINER(mem_chunk_t, free, node);
+            size  = memory_chunk_size(chunk);
+            if(size > largest)
+            {
+                largest = size;
+            }
+            node = node->next;
+        } while(node != &free_chunk[n]->free);
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return largest;
+}
+
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * @file kstats.c
+ *
+ * @see kstats.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 06/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel phase statistics.
+ *
+ * @details Kernel phase statistics. Each CPU accounts the phases it executes
+ * in its own counters with interrupts disabled, the counters of all the CPUs
+ * are summed when read.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>   /* Generic int types */
+#include <stddef.h>   /* Standard definitions */
+#include <string.h>   /* Memory manipulation */
+#include <cpu_api.h>  /* CPU API */
+#include <critical.h> /* Critical sections */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <kstats.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+#ifdef KERNEL_STATS_ENABLED
+/** @brief Phases statistics, one set per CPU. */
+static kstats_phase_t kstats_phases[MAX_CPU_COUNT][KSTATS_PHASE_COUNT];
+#endif
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+#ifdef KERNEL_STATS_ENABLED
+
+void kstats_phase_record(const KSTATS_PHASE_E phase, const uint64_t cycles)
+{
+    kstats_phase_t* stats;
+    int32_t         cpu_id;
+    uint32_t        int_state;
+
+    if(phase >= KSTATS_PHASE_COUNT)
+    {
+        return;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    cpu_id = cpu_get_id();
+    if(cpu_id < 0 || cpu_id >= MAX_CPU_COUNT)
+    {
+        cpu_id = 0;
+    }
+
+    stats = &kstats_phases[cpu_id][phase];
+    ++stats->count;
+    stats->cycles += cycles;
+    if(cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+
+    EXIT_CRITICAL(int_state);
+}
+
+OS_RETURN_E kstats_get_phase(const KSTATS_PHASE_E phase,
+                             kstats_phase_t* stats)
+{
+    const kstats_phase_t* cpu_stats;
+    uint32_t              int_state;
+    uint32_t              i;
+
+    if(phase >= KSTATS_PHASE_COUNT)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+    if(stats == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    memset(stats, 0, sizeof(kstats_phase_t));
+
+    ENTER_CRITICAL(int_state);
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        cpu_stats = &kstats_phases[i][phase];
+
+        stats->count  += cpu_stats->count;
+        stats->cycles += cpu_stats->cycles;
+        if(cpu_stats->max > stats->max)
+        {
+            stats->max = cpu_stats->max;
+        }
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E kstats_clear(void)
+{
+    uint32_t int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    memset(kstats_phases, 0, sizeof(kstats_phases));
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+#else
+
+OS_RETURN_E kstats_get_phase(const KSTATS_PHASE_E phase,
+                             kstats_phase_t* stats)
+{
+    (void)phase;
+    (void)stats;
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+OS_RETURN_E kstats_clear(void)
+{
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+#endif
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,502 @@
+/*******************************************************************************
+ * @file profiler.c
+ *
+ * @see profiler.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 02/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel sampling profiler.
+ *
+ * @details Kernel sampling profiler. Samples are written by the sampling
+ * interrupt handler in the ring buffer of the CPU that took the interrupt, no
+ * lock is needed as interrupts are disabled in the handler. The flat profile
+ * is computed when dumped, once the profiler is stopped.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>        /* Generic int types */
+#include <stddef.h>        /* Standard definitions */
+#include <string.h>        /* Memory manipulation */
+#include <cpu_api.h>       /* CPU API */
+#include <critical.h>      /* Critical sections */
+#include <interrupts.h>    /* Interrupt manager */
+#include <scheduler.h>     /* Kernel scheduler */
+#include <panic.h>         /* Kernel symbols */
+#include <kernel_output.h> /* Kernel output methods */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <profiler.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal number of distinct symbols in the flat profile. */
+#define PROFILER_MAX_SYMBOLS 64
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Profiler sample. */
+typedef struct
+{
+    /** @brief Address of the interrupted instruction. */
+    uintptr_t pc;
+
+    /** @brief Number of return addresses in the backtrace. */
+    uint32_t depth;
+
+    /** @brief Return addresses of the interrupted call stack. */
+    uintptr_t frames[PROFILER_BACKTRACE_DEPTH];
+} profiler_sample_t;
+
+/** @brief Per CPU samples ring buffer. */
+typedef struct
+{
+    /** @brief The samples. */
+    profiler_sample_t samples[PROFILER_RING_SIZE];
+
+    /** @brief Index of the next sample to write. */
+    uint32_t head;
+
+    /** @brief Number of samples taken, including the overwritten ones. */
+    uint64_t count;
+} profiler_ring_t;
+
+/** @brief Flat profile entry. */
+typedef struct
+{
+    /** @brief Address of the symbol, 0 for unresolved addresses. */
+    uintptr_t start;
+
+    /** @brief Name of the symbol. */
+    const char* name;
+
+    /** @brief Number of samples that interrupted the symbol. */
+    uint32_t self;
+
+    /** @brief Number of samples where the symbol was on the call stack. */
+    uint32_t total;
+
+    /** @brief Last sample accounted in the total count. */
+    uint32_t last_sample;
+} profiler_symbol_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Samples ring buffers, one per CPU. */
+static profiler_ring_t profiler_rings[MAX_CPU_COUNT];
+
+/** @brief The dedicated sampling timer driver. */
+static kernel_timer_t sampling_timer = {NULL};
+
+/** @brief Frequency of the sampling timer before the profiler started. */
+static uint32_t sampling_timer_frequency;
+
+/** @brief Set while the profiler is started. */
+static volatile bool_t profiler_running = FALSE;
+
+/** @brief Set when the samples are taken by the sampling timer. */
+static bool_t profiler_use_timer;
+
+/** @brief Set when the call stack is recorded with each sample. */
+static bool_t profiler_backtrace;
+
+/** @brief Flat profile entries. */
+static profiler_symbol_t profiler_symbols[PROFILER_MAX_SYMBOLS];
+
+/** @brief Number of flat profile entries. */
+static uint32_t profiler_symbol_count;
+
+/** @brief Number of samples that did not fit in the flat profile entries. */
+static uint32_t profiler_symbol_dropped;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Records a sample of the interrupted context.
+ *
+ * @details Records the interrupted instruction address and the call stack in
+ * the ring buffer of the current CPU. Interrupts must be disabled.
+ *
+ * @param[in] cpu_state The interrupted CPU state.
+ * @param[in] stack_state The interrupted stack state.
+ */
+static void profiler_record(const cpu_state_t* cpu_state,
+                            const stack_state_t* stack_state);
+
+/**
+ * @brief Sampling timer interrupt handler.
+ *
+ * @details Records a sample and acknowledges the sampling timer interrupt.
+ *
+ * @param[in, out] cpu_state The cpu registers structure.
+ * @param[in] int_id The interrupt number.
+ * @param[in, out] stack_state The stack state before the interrupt.
+ */
+static void profiler_timer_handler(cpu_state_t* cpu_state,
+                                   uintptr_t int_id,
+                                   stack_state_t* stack_state);
+
+/**
+ * @brief Returns the flat profile entry of an address.
+ *
+ * @details Resolves the address against the kernel symbol table and returns
+ * the flat profile entry of the symbol, the entry is created if needed.
+ *
+ * @param[in] address The address to resolve.
+ *
+ * @return The flat profile entry or NULL if all the entries are used.
+ */
+static profiler_symbol_t* profiler_get_symbol(const uintptr_t address);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void profiler_record(const cpu_state_t* cpu_state,
+                            const stack_state_t* stack_state)
+{
+    profiler_ring_t*   ring;
+    profiler_sample_t* sample;
+    kernel_thread_t*   thread;
+    int32_t            cpu_id;
+
+    cpu_id = cpu_get_id();
+    if(cpu_id < 0 || cpu_id >= MAX_CPU_COUNT)
+    {
+        cpu_id = 0;
+    }
+
+    ring   = &profiler_rings[cpu_id];
+    sample = &ring->samples[ring->head];
+
+    sample->pc    = cpu_get_saved_pc(cpu_state, stack_state);
+    sample->depth = 0;
+
+    /* The frames can only be trusted when they are in the thread stacks */
+    thread = sched_get_current_thread();
+    if(profiler_backtrace == TRUE && thread != NULL)
+    {
+        sample->depth = cpu_get_saved_backtrace(cpu_state, stack_state,
+                                                sample->frames,
+                                                PROFILER_BACKTRACE_DEPTH,
+                                                thread->stack,
+                                                thread->stack +
+                                                thread->stack_size);
+        if(sample->depth == 0)
+        {
+            sample->depth = cpu_get_saved_backtrace(cpu_state, stack_state,
+                                                    sample->frames,
+                                                    PROFILER_BACKTRACE_DEPTH,
+                                                    thread->kstack,
+                                                    thread->kstack +
+                                                    thread->kstack_size);
+        }
+    }
+
+    ring->head = (ring->head + 1) % PROFILER_RING_SIZE;
+    ++ring->count;
+}
+
+static void profiler_timer_handler(cpu_state_t* cpu_state,
+                                   uintptr_t int_id,
+                                   stack_state_t* stack_state)
+{
+    (void)int_id;
+
+    if(profiler_running == TRUE)
+    {
+        profiler_record(cpu_state, stack_state);
+    }
+
+    kernel_interrupt_set_irq_eoi(sampling_timer.get_irq());
+}
+
+static profiler_symbol_t* profiler_get_symbol(const uintptr_t address)
+{
+    const char* name;
+    uintptr_t   start;
+    uint32_t    i;
+
+    name = kernel_get_symbol(address, &start);
+    if(name == NULL)
+    {
+        name  = "[NO_SYMBOL]";
+        start = 0;
+    }
+
+    for(i = 0; i < profiler_symbol_count; ++i)
+    {
+        if(profiler_symbols[i].start == start)
+        {
+            return &profiler_symbols[i];
+        }
+    }
+
+    if(profiler_symbol_count == PROFILER_MAX_SYMBOLS)
+    {
+        return NULL;
+    }
+
+    profiler_symbols[i].start       = start;
+    profiler_symbols[i].name        = name;
+    profiler_symbols[i].self        = 0;
+    profiler_symbols[i].total       = 0;
+    profiler_symbols[i].last_sample = 0;
+    ++profiler_symbol_count;
+
+    return &profiler_symbols[i];
+}
+
+OS_RETURN_E profiler_init(const kernel_timer_t* timer)
+{
+    if(timer != NULL &&
+       (timer->get_frequency == NULL ||
+        timer->set_frequency == NULL ||
+        timer->set_handler == NULL ||
+        timer->remove_handler == NULL ||
+        timer->get_irq == NULL))
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    memset(profiler_rings, 0, sizeof(profiler_rings));
+
+    if(timer != NULL)
+    {
+        sampling_timer = *timer;
+    }
+
+    KERNEL_DEBUG(PROFILER_DEBUG_ENABLED, "PROFILER",
+                 "Profiler initialized, sampling timer: %d", timer != NULL);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E profiler_start(const uint32_t frequency, const bool_t backtrace)
+{
+    OS_RETURN_E err;
+    uint32_t    int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    if(profiler_running == TRUE)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+    if(frequency != 0 && sampling_timer.set_handler == NULL)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    memset(profiler_rings, 0, sizeof(profiler_rings));
+    profiler_backtrace = backtrace;
+    profiler_use_timer = (frequency != 0);
+
+    if(profiler_use_timer == TRUE)
+    {
+        err = sampling_timer.set_handler(profiler_timer_handler);
+        if(err != OS_NO_ERR)
+        {
+            EXIT_CRITICAL(int_state);
+            return err;
+        }
+
+        sampling_timer_frequency = sampling_timer.get_frequency();
+        sampling_timer.set_frequency(frequency);
+    }
+
+    profiler_running = TRUE;
+
+    EXIT_CRITICAL(int_state);
+
+    KERNEL_DEBUG(PROFILER_DEBUG_ENABLED, "PROFILER",
+                 "Profiler started at %dHz, backtrace %d",
+                 frequency, backtrace);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E profiler_stop(void)
+{
+    OS_RETURN_E err;
+    uint32_t    int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    if(profiler_running == FALSE)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    profiler_running = FALSE;
+
+    err = OS_NO_ERR;
+    if(profiler_use_timer == TRUE)
+    {
+        sampling_timer.set_frequency(sampling_timer_frequency);
+        err = sampling_timer.remove_handler();
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    KERNEL_DEBUG(PROFILER_DEBUG_ENABLED, "PROFILER", "Profiler stopped");
+
+    return err;
+}
+
+void profiler_update(const cpu_state_t* cpu_state,
+                     const stack_state_t* stack_state)
+{
+    if(profiler_running == TRUE && profiler_use_timer == FALSE)
+    {
+        profiler_record(cpu_state, stack_state);
+    }
+}
+
+uint64_t profiler_get_sample_count(void)
+{
+    uint64_t count;
+    uint32_t int_state;
+    uint32_t i;
+
+    count = 0;
+
+    ENTER_CRITICAL(int_state);
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        count += profiler_rings[i].count;
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return count;
+}
+
+OS_RETURN_E profiler_dump(void)
+{
+    profiler_sample_t* sample;
+    profiler_symbol_t* symbol;
+    profiler_symbol_t  tmp;
+    uint32_t           kept;
+    uint32_t           sample_id;
+    uint32_t           cpu_id;
+    uint32_t           i;
+    uint32_t           j;
+
+    if(profiler_running == TRUE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    profiler_symbol_count   = 0;
+    profiler_symbol_dropped = 0;
+    sample_id               = 0;
+
+    for(cpu_id = 0; cpu_id < MAX_CPU_COUNT; ++cpu_id)
+    {
+        kept = profiler_rings[cpu_id].count < PROFILER_RING_SIZE ?
+               (uint32_t)profiler_rings[cpu_id].count : PROFILER_RING_SIZE;
+
+        for(i = 0; i < kept; ++i)
+        {
+            sample = &profiler_rings[cpu_id].samples[i];
+            ++sample_id;
+
+            symbol = profiler_get_symbol(sample->pc);
+            if(symbol == NULL)
+            {
+                ++profiler_symbol_dropped;
+                continue;
+            }
+            ++symbol->self;
+            ++symbol->total;
+            symbol->last_sample = sample_id;
+
+            /* Recursive calls are only accounted once per sample */
+            for(j = 0; j < sample->depth; ++j)
+            {
+                symbol = profiler_get_symbol(sample->frames[j]);
+                if(symbol != NULL && symbol->last_sample != sample_id)
+                {
+                    ++symbol->total;
+                    symbol->last_sample = sample_id;
+                }
+            }
+        }
+    }
+
+    /* Sort by self samples */
+    for(i = 1; i < profiler_symbol_count; ++i)
+    {
+        tmp = profiler_symbols[i];
+        j   = i;
+        while(j > 0 && profiler_symbols[j - 1].self < tmp.self)
+        {
+            profiler_symbols[j] = profiler_symbols[j - 1];
+            --j;
+        }
+        profiler_symbols[j] = tmp;
+    }
+
+    kernel_uart_printf("Flat profile: %u samples, %llu taken, %u untracked\n",
+                       sample_id, profiler_get_sample_count(),
+                       profiler_symbol_dropped);
+    if(sample_id == 0)
+    {
+        return OS_NO_ERR;
+    }
+
+    kernel_uart_printf("  self%%  total%%  samples  symbol\n");
+    for(i = 0; i < profiler_symbol_count; ++i)
+    {
+        symbol = &profiler_symbols[i];
+        kernel_uart_printf("%3u.%02u%% %3u.%02u%% %8u  %s\n",
+                           symbol->self * 100 / sample_id,
+                           symbol->self * 10000 / sample_id % 100,
+                           symbol->total * 100 / sample_id,
+                           symbol->total * 10000 / sample_id % 100,
+                           symbol->self, symbol->name);
+    }
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -41,6 +41,9 @@
 #include <init.h>               /* Init thread */
 #include <syscall.h>            /* System call manager */
 #include <kernel_error.h>       /* Kernel error codes */
+#include <vdso.h>               /* Kernel shared data page */
+#include <workqueue.h>          /* Kernel workqueue */
+#include <kstats.h>             /* Kernel phase statistics */
 
 /* Configuration files */
 #include <config.h>
@@ -89,6 +92,19 @@ typedef struct
     void (*cleanup)(void* data);
 } sched_resource_t;
 
+/** @brief Deferred process memory cleanup request. */
+typedef struct
+{
+    /** @brief The work item executing the cleanup. */
+    work_t work;
+
+    /** @brief The page directory of the cleaned process. */
+    uintptr_t page_dir;
+
+    /** @brief The free page table of the cleaned process. */
+    kqueue_t* free_page_table;
+} sched_memory_cleanup_t;
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -155,6 +171,16 @@ static kernel_process_t* active_process = NULL;
 /** @brief Count of the number of times the scheduler was called. */
 static volatile uint64_t schedule_count;
 
+/** @brief Set when a thread with a higher priority than the active thread
+ * became ready, cleared on each scheduling.
+ */
+static volatile bool_t need_resched;
+
+/** @brief Set by an explicit yield until the scheduler handles it, a ready
+ * thread leaving the CPU on a yield switched voluntarily.
+ */
+static volatile bool_t sched_yielding;
+
 /*******************************************************
  * THREAD TABLES
  * FIFO:
@@ -170,6 +196,10 @@ static kqueue_t* active_threads_table[KERNEL_LOWEST_PRIORITY + 1];
  */
 static kqueue_t* sleeping_threads_table;
 
+/** @brief Wake up latency histograms, one per priority. */
+static uint32_t wakeup_latency[KERNEL_LOWEST_PRIORITY + 1]
+                              [SCHED_LATENCY_BUCKETS];
+
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
@@ -224,6 +254,17 @@ static void sched_clean_thread_resources(kernel_thread_t* thread);
  */
 static void sched_clean_process(kernel_process_t* process);
 
+/**
+ * @brief Releases the memory of a cleaned process.
+ *
+ * @details Releases the page directory, the frames and the free page table of
+ * a cleaned process. This function is executed by the workqueue and frees the
+ * cleanup request.
+ *
+ * @param[in] args The cleanup request.
+ */
+static void sched_clean_process_memory(void* args);
+
 /**
  * @brief Copy the current thread to another kernel thread.
  *
@@ -299,6 +340,55 @@ static void schedule_int(cpu_state_t* cpu_state,
                          uintptr_t int_id,
                          stack_state_t* stack_state);
 
+/**
+ * @brief Checks if a thread that became ready should preempt the active
+ * thread.
+ *
+ * @details Checks if a thread that became ready should preempt the active
+ * thread. If the thread has a higher priority than the active thread, the
+ * rescheduling flag is set and the active thread is preempted on the next
+ * interrupt or system call exit.
+ *
+ * @param[in] thread The thread that became ready.
+ */
+static void sched_check_preempt(const kernel_thread_t* thread);
+
+/**
+ * @brief Starts the wait period of a thread that became ready.
+ *
+ * @details Starts the wait period of a thread that became ready. The wait
+ * period of a woken thread is also accounted in the wake up latency histogram
+ * of its priority when the thread is elected.
+ *
+ * @param[out] thread The thread that became ready.
+ * @param[in] woken TRUE if the thread was sleeping or waiting, FALSE if it was
+ * preempted or just created.
+ */
+static inline void sched_stats_ready(kernel_thread_t* thread,
+                                     const bool_t woken);
+
+/**
+ * @brief Accounts the time a thread ran since its last accounting.
+ *
+ * @details Accounts the time a thread ran since its last accounting to the
+ * kernel time if the thread is executing a system call, to the user time
+ * otherwise. Interrupts must be disabled.
+ *
+ * @param[out] thread The running thread.
+ * @param[in] timestamp The current CPU timestamp.
+ */
+static inline void sched_stats_run(kernel_thread_t* thread,
+                                   const uint64_t timestamp);
+
+/**
+ * @brief Accounts the wait period of the elected thread.
+ *
+ * @param[out] thread The elected thread.
+ * @param[in] timestamp The current CPU timestamp.
+ */
+static inline void sched_stats_elect(kernel_thread_t* thread,
+                                     const uint64_t timestamp);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -391,19 +481,87 @@ static void create_init(void)
                  err);
 }
 
+static void sched_check_preempt(const kernel_thread_t* thread)
+{
+    if(active_thread != NULL && thread->priority < active_thread->priority)
+    {
+        KERNEL_DEBUG(SCHED_DEBUG_ENABLED, "SCHED",
+                     "Thread %d (%d) preempts thread %d (%d)",
+                     thread->tid, thread->priority,
+                     active_thread->tid, active_thread->priority);
+
+        need_resched = TRUE;
+    }
+}
+
+static inline void sched_stats_ready(kernel_thread_t* thread,
+                                     const bool_t woken)
+{
+    thread->stats_time  = cpu_get_timestamp();
+    thread->stats_woken = woken;
+}
+
+static inline void sched_stats_run(kernel_thread_t* thread,
+                                   const uint64_t timestamp)
+{
+    if(thread->syscall_depth != 0)
+    {
+        thread->stats.kernel_time += timestamp - thread->stats_time;
+    }
+    else
+    {
+        thread->stats.user_time += timestamp - thread->stats_time;
+    }
+    thread->stats_time = timestamp;
+}
+
+static inline void sched_stats_elect(kernel_thread_t* thread,
+                                     const uint64_t timestamp)
+{
+    uint64_t latency;
+    uint32_t bucket;
+
+    latency = timestamp - thread->stats_time;
+    thread->stats.wait_time += latency;
+
+    if(thread->stats_woken == TRUE)
+    {
+        /* Bucket n holds the latencies in [2^n, 2^(n + 1)) cycles */
+        bucket = 0;
+        while(latency > 1 && bucket < SCHED_LATENCY_BUCKETS - 1)
+        {
+            latency >>= 1;
+            ++bucket;
+        }
+        ++wakeup_latency[thread->priority][bucket];
+        thread->stats_woken = FALSE;
+    }
+
+    thread->stats_time = timestamp;
+}
+
 static void select_thread(void)
 {
     kqueue_node_t*   sleeping_node;
     uint32_t         i;
     uint64_t         current_time;
     kernel_thread_t* sleeping;
+    kernel_thread_t* prev_thread;
 
     current_time = time_get_current_uptime();
 
+    /* Account the time the leaving thread ran */
+    prev_thread = active_thread;
+    sched_stats_run(prev_thread, cpu_get_timestamp());
+
+    /* We are electing the most prioritary thread */
+    need_resched = FALSE;
+
     /* If the thread was not locked, we put it in its queue */
     if(active_thread->state == THREAD_STATE_RUNNING)
     {
         active_thread->state = THREAD_STATE_READY;
+        sched_stats_ready(active_thread, FALSE);
         kqueue_push(active_thread_node,
                     active_threads_table[active_thread->priority]);
     }
@@ -437,6 +595,7 @@ static void select_thread(void)
                          sleeping->tid);
 
             sleeping->state = THREAD_STATE_READY;
+            sched_stats_ready(sleeping, TRUE);
             kqueue_push(sleeping_node,
                         active_threads_table[sleeping->priority]);
         }
@@ -467,6 +626,28 @@ static void select_thread(void)
     active_process       = active_thread->process;
     active_thread->state = THREAD_STATE_RUNNING;
 
+    sched_stats_elect(active_thread, cpu_get_timestamp());
+
+    /* A thread leaving the CPU while still ready was preempted, unless it
+     * yielded
+     */
+    if(prev_thread != active_thread)
+    {
+        if(prev_thread->state == THREAD_STATE_READY &&
+           sched_yielding == FALSE)
+        {
+            ++prev_thread->stats.involuntary_switches;
+        }
+        else
+        {
+            ++prev_thread->stats.voluntary_switches;
+        }
+    }
+    sched_yielding = FALSE;
+
+    vdso_set_thread(active_thread->tid, active_process->pid,
+                    active_thread->priority);
+
     KERNEL_DEBUG(SCHED_ELECT_DEBUG_ENABLED, "SCHED", "Elected new thread: %d",
                  active_thread->tid);
 }
@@ -511,6 +692,8 @@ void sched_init(void)
     process_count  = 0;
     thread_count   = 0;
     schedule_count = 0;
+    need_resched   = FALSE;
+    sched_yielding = FALSE;
 
     /* Init thread tables */
     for(i = 0; i < KERNEL_LOWEST_PRIORITY + 1; ++i)
@@ -550,12 +733,37 @@ void sched_init(void)
 void sched_schedule(void)
 {
     OS_RETURN_E err;
+    uint32_t    int_state;
+
+    /* The scheduler interrupt is never blocked, keep the ticks away until it
+     * consumed the yield flag
+     */
+    ENTER_CRITICAL(int_state);
+    sched_yielding = TRUE;
 
     /* Raise scheduling interrupt */
     err = cpu_raise_interrupt(SCHEDULER_SW_INT_LINE);
     SCHED_ASSERT(err == OS_NO_ERR,
                  "Could not raise schedule interrupt",
                  err);
+
+    EXIT_CRITICAL(int_state);
+}
+
+void sched_preempt(void)
+{
+    OS_RETURN_E err;
+
+    /* Raise scheduling interrupt */
+    err = cpu_raise_interrupt(SCHEDULER_SW_INT_LINE);
+    SCHED_ASSERT(err == OS_NO_ERR,
+                 "Could not raise schedule interrupt",
+                 err);
+}
+
+bool_t sched_need_resched(void)
+{
+    return need_resched;
 }
 
 OS_RETURN_E sched_sleep(const unsigned int time_ms)
@@ -593,6 +801,51 @@ uint64_t sched_get_schedule_count(void)
     return schedule_count;
 }
 
+void sched_syscall_enter(void)
+{
+    uint32_t int_state;
+
+    if(active_thread == NULL)
+    {
+        return;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    /* Close the user period before entering the kernel */
+    if(active_thread->syscall_depth == 0)
+    {
+        sched_stats_run(active_thread, cpu_get_timestamp());
+    }
+    ++active_thread->syscall_depth;
+
+    EXIT_CRITICAL(int_state);
+}
+
+void sched_syscall_exit(void)
+{
+    uint32_t int_state;
+
+    if(active_thread == NULL)
+    {
+        return;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    /* Close the kernel period before leaving the kernel */
+    if(active_thread->syscall_depth == 1)
+    {
+        sched_stats_run(active_thread, cpu_get_timestamp());
+    }
+    if(active_thread->syscall_depth != 0)
+    {
+        --active_thread->syscall_depth;
+    }
+
+    EXIT_CRITICAL(int_state);
+}
+
 /******************************************************************************
  * PROCESSES MANAGEMENT
  *****************************************************************************/
@@ -620,11 +873,29 @@ kernel_process_t* sched_get_current_process(void)
     return active_process;
 }
 
+static void sched_clean_process_memory(void* args)
+{
+    sched_memory_cleanup_t* cleanup;
+    uint32_t                int_state;
+
+    cleanup = args;
+
+    ENTER_CRITICAL(int_state);
+
+    memory_delete_free_page_table(cleanup->free_page_table);
+    memory_clean_process_memory(cleanup->page_dir);
+
+    EXIT_CRITICAL(int_state);
+
+    kfree(cleanup);
+}
+
 static void sched_clean_process(kernel_process_t* process)
 {
-    kqueue_node_t*    thread_process;
-    kernel_process_t* child_process;
-    uint32_t          int_state;
+    kqueue_node_t*          thread_process;
+    kernel_process_t*       child_process;
+    sched_memory_cleanup_t* cleanup;
+    uint32_t                int_state;
 
     ENTER_CRITICAL(int_state);
 
@@ -657,9 +928,24 @@ static void sched_clean_process(kernel_process_t* process)
 
     /* TODO Update the INIT wait process queue if needed with current wait queue*/
 
-    /* Clean page directory and frames */
-    memory_delete_free_page_table(process->free_page_table);
-    memory_clean_process_memory(process->page_dir);
+    /* Clean page directory and frames off the caller path when possible */
+    cleanup = kmalloc(sizeof(sched_memory_cleanup_t));
+    if(cleanup != NULL)
+    {
+        cleanup->page_dir        = process->page_dir;
+        cleanup->free_page_table = process->free_page_table;
+        work_init(&cleanup->work, sched_clean_process_memory, cleanup);
+        if(workqueue_queue_work(&cleanup->work) != OS_NO_ERR)
+        {
+            kfree(cleanup);
+            cleanup = NULL;
+        }
+    }
+    if(cleanup == NULL)
+    {
+        memory_delete_free_page_table(process->free_page_table);
+        memory_clean_process_memory(process->page_dir);
+    }
 
     /* Clean process structures */
     kqueue_delete_queue(&process->threads);
@@ -683,6 +969,8 @@ void sched_fork_process(const SYSCALL_FUNCTION_E func, void* new_pid)
     uint32_t          int_state;
     OS_RETURN_E       err;
 
+    KSTATS_PHASE_START(phase_start);
+
     SCHED_ASSERT(func == SYSCALL_FORK,
                  "Wrong system call invocated", OS_ERR_INCORRECT_VALUE);
 
@@ -762,8 +1050,10 @@ void sched_fork_process(const SYSCALL_FUNCTION_E func, void* new_pid)
 
     main_thread_node_th = kqueue_create_node(main_thread);
     main_thread->state = THREAD_STATE_READY;
+    sched_stats_ready(main_thread, FALSE);
     kqueue_push(main_thread_node_th,
                 active_threads_table[main_thread->priority]);
+    sched_check_preempt(main_thread);
 
     /* Update the main thread */
     new_proc->main_thread = main_thread_node;
@@ -808,6 +1098,8 @@ void sched_fork_process(const SYSCALL_FUNCTION_E func, void* new_pid)
     EXIT_CRITICAL(int_state);
 
     *(int32_t*)new_pid = new_proc->pid;
+
+    KSTATS_PHASE_END(KSTATS_PHASE_FORK, phase_start);
 }
 
 void sched_wait_process_pid(const SYSCALL_FUNCTION_E func, void* params)
@@ -880,6 +1172,9 @@ void sched_wait_process_pid(const SYSCALL_FUNCTION_E func, void* params)
                             (void**)&status,
                             &term_cause);
 
+    /* The phase starts once the child is dead, its run time is not counted */
+    KSTATS_PHASE_START(phase_start);
+
     EXIT_CRITICAL(int_state);
     if(err != OS_NO_ERR)
     {
@@ -903,6 +1198,8 @@ void sched_wait_process_pid(const SYSCALL_FUNCTION_E func, void* params)
     EXIT_CRITICAL(int_state);
 
     kqueue_delete_node(&child_node);
+
+    KSTATS_PHASE_END(KSTATS_PHASE_WAITPID, phase_start);
 }
 
 void sched_exit_process(const SYSCALL_FUNCTION_E func, void* ret_value)
@@ -914,6 +1211,8 @@ void sched_exit_process(const SYSCALL_FUNCTION_E func, void* ret_value)
     kernel_thread_t*  thread;
     kernel_thread_t*  joining_thread;
 
+    KSTATS_PHASE_START(phase_start);
+
     SCHED_ASSERT(func == SYSCALL_EXIT, "Wrong system call invocated",
                  OS_ERR_INCORRECT_VALUE);
 
@@ -972,6 +1271,7 @@ void sched_exit_process(const SYSCALL_FUNCTION_E func, void* ret_value)
                          "Woke up joining thread %d", joining_thread->tid);
 
             joining_thread->state = THREAD_STATE_READY;
+            sched_stats_ready(joining_thread, TRUE);
 
             kqueue_push(thread->joining_thread,
                         active_threads_table[joining_thread->priority]);
@@ -982,6 +1282,8 @@ void sched_exit_process(const SYSCALL_FUNCTION_E func, void* ret_value)
      */
     kqueue_delete_node(&active_thread_node);
 
+    KSTATS_PHASE_END(KSTATS_PHASE_EXIT, phase_start);
+
     /* Schedule, we should never come back from here */
     sched_schedule();
 
@@ -1028,6 +1330,7 @@ static void thread_exit(const THREAD_TERMINATE_CAUSE_E cause,
                          "Woke up joining thread %d", joining_thread->tid);
 
             joining_thread->state = THREAD_STATE_READY;
+            sched_stats_ready(joining_thread, TRUE);
 
             kqueue_push(active_thread->joining_thread,
                         active_threads_table[joining_thread->priority]);
@@ -1088,6 +1391,10 @@ static OS_RETURN_E sched_copy_kernel_thread(kernel_thread_t* dst_thread)
     dst_thread->state = THREAD_STATE_COPYING;
     dst_thread->joining_thread = NULL;
 
+    /* The copy resumes after the system call, out of the kernel */
+    memset(&dst_thread->stats, 0, sizeof(thread_stats_t));
+    dst_thread->syscall_depth = 0;
+
     /* Create a new resource queue */
     /* TODO: Maybe it will be usefull to change this and actually copy the
      * resources.
@@ -1231,7 +1538,9 @@ OS_RETURN_E sched_unlock_thread(kqueue_node_t* node,
 
     /* Unlock thread state */
     thread->state = THREAD_STATE_READY;
+    sched_stats_ready(thread, TRUE);
     kqueue_push(node, active_threads_table[thread->priority]);
+    sched_check_preempt(thread);
 
     KERNEL_DEBUG(SCHED_DEBUG_ENABLED, "SCHED",
                  "Thread %d unlocked, reason: %d\n", active_thread->tid,
@@ -1439,8 +1748,10 @@ OS_RETURN_E sched_create_kernel_thread(kernel_thread_t** thread,
 
     /* Add the thread to the main kernel process. */
     kqueue_push(new_thread_node, active_process->threads);
+    sched_stats_ready(new_thread, FALSE);
     kqueue_push(new_thread_node_table,
                 active_threads_table[new_thread->priority]);
+    sched_check_preempt(new_thread);
 
     KERNEL_DEBUG(SCHED_DEBUG_ENABLED, "SCHED", "Kernel thread created");
 
@@ -1535,7 +1846,13 @@ void sched_set_thread_params(const SYSCALL_FUNCTION_E func, void* params)
     /* Here we will set new parameters when needed */
     if(func_params->priority <= KERNEL_LOWEST_PRIORITY)
     {
+        /* A ready thread might now have a higher priority than us */
+        if(func_params->priority > active_thread->priority)
+        {
+            need_resched = TRUE;
+        }
         active_thread->priority = func_params->priority;
+        vdso_set_priority(func_params->priority);
     }
     else
     {
@@ -1543,4 +1860,66 @@ void sched_set_thread_params(const SYSCALL_FUNCTION_E func, void* params)
     }
 }
 
+void sched_get_stats(const SYSCALL_FUNCTION_E func, void* params)
+{
+    sched_stats_param_t* func_params;
+    kernel_thread_t*     thread;
+    kqueue_node_t*       node;
+    uint32_t             int_state;
+
+    func_params = (sched_stats_param_t*)params;
+
+    SCHED_ASSERT(func == SYSCALL_SCHED_GET_STATS,
+                 "Wrong system call invocated", OS_ERR_INCORRECT_VALUE);
+
+    SCHED_ASSERT(func_params != NULL,
+                 "NULL system call parameters", OS_ERR_NULL_POINTER);
+
+    if(func_params->priority > KERNEL_LOWEST_PRIORITY)
+    {
+        func_params->error = OS_ERR_FORBIDEN_PRIORITY;
+        return;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    /* Only the threads of the calling process can be queried */
+    thread = NULL;
+    if(func_params->tid == -1 || func_params->tid == active_thread->tid)
+    {
+        thread = active_thread;
+
+        /* Include the current period */
+        sched_stats_run(thread, cpu_get_timestamp());
+    }
+    else
+    {
+        node = active_process->threads->head;
+        while(node != NULL)
+        {
+            if(((kernel_thread_t*)node->data)->tid == func_params->tid)
+            {
+                thread = (kernel_thread_t*)node->data;
+                break;
+            }
+            node = node->next;
+        }
+    }
+
+    if(thread == NULL)
+    {
+        EXIT_CRITICAL(int_state);
+        func_params->error = OS_ERR_NO_SUCH_ID;
+        return;
+    }
+
+    func_params->thread_stats = thread->stats;
+    memcpy(func_params->latency, wakeup_latency[func_params->priority],
+           sizeof(func_params->latency));
+
+    EXIT_CRITICAL(int_state);
+
+    func_params->error = OS_NO_ERR;
+}
+
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,412 @@
+/*******************************************************************************
+ * @file softirq.c
+ *
+ * @see softirq.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 30/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel deferred interrupt work.
+ *
+ * @details Kernel deferred interrupt work. The pending tasklets are kept in a
+ * FIFO list protected by critical sections. The list is drained by the
+ * interrupt manager on interrupt exit. Interrupt threads block on their IRQ
+ * data and are unlocked by a generic top half registered on the IRQ line.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>             /* Generic int types */
+#include <stddef.h>             /* Standard definitions */
+#include <interrupt_settings.h> /* Interrupt settings */
+#include <interrupts.h>         /* Interrupt manager */
+#include <critical.h>           /* Critical sections */
+#include <scheduler.h>          /* Kernel scheduler */
+#include <kheap.h>              /* Kernel heap */
+#include <kernel_output.h>      /* Kernel output methods */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <softirq.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Interrupt thread data. */
+typedef struct
+{
+    /** @brief The IRQ number serviced by the thread. */
+    uint32_t irq_number;
+
+    /** @brief Number of interrupts received since the last routine call. */
+    volatile uint32_t pending;
+
+    /** @brief The thread node when the thread waits for an interrupt. */
+    kqueue_node_t* waiting_node;
+
+    /** @brief The routine executed for each interrupt. */
+    void (*routine)(void* args);
+
+    /** @brief The arguments given to the routine. */
+    void* args;
+} irq_thread_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Head of the pending tasklets queue. */
+static tasklet_t* tasklet_head = NULL;
+
+/** @brief Tail of the pending tasklets queue. */
+static tasklet_t* tasklet_tail = NULL;
+
+/** @brief Set while the pending tasklets are executed before the scheduler
+ * starts.
+ */
+static volatile bool_t softirq_boot_running = FALSE;
+
+/** @brief Interrupt threads data for each interrupt line. */
+static irq_thread_t* irq_threads[INT_ENTRY_COUNT];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Interrupt threads top half.
+ *
+ * @details Masks and acknowledges the IRQ, then wakes the interrupt thread
+ * attached to the interrupt line.
+ *
+ * @param[in, out] cpu_state The cpu registers structure.
+ * @param[in] int_id The interrupt number.
+ * @param[in, out] stack_state The stack state before the interrupt.
+ */
+static void irq_thread_handler(cpu_state_t* cpu_state,
+                               uintptr_t int_id,
+                               stack_state_t* stack_state);
+
+/**
+ * @brief Interrupt threads routine.
+ *
+ * @details Waits for the IRQ of the thread and executes the thread routine
+ * each time it is raised.
+ *
+ * @param[in] args The interrupt thread data.
+ *
+ * @return This function never returns.
+ */
+static void* irq_thread_routine(void* args);
+
+/**
+ * @brief Returns the tasklet execution flag of the current context.
+ *
+ * @details Returns the flag of the current thread, or the boot flag before
+ * the scheduler starts. A thread preempted while executing a tasklet keeps
+ * its flag set without preventing the other threads from executing the
+ * pending tasklets.
+ *
+ * @return The tasklet execution flag of the current context.
+ */
+static inline volatile bool_t* softirq_get_running(void);
+
+/**
+ * @brief Appends a tasklet to the pending queue.
+ *
+ * @details Appends a tasklet to the pending queue. This function must be
+ * called with interrupts disabled.
+ *
+ * @param[in, out] tasklet The tasklet to queue.
+ */
+static inline void tasklet_enqueue(tasklet_t* tasklet);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void irq_thread_handler(cpu_state_t* cpu_state,
+                               uintptr_t int_id,
+                               stack_state_t* stack_state)
+{
+    irq_thread_t*  irq_thread;
+    kqueue_node_t* node;
+
+    (void)cpu_state;
+    (void)stack_state;
+
+    irq_thread = irq_threads[int_id];
+
+    /* Keep the IRQ quiet until the thread serviced the device */
+    kernel_interrupt_set_irq_mask(irq_thread->irq_number, FALSE);
+    kernel_interrupt_set_irq_eoi(irq_thread->irq_number);
+
+    ++irq_thread->pending;
+
+    if(irq_thread->waiting_node != NULL)
+    {
+        node = irq_thread->waiting_node;
+        irq_thread->waiting_node = NULL;
+        sched_unlock_thread(node, THREAD_WAIT_TYPE_IO, FALSE);
+    }
+
+    KERNEL_DEBUG(SOFTIRQ_DEBUG_ENABLED, "SOFTIRQ",
+                 "IRQ %d thread woken", irq_thread->irq_number);
+}
+
+static void* irq_thread_routine(void* args)
+{
+    irq_thread_t* irq_thread;
+    uint32_t      int_state;
+
+    irq_thread = args;
+
+    while(TRUE)
+    {
+        ENTER_CRITICAL(int_state);
+
+        /* The scheduler interrupt is never blocked, we can schedule in the
+         * critical section and avoid missing a wake up.
+         */
+        while(irq_thread->pending == 0)
+        {
+            irq_thread->waiting_node = sched_lock_thread(THREAD_WAIT_TYPE_IO);
+            sched_schedule();
+        }
+        irq_thread->pending = 0;
+
+        EXIT_CRITICAL(int_state);
+
+        irq_thread->routine(irq_thread->args);
+
+        kernel_interrupt_set_irq_mask(irq_thread->irq_number, TRUE);
+    }
+
+    return NULL;
+}
+
+static inline volatile bool_t* softirq_get_running(void)
+{
+    kernel_thread_t* thread;
+
+    thread = sched_get_current_thread();
+    if(thread == NULL)
+    {
+        return &softirq_boot_running;
+    }
+
+    return &thread->softirq_running;
+}
+
+static inline void tasklet_enqueue(tasklet_t* tasklet)
+{
+    tasklet->next = NULL;
+
+    if(tasklet_tail == NULL)
+    {
+        tasklet_head = tasklet;
+    }
+    else
+    {
+        tasklet_tail->next = tasklet;
+    }
+    tasklet_tail = tasklet;
+}
+
+OS_RETURN_E tasklet_init(tasklet_t* tasklet,
+                         void (*routine)(void* args),
+                         void* args)
+{
+    if(tasklet == NULL || routine == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    tasklet->routine   = routine;
+    tasklet->args      = args;
+    tasklet->scheduled = FALSE;
+    tasklet->running   = FALSE;
+    tasklet->next      = NULL;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E tasklet_schedule(tasklet_t* tasklet)
+{
+    uint32_t int_state;
+
+    if(tasklet == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(tasklet->routine == NULL)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    if(tasklet->scheduled == FALSE)
+    {
+        tasklet->scheduled = TRUE;
+
+        /* A running tasklet is queued again by its thread once it returns */
+        if(tasklet->running == FALSE)
+        {
+            tasklet_enqueue(tasklet);
+        }
+
+        KERNEL_DEBUG(SOFTIRQ_DEBUG_ENABLED, "SOFTIRQ",
+                     "Tasklet 0x%p scheduled", tasklet);
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+bool_t softirq_pending(void)
+{
+    return tasklet_head != NULL;
+}
+
+void softirq_run(void)
+{
+    tasklet_t*       tasklet;
+    volatile bool_t* running;
+
+    running = softirq_get_running();
+    if(*running == TRUE)
+    {
+        return;
+    }
+    *running = TRUE;
+
+    while(tasklet_head != NULL)
+    {
+        /* Interrupts are disabled, we can safely dequeue */
+        tasklet      = tasklet_head;
+        tasklet_head = tasklet->next;
+        if(tasklet_head == NULL)
+        {
+            tasklet_tail = NULL;
+        }
+
+        /* The tasklet can be scheduled again from now on, but it is not
+         * queued before this execution ends.
+         */
+        tasklet->scheduled = FALSE;
+        tasklet->running   = TRUE;
+
+        kernel_interrupt_restore(1);
+        tasklet->routine(tasklet->args);
+        kernel_interrupt_disable();
+
+        tasklet->running = FALSE;
+        if(tasklet->scheduled == TRUE)
+        {
+            tasklet_enqueue(tasklet);
+        }
+    }
+
+    *running = FALSE;
+}
+
+OS_RETURN_E softirq_register_irq_thread(const uint32_t irq_number,
+                                        const uint32_t priority,
+                                        void (*routine)(void* args),
+                                        void* args)
+{
+    irq_thread_t*    irq_thread;
+    kernel_thread_t* thread;
+    int32_t          int_line;
+    OS_RETURN_E      err;
+
+    if(routine == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    int_line = kernel_interrupt_get_irq_int_line(irq_number);
+    if(int_line < 0)
+    {
+        return OS_ERR_NO_SUCH_IRQ;
+    }
+    if(irq_threads[int_line] != NULL)
+    {
+        return OS_ERR_INTERRUPT_ALREADY_REGISTERED;
+    }
+
+    irq_thread = kmalloc(sizeof(irq_thread_t));
+    if(irq_thread == NULL)
+    {
+        return OS_ERR_MALLOC;
+    }
+
+    irq_thread->irq_number   = irq_number;
+    irq_thread->pending      = 0;
+    irq_thread->waiting_node = NULL;
+    irq_thread->routine      = routine;
+    irq_thread->args         = args;
+
+    /* Interrupts raised before the thread starts are kept pending */
+    irq_threads[int_line] = irq_thread;
+    err = kernel_interrupt_register_irq_handler(irq_number, irq_thread_handler);
+    if(err != OS_NO_ERR)
+    {
+        irq_threads[int_line] = NULL;
+        kfree(irq_thread);
+        return err;
+    }
+
+    err = sched_create_kernel_thread(&thread, priority, "irq_thread",
+                                     THREAD_TYPE_KERNEL,
+                                     SOFTIRQ_THREAD_STACK_SIZE,
+                                     irq_thread_routine, irq_thread);
+    if(err != OS_NO_ERR)
+    {
+        kernel_interrupt_remove_irq_handler(irq_number);
+        irq_threads[int_line] = NULL;
+        kfree(irq_thread);
+        return err;
+    }
+
+    KERNEL_DEBUG(SOFTIRQ_DEBUG_ENABLED, "SOFTIRQ",
+                 "IRQ %d thread created with priority %d",
+                 irq_number, priority);
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
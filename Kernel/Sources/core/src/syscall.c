@@ -51,6 +51,9 @@
 
 /* None */
 
+/** @brief Mask applied to the system call ring indexes. */
+#define SYSCALL_RING_MASK (SYSCALL_RING_SIZE - 1)
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -87,14 +90,18 @@
 /************************** Static global variables ***************************/
 /** @brief Stores the handlers for each system call. */
 static syscall_handler_t kernel_interrupt_handlers[SYSCALL_MAX_ID] = {
-    {sched_fork_process},             /* SYSCALL_FORK */
-    {sched_wait_process_pid},         /* SYSCALL_WAITPID */
-    {sched_exit_process},             /* SYSCALL_EXIT */
-    {futex_wait},                     /* SYSCALL_FUTEX_WAIT */
-    {futex_wake},                     /* SYSCALL_FUTEX_WAKE */
-    {sched_get_thread_params},        /* SYSCALL_SCHED_GET_PARAMS */
-    {sched_set_thread_params},        /* SYSCALL_SCHED_SET_PARAMS */
-    {memory_alloc_page},              /* SYSCALL_PAGE_ALLOC */
+    {sched_fork_process,      FALSE}, /* SYSCALL_FORK */
+    {sched_wait_process_pid,  FALSE}, /* SYSCALL_WAITPID */
+    {sched_exit_process,      FALSE}, /* SYSCALL_EXIT */
+    {futex_wait,              TRUE},  /* SYSCALL_FUTEX_WAIT */
+    {futex_wake,              TRUE},  /* SYSCALL_FUTEX_WAKE */
+    {sched_get_thread_params, TRUE},  /* SYSCALL_SCHED_GET_PARAMS */
+    {sched_set_thread_params, TRUE},  /* SYSCALL_SCHED_SET_PARAMS */
+    {memory_alloc_page,       TRUE},  /* SYSCALL_PAGE_ALLOC */
+    {futex_requeue,           TRUE},  /* SYSCALL_FUTEX_REQUEUE */
+    {syscall_ring_register,   TRUE},  /* SYSCALL_RING_REGISTER */
+    {syscall_ring_enter,      TRUE},  /* SYSCALL_RING_ENTER */
+    {sched_get_stats,         TRUE},  /* SYSCALL_SCHED_GET_STATS */
 };
 
 /*******************************************************************************
@@ -142,7 +149,137 @@ static void syscall_handler(cpu_state_t *cpu_state,
                    "Tried to call un unknown SYSCALL",
                    OS_ERR_SYSCALL_UNKNOWN);
 
+    /* A forked thread resumes after this handler, its accounting is reset */
+    sched_syscall_enter();
     kernel_interrupt_handlers[func].handler(func, params);
+    sched_syscall_exit();
+}
+
+void syscall_ring_register(const SYSCALL_FUNCTION_E func, void* params)
+{
+    syscall_ring_params_t* func_params;
+    kernel_thread_t*       thread;
+
+    func_params = (syscall_ring_params_t*)params;
+
+    SYSCALL_ASSERT(func == SYSCALL_RING_REGISTER,
+                   "Wrong system call invocated", OS_ERR_INCORRECT_VALUE);
+
+    SYSCALL_ASSERT(func_params != NULL,
+                   "NULL system call parameters", OS_ERR_NULL_POINTER);
+
+    thread = sched_get_current_thread();
+    thread->syscall_ring = func_params->ring;
+
+    func_params->processed = 0;
+    func_params->error     = OS_NO_ERR;
+
+    KERNEL_DEBUG(SYSCALL_DEBUG_ENABLED, "SYSCALL",
+                 "Thread %d registered ring 0x%p",
+                 thread->tid, func_params->ring);
+}
+
+void syscall_ring_enter(const SYSCALL_FUNCTION_E func, void* params)
+{
+    syscall_ring_params_t*       func_params;
+    syscall_ring_t*              ring;
+    volatile syscall_ring_sqe_t* sqe;
+    volatile syscall_ring_cqe_t* cqe;
+    SYSCALL_FUNCTION_E           sqe_func;
+    void*                        sqe_params;
+
+    func_params = (syscall_ring_params_t*)params;
+
+    SYSCALL_ASSERT(func == SYSCALL_RING_ENTER,
+                   "Wrong system call invocated", OS_ERR_INCORRECT_VALUE);
+
+    SYSCALL_ASSERT(func_params != NULL,
+                   "NULL system call parameters", OS_ERR_NULL_POINTER);
+
+    func_params->processed = 0;
+
+    ring = sched_get_current_thread()->syscall_ring;
+    if(ring == NULL)
+    {
+        func_params->error = OS_ERR_NOT_INITIALIZED;
+        return;
+    }
+
+    /* Stop when the queue is empty or when no completion slot is left */
+    while(ring->sq_head != ring->sq_tail &&
+          ring->cq_tail - ring->cq_head < SYSCALL_RING_SIZE)
+    {
+        sqe = &ring->sq[ring->sq_head & SYSCALL_RING_MASK];
+        cqe = &ring->cq[ring->cq_tail & SYSCALL_RING_MASK];
+
+        sqe_func   = sqe->func;
+        sqe_params = sqe->params;
+
+        cqe->user_data = sqe->user_data;
+
+        /* Nested rings and calls needing the interrupt context are refused */
+        if(syscall_fast_allowed(sqe_func) == FALSE ||
+           sqe_func == SYSCALL_RING_REGISTER ||
+           sqe_func == SYSCALL_RING_ENTER)
+        {
+            cqe->status = OS_ERR_SYSCALL_UNKNOWN;
+        }
+        else if(sqe_params == NULL)
+        {
+            cqe->status = OS_ERR_NULL_POINTER;
+        }
+        else
+        {
+            KERNEL_DEBUG(SYSCALL_DEBUG_ENABLED, "SYSCALL",
+                         "Request ring syscall %u", sqe_func);
+
+            /* The handler might block, the entry stays owned by the kernel
+             * until the completion is posted
+             */
+            kernel_interrupt_handlers[sqe_func].handler(sqe_func, sqe_params);
+            cqe->status = OS_NO_ERR;
+        }
+
+        ++ring->sq_head;
+        ++ring->cq_tail;
+        ++func_params->processed;
+    }
+
+    func_params->error = OS_NO_ERR;
+}
+
+bool_t syscall_fast_allowed(const uint32_t func)
+{
+    if(func >= SYSCALL_MAX_ID)
+    {
+        return FALSE;
+    }
+
+    return kernel_interrupt_handlers[func].fast;
+}
+
+void syscall_fast_handler(const uint32_t func,
+                          void* params,
+                          const uint32_t int_state)
+{
+    KERNEL_DEBUG(SYSCALL_DEBUG_ENABLED, "SYSCALL",
+                 "Request fast syscall %u", func);
+
+    SYSCALL_ASSERT((func < SYSCALL_MAX_ID &&
+                    kernel_interrupt_handlers[func].handler != NULL &&
+                    kernel_interrupt_handlers[func].fast == TRUE),
+                   "Tried to call un unknown fast SYSCALL",
+                   OS_ERR_SYSCALL_UNKNOWN);
+
+    sched_syscall_enter();
+    kernel_interrupt_handlers[func].handler(func, params);
+    sched_syscall_exit();
+
+    /* Same preemption point as the interrupt exit path */
+    if(int_state != 0 && sched_need_resched() == TRUE)
+    {
+        sched_preempt();
+    }
 }
 
 void syscall_init(void)
@@ -0,0 +1,400 @@
+/*******************************************************************************
+ * @file trace.c
+ *
+ * @see trace.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 03/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel function tracer.
+ *
+ * @details Kernel function tracer. The instrumentation hooks reserve a slot
+ * in the ring buffer of the current CPU with an atomic increment, which keeps
+ * the recording lock free and safe against the interrupts raised while an
+ * event is being written. The functions called by the hooks are excluded from
+ * the instrumentation in the makefile settings.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>        /* Generic int types */
+#include <stddef.h>        /* Standard definitions */
+#include <string.h>        /* Memory manipulation */
+#include <cpu_api.h>       /* CPU API */
+#include <scheduler.h>     /* Kernel scheduler */
+#include <panic.h>         /* Kernel symbols */
+#include <kernel_output.h> /* Kernel output methods */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <trace.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal call depth shown by the indentation when decoding. */
+#define TRACE_DUMP_MAX_DEPTH 16
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Per CPU events ring buffer. */
+typedef struct
+{
+    /** @brief The events. */
+    trace_event_t events[TRACE_RING_SIZE];
+
+    /** @brief Number of slots reserved, the next slot is head modulo the ring
+     * size.
+     */
+    volatile int32_t head;
+} trace_ring_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+#ifdef KERNEL_TRACE_ENABLED
+/** @brief Events ring buffers, one per CPU. */
+static trace_ring_t trace_rings[MAX_CPU_COUNT];
+
+/** @brief Set while the events are recorded. */
+static volatile bool_t trace_enabled = TRUE;
+
+/** @brief Indentation used when decoding the events. */
+static const char trace_indent[TRACE_DUMP_MAX_DEPTH * 2 + 1] =
+    "                                ";
+#endif
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+#ifdef KERNEL_TRACE_ENABLED
+/**
+ * @brief Records a trace event.
+ *
+ * @details Reserves a slot in the ring buffer of the current CPU and writes
+ * the event in it.
+ *
+ * @param[in] function The address of the traced function.
+ * @param[in] call_site The address the function was called from.
+ * @param[in] type The event type.
+ */
+__attribute__((no_instrument_function))
+static inline void trace_record(void* function,
+                                void* call_site,
+                                const uint16_t type);
+
+/**
+ * @brief Function entry instrumentation hook.
+ *
+ * @param[in] function The address of the called function.
+ * @param[in] call_site The address the function was called from.
+ */
+__attribute__((no_instrument_function))
+void __cyg_profile_func_enter(void* function, void* call_site);
+
+/**
+ * @brief Function exit instrumentation hook.
+ *
+ * @param[in] function The address of the returning function.
+ * @param[in] call_site The address the function was called from.
+ */
+__attribute__((no_instrument_function))
+void __cyg_profile_func_exit(void* function, void* call_site);
+
+/**
+ * @brief Prints a decoded event.
+ *
+ * @param[in] event The event to print.
+ * @param[in] depth The call depth of the event.
+ */
+static void trace_print_event(const trace_event_t* event,
+                              const uint32_t depth);
+#endif
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+#ifdef KERNEL_TRACE_ENABLED
+
+__attribute__((no_instrument_function))
+static inline void trace_record(void* function,
+                                void* call_site,
+                                const uint16_t type)
+{
+    trace_event_t* event;
+    uint32_t       slot;
+    int32_t        cpu_id;
+
+    if(trace_enabled == FALSE)
+    {
+        return;
+    }
+
+    cpu_id = cpu_get_id();
+    if(cpu_id < 0 || cpu_id >= MAX_CPU_COUNT)
+    {
+        cpu_id = 0;
+    }
+
+    slot  = (uint32_t)cpu_fetch_and_add(&trace_rings[cpu_id].head, 1);
+    event = &trace_rings[cpu_id].events[slot & (TRACE_RING_SIZE - 1)];
+
+    event->timestamp = cpu_get_timestamp();
+    event->function  = (uintptr_t)function;
+    event->call_site = (uintptr_t)call_site;
+    event->tid       = sched_get_tid();
+    event->cpu_id    = (uint16_t)cpu_id;
+    event->type      = type;
+}
+
+__attribute__((no_instrument_function))
+void __cyg_profile_func_enter(void* function, void* call_site)
+{
+    trace_record(function, call_site, TRACE_EVENT_ENTRY);
+}
+
+__attribute__((no_instrument_function))
+void __cyg_profile_func_exit(void* function, void* call_site)
+{
+    trace_record(function, call_site, TRACE_EVENT_EXIT);
+}
+
+static void trace_print_event(const trace_event_t* event,
+                              const uint32_t depth)
+{
+    const char* symbol;
+    uintptr_t   start;
+    uint32_t    indent;
+
+    symbol = kernel_get_symbol(event->function, &start);
+    if(symbol == NULL)
+    {
+        symbol = "[NO_SYMBOL]";
+    }
+
+    indent = depth < TRACE_DUMP_MAX_DEPTH ? depth : TRACE_DUMP_MAX_DEPTH;
+
+    kernel_uart_printf("%llu CPU%u TID %d %s%s %s (0x%p) from 0x%p\n",
+                       event->timestamp, event->cpu_id, event->tid,
+                       &trace_indent[(TRACE_DUMP_MAX_DEPTH - indent) * 2],
+                       event->type == TRACE_EVENT_ENTRY ? "->" : "<-",
+                       symbol, event->function, event->call_site);
+}
+
+OS_RETURN_E trace_start(void)
+{
+    trace_enabled = TRUE;
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E trace_stop(void)
+{
+    trace_enabled = FALSE;
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E trace_clear(void)
+{
+    bool_t enabled;
+
+    enabled       = trace_enabled;
+    trace_enabled = FALSE;
+
+    memset(trace_rings, 0, sizeof(trace_rings));
+
+    trace_enabled = enabled;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E trace_get_event_count(const uint32_t cpu_id, uint32_t* count)
+{
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+    if(count == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    *count = (uint32_t)trace_rings[cpu_id].head;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E trace_get_event(const uint32_t cpu_id,
+                            const uint32_t index,
+                            trace_event_t* event)
+{
+    uint32_t head;
+
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+    if(event == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    head = (uint32_t)trace_rings[cpu_id].head;
+    if(index >= head || index >= TRACE_RING_SIZE)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    *event = trace_rings[cpu_id].events[(head - 1 - index) &
+                                        (TRACE_RING_SIZE - 1)];
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E trace_dump(const uint32_t count)
+{
+    const trace_event_t* event;
+    uint32_t             cursor[MAX_CPU_COUNT];
+    uint32_t             end[MAX_CPU_COUNT];
+    uint32_t             depth[MAX_CPU_COUNT];
+    uint32_t             available;
+    uint32_t             head;
+    uint32_t             next_cpu;
+    uint32_t             i;
+
+    trace_enabled = FALSE;
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        head      = (uint32_t)trace_rings[i].head;
+        available = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+        if(available > count)
+        {
+            available = count;
+        }
+
+        cursor[i] = head - available;
+        end[i]    = head;
+        depth[i]  = 0;
+    }
+
+    kernel_uart_printf("Function trace, %u events per CPU\n", count);
+
+    /* Merge the CPUs events in chronological order */
+    while(TRUE)
+    {
+        next_cpu = MAX_CPU_COUNT;
+        for(i = 0; i < MAX_CPU_COUNT; ++i)
+        {
+            if(cursor[i] == end[i])
+            {
+                continue;
+            }
+            if(next_cpu == MAX_CPU_COUNT ||
+               trace_rings[i].events[cursor[i] & (TRACE_RING_SIZE - 1)]
+                .timestamp <
+               trace_rings[next_cpu].events[cursor[next_cpu] &
+                                            (TRACE_RING_SIZE - 1)].timestamp)
+            {
+                next_cpu = i;
+            }
+        }
+        if(next_cpu == MAX_CPU_COUNT)
+        {
+            break;
+        }
+
+        event = &trace_rings[next_cpu].events[cursor[next_cpu] &
+                                              (TRACE_RING_SIZE - 1)];
+        ++cursor[next_cpu];
+
+        if(event->type == TRACE_EVENT_ENTRY)
+        {
+            trace_print_event(event, depth[next_cpu]);
+            ++depth[next_cpu];
+        }
+        else
+        {
+            if(depth[next_cpu] > 0)
+            {
+                --depth[next_cpu];
+            }
+            trace_print_event(event, depth[next_cpu]);
+        }
+    }
+
+    return OS_NO_ERR;
+}
+
+#else
+
+OS_RETURN_E trace_start(void)
+{
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+OS_RETURN_E trace_stop(void)
+{
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+OS_RETURN_E trace_clear(void)
+{
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+OS_RETURN_E trace_get_event_count(const uint32_t cpu_id, uint32_t* count)
+{
+    (void)cpu_id;
+    (void)count;
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+OS_RETURN_E trace_get_event(const uint32_t cpu_id,
+                            const uint32_t index,
+                            trace_event_t* event)
+{
+    (void)cpu_id;
+    (void)index;
+    (void)event;
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+OS_RETURN_E trace_dump(const uint32_t count)
+{
+    (void)count;
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+#endif
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * @file vdso.c
+ *
+ * @see vdso.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 29/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel shared data page.
+ *
+ * @details Kernel shared data page. The page lives in the kernel address space
+ * which is shared by every process. The kernel is the only writer, the other
+ * modules only access the page through a read only view.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>        /* Generic int types */
+#include <cpu_api.h>       /* CPU API */
+#include <kernel_output.h> /* Kernel output methods */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <vdso.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of ticks used to calibrate the timestamp counter. */
+#define VDSO_CALIBRATION_TICKS 100
+
+/** @brief Timestamp to nanoseconds conversion shift. */
+#define VDSO_TSC_SHIFT 24
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The kernel shared data page. */
+static vdso_data_t vdso_page __attribute__((aligned(4096)));
+
+/** @brief Timestamp at the calibration start. */
+static uint64_t calibration_timestamp = 0;
+
+/** @brief Tick count at the calibration start. */
+static uint64_t calibration_tick = 0;
+
+/************************* Exported global variables **************************/
+const vdso_data_t* const vdso_data = &vdso_page;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+void vdso_set_thread(const int32_t tid,
+                     const int32_t pid,
+                     const uint32_t priority)
+{
+    vdso_page.tid      = tid;
+    vdso_page.pid      = pid;
+    vdso_page.priority = priority;
+}
+
+void vdso_set_priority(const uint32_t priority)
+{
+    vdso_page.priority = priority;
+}
+
+void vdso_update_tick(const uint64_t tick_count, const uint64_t tick_period)
+{
+    uint64_t timestamp;
+    uint64_t elapsed;
+
+    timestamp = cpu_get_timestamp();
+
+    /* Readers retry while the sequence is odd */
+    ++vdso_page.sequence;
+
+    vdso_page.tick_count     = tick_count;
+    vdso_page.tick_uptime    = tick_count * tick_period;
+    vdso_page.tick_timestamp = timestamp;
+    vdso_page.tick_period    = tick_period;
+
+    if(vdso_page.tsc_mult == 0)
+    {
+        if(calibration_timestamp == 0)
+        {
+            calibration_timestamp = timestamp;
+            calibration_tick      = tick_count;
+        }
+        else if(tick_count - calibration_tick >= VDSO_CALIBRATION_TICKS)
+        {
+            elapsed = timestamp - calibration_timestamp;
+            if(elapsed != 0)
+            {
+                vdso_page.tsc_shift = VDSO_TSC_SHIFT;
+                vdso_page.tsc_mult  = (uint32_t)
+                    (((tick_period * (tick_count - calibration_tick)) <<
+                      VDSO_TSC_SHIFT) / elapsed);
+
+                KERNEL_DEBUG(VDSO_DEBUG_ENABLED, "VDSO",
+                             "TSC calibrated, multiplier %u",
+                             vdso_page.tsc_mult);
+            }
+        }
+    }
+
+    ++vdso_page.sequence;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,452 @@
+/*******************************************************************************
+ * @file workqueue.c
+ *
+ * @see workqueue.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 31/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel workqueue.
+ *
+ * @details Kernel workqueue. Each worker keeps a FIFO of ready work items and
+ * a list of delayed work items sorted by expiration time, both protected by
+ * critical sections. The main timer handler moves the expired delayed work
+ * items to the ready FIFO. Workers block when their FIFO is empty and are
+ * unlocked when a work item is queued.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>          /* Generic int types */
+#include <stddef.h>          /* Standard definitions */
+#include <string.h>          /* Memory manipulation */
+#include <cpu_api.h>         /* CPU API */
+#include <bsp_api.h>         /* BSP API */
+#include <critical.h>        /* Critical sections */
+#include <scheduler.h>       /* Kernel scheduler */
+#include <kheap.h>           /* Kernel heap */
+#include <time_management.h> /* Time manager */
+#include <kernel_output.h>   /* Kernel output methods */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <workqueue.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Worker data. */
+typedef struct
+{
+    /** @brief Head of the ready work items queue. */
+    work_t* head;
+
+    /** @brief Tail of the ready work items queue. */
+    work_t* tail;
+
+    /** @brief Delayed work items sorted by expiration time. */
+    work_t* delayed;
+
+    /** @brief The worker thread node when the worker waits for work. */
+    kqueue_node_t* waiting_node;
+
+    /** @brief The worker thread. */
+    kernel_thread_t* thread;
+} workqueue_worker_t;
+
+/** @brief Flush request data. */
+typedef struct
+{
+    /** @brief Set once the flush work item was executed. */
+    volatile bool_t done;
+
+    /** @brief The flushing thread node when it waits for the worker. */
+    kqueue_node_t* waiting_node;
+} workqueue_flush_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Workers data, one per CPU. */
+static workqueue_worker_t* workers = NULL;
+
+/** @brief Number of workers. */
+static uint32_t worker_count = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the worker of the current CPU.
+ *
+ * @return The worker of the current CPU.
+ */
+static inline workqueue_worker_t* workqueue_get_worker(void);
+
+/**
+ * @brief Adds a work item to the ready queue of a worker.
+ *
+ * @details Adds a work item to the ready queue of a worker and wakes the
+ * worker if it waits for work. Interrupts must be disabled.
+ *
+ * @param[in, out] worker The worker to queue the work item on.
+ * @param[in, out] work The work item to queue.
+ */
+static void workqueue_push(workqueue_worker_t* worker, work_t* work);
+
+/**
+ * @brief Worker threads routine.
+ *
+ * @details Executes the ready work items of the worker in order and waits
+ * when the queue is empty.
+ *
+ * @param[in] args The worker data.
+ *
+ * @return This function never returns.
+ */
+static void* workqueue_worker_routine(void* args);
+
+/**
+ * @brief Flush work item routine.
+ *
+ * @details Marks the flush request done and wakes the flushing thread.
+ *
+ * @param[in] args The flush request data.
+ */
+static void workqueue_flush_routine(void* args);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static inline workqueue_worker_t* workqueue_get_worker(void)
+{
+    int32_t cpu_id;
+
+    cpu_id = cpu_get_id();
+    if(cpu_id < 0 || (uint32_t)cpu_id >= worker_count)
+    {
+        cpu_id = 0;
+    }
+
+    return &workers[cpu_id];
+}
+
+static void workqueue_push(workqueue_worker_t* worker, work_t* work)
+{
+    kqueue_node_t* node;
+
+    work->next = NULL;
+    if(worker->tail == NULL)
+    {
+        worker->head = work;
+    }
+    else
+    {
+        worker->tail->next = work;
+    }
+    worker->tail = work;
+
+    if(worker->waiting_node != NULL)
+    {
+        node = worker->waiting_node;
+        worker->waiting_node = NULL;
+        sched_unlock_thread(node, THREAD_WAIT_TYPE_IO, FALSE);
+    }
+}
+
+static void* workqueue_worker_routine(void* args)
+{
+    workqueue_worker_t* worker;
+    work_t*             work;
+    uint32_t            int_state;
+
+    worker = args;
+
+    while(TRUE)
+    {
+        ENTER_CRITICAL(int_state);
+
+        /* The scheduler interrupt is never blocked, we can schedule in the
+         * critical section and avoid missing a wake up.
+         */
+        while(worker->head == NULL)
+        {
+            worker->waiting_node = sched_lock_thread(THREAD_WAIT_TYPE_IO);
+            sched_schedule();
+        }
+
+        work         = worker->head;
+        worker->head = work->next;
+        if(worker->head == NULL)
+        {
+            worker->tail = NULL;
+        }
+
+        /* The work can be queued again from now on */
+        work->queued = FALSE;
+
+        EXIT_CRITICAL(int_state);
+
+        KERNEL_DEBUG(WORKQUEUE_DEBUG_ENABLED, "WORKQUEUE",
+                     "Executing work 0x%p", work);
+
+        /* The routine might free the work, do not use it afterwards */
+        work->routine(work->args);
+    }
+
+    return NULL;
+}
+
+static void workqueue_flush_routine(void* args)
+{
+    workqueue_flush_t* flush;
+    kqueue_node_t*     node;
+    uint32_t           int_state;
+
+    flush = args;
+
+    ENTER_CRITICAL(int_state);
+
+    flush->done = TRUE;
+    if(flush->waiting_node != NULL)
+    {
+        node = flush->waiting_node;
+        flush->waiting_node = NULL;
+        sched_unlock_thread(node, THREAD_WAIT_TYPE_IO, FALSE);
+    }
+
+    EXIT_CRITICAL(int_state);
+}
+
+OS_RETURN_E workqueue_init(void)
+{
+    OS_RETURN_E err;
+    uint32_t    count;
+    uint32_t    i;
+
+    if(workers != NULL)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    count = get_cpu_count();
+
+    workers = kmalloc(sizeof(workqueue_worker_t) * count);
+    if(workers == NULL)
+    {
+        return OS_ERR_MALLOC;
+    }
+    memset(workers, 0, sizeof(workqueue_worker_t) * count);
+    worker_count = count;
+
+    for(i = 0; i < count; ++i)
+    {
+        err = sched_create_kernel_thread(&workers[i].thread,
+                                         WORKQUEUE_WORKER_PRIORITY,
+                                         "worker",
+                                         THREAD_TYPE_KERNEL,
+                                         WORKQUEUE_WORKER_STACK_SIZE,
+                                         workqueue_worker_routine,
+                                         &workers[i]);
+        if(err != OS_NO_ERR)
+        {
+            /* Keep the workers already created, they can still be used */
+            worker_count = i;
+            if(i == 0)
+            {
+                kfree(workers);
+                workers = NULL;
+            }
+            return err;
+        }
+    }
+
+    KERNEL_DEBUG(WORKQUEUE_DEBUG_ENABLED, "WORKQUEUE",
+                 "Workqueue initialized with %d workers", count);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E work_init(work_t* work, void (*routine)(void* args), void* args)
+{
+    if(work == NULL || routine == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    work->routine     = routine;
+    work->args        = args;
+    work->queued      = FALSE;
+    work->expire_time = 0;
+    work->next        = NULL;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E workqueue_queue_work(work_t* work)
+{
+    return workqueue_queue_delayed_work(work, 0);
+}
+
+OS_RETURN_E workqueue_queue_delayed_work(work_t* work, const uint32_t delay_ms)
+{
+    workqueue_worker_t* worker;
+    work_t**            cursor;
+    uint32_t            int_state;
+
+    if(work == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(workers == NULL || work->routine == NULL)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    if(work->queued == TRUE)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_NO_ERR;
+    }
+    work->queued = TRUE;
+
+    worker = workqueue_get_worker();
+
+    if(delay_ms == 0)
+    {
+        workqueue_push(worker, work);
+    }
+    else
+    {
+        work->expire_time = time_get_current_uptime() +
+                            (uint64_t)delay_ms * 1000000ULL;
+
+        /* Keep the delayed list sorted, equal times keep the queuing order */
+        cursor = &worker->delayed;
+        while(*cursor != NULL && (*cursor)->expire_time <= work->expire_time)
+        {
+            cursor = &(*cursor)->next;
+        }
+        work->next = *cursor;
+        *cursor    = work;
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    KERNEL_DEBUG(WORKQUEUE_DEBUG_ENABLED, "WORKQUEUE",
+                 "Work 0x%p queued, delay %dms", work, delay_ms);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E workqueue_flush(void)
+{
+    workqueue_flush_t flush;
+    kernel_thread_t*  current;
+    work_t            work;
+    uint32_t          int_state;
+    uint32_t          i;
+
+    if(workers == NULL)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    /* A worker cannot wait for itself */
+    current = sched_get_current_thread();
+    for(i = 0; i < worker_count; ++i)
+    {
+        if(workers[i].thread == current)
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+    }
+
+    work_init(&work, workqueue_flush_routine, &flush);
+
+    for(i = 0; i < worker_count; ++i)
+    {
+        flush.done         = FALSE;
+        flush.waiting_node = NULL;
+
+        ENTER_CRITICAL(int_state);
+
+        work.queued = TRUE;
+        workqueue_push(&workers[i], &work);
+
+        while(flush.done == FALSE)
+        {
+            flush.waiting_node = sched_lock_thread(THREAD_WAIT_TYPE_IO);
+            sched_schedule();
+        }
+
+        EXIT_CRITICAL(int_state);
+    }
+
+    return OS_NO_ERR;
+}
+
+void workqueue_update(void)
+{
+    workqueue_worker_t* worker;
+    work_t*             work;
+    uint64_t            current_time;
+
+    if(workers == NULL)
+    {
+        return;
+    }
+
+    worker = workqueue_get_worker();
+    if(worker->delayed == NULL)
+    {
+        return;
+    }
+
+    current_time = time_get_current_uptime();
+    while(worker->delayed != NULL &&
+          worker->delayed->expire_time <= current_time)
+    {
+        work            = worker->delayed;
+        worker->delayed = work->next;
+        workqueue_push(worker, work);
+    }
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -30,6 +30,33 @@ ifeq ($(TESTS), TRUE)
 CFLAGS += $(TESTS_FLAGS)
 endif
 
+# Function tracing, the modules listed in TRACE_MODULES are instrumented. The
+# functions used by the tracer hooks must not be instrumented.
+TRACE_MODULES = core time
+TRACE_EXCLUDED_FILES = preboot.c,trace.c
+TRACE_EXCLUDED_FUNCS = cpu_get_id,lapic_get_id,cpu_fetch_and_add,cpu_get_timestamp
+TRACE_EXCLUDED_FUNCS := $(TRACE_EXCLUDED_FUNCS),sched_get_tid
+TRACE_FLAGS = -finstrument-functions \
+              -finstrument-functions-exclude-file-list=$(TRACE_EXCLUDED_FILES) \
+              -finstrument-functions-exclude-function-list=$(TRACE_EXCLUDED_FUNCS)
+
+ifeq ($(TRACE), TRUE)
+CFLAGS += -DKERNEL_TRACE_ENABLED
+ifneq ($(filter $(notdir $(CURDIR)), $(TRACE_MODULES)),)
+CFLAGS += $(TRACE_FLAGS)
+endif
+endif
+
+# Binary event log, the debug messages are decoded on the host
+ifeq ($(EVENT_LOG), TRUE)
+CFLAGS += -DKERNEL_EVENT_LOG_ENABLED
+endif
+
+# Phase statistics, the process management phases are measured in cycles
+ifeq ($(STATS), TRUE)
+CFLAGS += -DKERNEL_STATS_ENABLED
+endif
+
 ifeq ($(DEBUG), TRUE)
 CFLAGS += $(DEBUG_FLAGS)
 else
@@ -0,0 +1,213 @@
+/*******************************************************************************
+ * @file event_log.h
+ *
+ * @see event_log.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 04/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel binary event log.
+ *
+ * @details Kernel binary event log. When the kernel is compiled with
+ * EVENT_LOG=TRUE, the debug messages are not formatted by the kernel. Each
+ * call site gets a descriptor holding its module, format string, file and line
+ * in the .kevent_desc and .kevent_str ELF sections, which are not loaded in
+ * memory. At runtime, only the descriptor offset in the section, a timestamp
+ * and the raw arguments are stored in a per CPU ring. The rings are written to
+ * the serial port as hexadecimal words by the kernel log drainer and decoded
+ * on the host with the kernel ELF file.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __IO_EVENT_LOG_H_
+#define __IO_EVENT_LOG_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>       /* Generic int types */
+#include <kernel_error.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size in 32 bits words of the event ring of each CPU, must be a power
+ * of two.
+ */
+#define EVENT_LOG_RING_SIZE 0x2000
+
+/** @brief Number of 32 bits words in an event record header. */
+#define EVENT_LOG_HEADER_SIZE 4
+
+/** @brief Prefix of the event lines written to the serial port. */
+#define EVENT_LOG_LINE_TAG "#EVT"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Event call site descriptor, stored in the .kevent_desc section. */
+typedef struct
+{
+    /** @brief The module name. */
+    const char* module;
+
+    /** @brief The format string. */
+    const char* format;
+
+    /** @brief The source file name. */
+    const char* file;
+
+    /** @brief The source line. */
+    uint32_t line;
+
+    /** @brief Size in bytes of the arguments on the stack. */
+    uint32_t args_size;
+} event_log_desc_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Size of an argument once pushed on the stack.
+ *
+ * @param[in] ARG The argument.
+ */
+#define EVENT_LOG_ARG_SIZE(ARG) ((sizeof(ARG) + 3) & ~3U)
+
+/** @cond */
+#define EVENT_LOG_SIZE_0(...) 0
+#define EVENT_LOG_SIZE_1(A) EVENT_LOG_ARG_SIZE(A)
+#define EVENT_LOG_SIZE_2(A, ...) \
+    (EVENT_LOG_ARG_SIZE(A) + EVENT_LOG_SIZE_1(__VA_ARGS__))
+#define EVENT_LOG_SIZE_3(A, ...) \
+    (EVENT_LOG_ARG_SIZE(A) + EVENT_LOG_SIZE_2(__VA_ARGS__))
+#define EVENT_LOG_SIZE_4(A, ...) \
+    (EVENT_LOG_ARG_SIZE(A) + EVENT_LOG_SIZE_3(__VA_ARGS__))
+#define EVENT_LOG_SIZE_5(A, ...) \
+    (EVENT_LOG_ARG_SIZE(A) + EVENT_LOG_SIZE_4(__VA_ARGS__))
+#define EVENT_LOG_SIZE_6(A, ...) \
+    (EVENT_LOG_ARG_SIZE(A) + EVENT_LOG_SIZE_5(__VA_ARGS__))
+#define EVENT_LOG_SIZE_7(A, ...) \
+    (EVENT_LOG_ARG_SIZE(A) + EVENT_LOG_SIZE_6(__VA_ARGS__))
+#define EVENT_LOG_SIZE_8(A, ...) \
+    (EVENT_LOG_ARG_SIZE(A) + EVENT_LOG_SIZE_7(__VA_ARGS__))
+#define EVENT_LOG_SELECT(_0, _1, _2, _3, _4, _5, _6, _7, _8, NAME, ...) NAME
+/** @endcond */
+
+/**
+ * @brief Size of the arguments once pushed on the stack, computed at compile
+ * time. Up to 8 arguments are supported.
+ *
+ * @param[in] DUMMY Unused, allows to call the macro without arguments.
+ * @param[in] ... The arguments.
+ */
+#define EVENT_LOG_ARGS_SIZE(DUMMY, ...)                                        \
+    EVENT_LOG_SELECT(DUMMY, ##__VA_ARGS__,                                     \
+                     EVENT_LOG_SIZE_8, EVENT_LOG_SIZE_7, EVENT_LOG_SIZE_6,     \
+                     EVENT_LOG_SIZE_5, EVENT_LOG_SIZE_4, EVENT_LOG_SIZE_3,     \
+                     EVENT_LOG_SIZE_2, EVENT_LOG_SIZE_1,                       \
+                     EVENT_LOG_SIZE_0)(__VA_ARGS__)
+
+/**
+ * @brief Logs a binary event. The strings and the descriptor are only stored
+ * in the ELF file, the descriptor address is the event identifier and is
+ * never dereferenced by the kernel.
+ *
+ * @param[in] MODULE The module name.
+ * @param[in] STR The format string, must be a literal.
+ * @param[in] ... The format string arguments.
+ */
+#define EVENT_LOG(MODULE, STR, ...) {                                          \
+    static const char __event_module[]                                         \
+        __attribute__((section(".kevent_str"))) = MODULE;                      \
+    static const char __event_format[]                                         \
+        __attribute__((section(".kevent_str"))) = STR;                         \
+    static const char __event_file[]                                           \
+        __attribute__((section(".kevent_str"))) = __FILE__;                    \
+    static const event_log_desc_t __event_desc                                 \
+        __attribute__((section(".kevent_desc"))) = {                           \
+        __event_module, __event_format, __event_file, __LINE__,                \
+        EVENT_LOG_ARGS_SIZE(0, ##__VA_ARGS__)                                  \
+    };                                                                         \
+    event_log_write(&__event_desc, EVENT_LOG_ARGS_SIZE(0, ##__VA_ARGS__),     \
+                    ##__VA_ARGS__);                                            \
+}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Stores an event in the ring of the current CPU.
+ *
+ * @details Stores the descriptor offset, the timestamp and the raw stack words
+ * of the arguments in the event ring of the current CPU. The event is dropped
+ * if the ring is full. When the kernel log is synchronous, the event is
+ * written to the serial port right away. This function should only be called
+ * through the EVENT_LOG macro.
+ *
+ * @warning The descriptor section is not loaded, the descriptor is only used
+ * as the event identifier.
+ *
+ * @param[in] desc The call site descriptor offset.
+ * @param[in] args_size The size in bytes of the arguments on the stack.
+ * @param[in] ... The format string arguments.
+ */
+void event_log_write(const event_log_desc_t* desc,
+                     const uint32_t args_size, ...);
+
+/**
+ * @brief Writes the pending events to the serial port.
+ *
+ * @details Writes the pending events of all the CPUs to the serial port, one
+ * line of hexadecimal words per event, and releases them. This function is not
+ * reentrant, it is called by the kernel log drainer.
+ */
+void event_log_flush(void);
+
+/**
+ * @brief Returns the number of events dropped since boot.
+ *
+ * @return The number of events dropped because an event ring was full.
+ */
+uint32_t event_log_get_dropped(void);
+
+/**
+ * @brief Copies the last event recorded by the current CPU.
+ *
+ * @details Copies the words of the last event recorded by the current CPU,
+ * even if it was already written to the serial port. The record is only
+ * valid until the ring wraps.
+ *
+ * @param[out] buffer The buffer receiving the record words.
+ * @param[in] size The size of the buffer in words.
+ *
+ * @return The number of words copied, 0 if no event was recorded or if the
+ * buffer is too small.
+ */
+uint32_t event_log_get_last(uint32_t* buffer, const uint32_t size);
+
+#endif /* #ifndef __IO_EVENT_LOG_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -15,6 +15,9 @@
  * really basic output too allow early kernel boot output and debug. These
  * functions can be used in interrupts handlers since no lock is required to use
  * them. This also makes them non thread safe.
+ * Once the log is initialized, messages are formatted in a per CPU log ring
+ * without waiting for the output device and written to the output by a low
+ * priority kernel thread.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -26,7 +29,10 @@
  * INCLUDES
  ******************************************************************************/
 
-/* None */
+#include <stdint.h>       /* Generic int types */
+#include <stddef.h>       /* Standard definitions */
+#include <kernel_error.h> /* Kernel error codes */
+#include <event_log.h>    /* Binary event log */
 
 /*******************************************************************************
  * CONSTANTS
@@ -60,6 +66,14 @@
 #endif
 
 #if KERNEL_LOG_LEVEL >= DEBUG_LOG_LEVEL
+#ifdef KERNEL_EVENT_LOG_ENABLED
+#define KERNEL_DEBUG(ENABLED, MODULE, STR, ...) {                              \
+    if(ENABLED)                                                                \
+    {                                                                          \
+        EVENT_LOG(MODULE, STR, ##__VA_ARGS__);                                 \
+    }                                                                          \
+}
+#else
 #define KERNEL_DEBUG(ENABLED, MODULE, STR, ...) {                              \
     if(ENABLED)                                                                \
     {                                                                          \
@@ -67,6 +81,7 @@
                           ##__VA_ARGS__, __LINE__);                            \
     }                                                                          \
 }
+#endif
 #else
 #define KERNEL_DEBUG(...)
 #endif
@@ -146,6 +161,17 @@ void kernel_info(const char *fmt, ...);
  */
 void kernel_uart_debug(const char *fmt, ...);
 
+/**
+ * @brief Prints the desired string to the uart port.
+ *
+ * @details Prints the desired string to the uart port without any tag. The
+ * screen is not updated.
+ *
+ * @param[in] fmt The format string to output.
+ * @param[in] ... format's parameters.
+ */
+void kernel_uart_printf(const char *fmt, ...);
+
 /**
  * @brief Prints a string to the screen attached to the arguments list.
  *
@@ -160,6 +186,94 @@ void kernel_uart_debug(const char *fmt, ...);
  */
 void kernel_doprint(const char* str, __builtin_va_list args);
 
+/**
+ * @brief Formats a string in a buffer attached to the arguments list.
+ *
+ * @details Formats the string in the buffer with the same format as the
+ * kernel output functions. At most size - 1 characters are written and the
+ * buffer is always NULL terminated when size is not 0.
+ *
+ * @param[out] buffer The buffer receiving the formatted string.
+ * @param[in] size The size of the buffer.
+ * @param[in] fmt The format string.
+ * @param[in] args The arguments list.
+ *
+ * @return The length of the formatted string without truncation, or -1 if
+ * the format string is NULL or the buffer is NULL with a non null size.
+ */
+int32_t kernel_vsnprintf(char* buffer,
+                         const size_t size,
+                         const char* fmt,
+                         __builtin_va_list args);
+
+/**
+ * @brief Formats a string in a buffer.
+ *
+ * @details Formats the string in the buffer with the same format as the
+ * kernel output functions. At most size - 1 characters are written and the
+ * buffer is always NULL terminated when size is not 0.
+ *
+ * @param[out] buffer The buffer receiving the formatted string.
+ * @param[in] size The size of the buffer.
+ * @param[in] fmt The format string.
+ * @param[in] ... format's parameters.
+ *
+ * @return The length of the formatted string without truncation, or -1 if
+ * the format string is NULL or the buffer is NULL with a non null size.
+ */
+int32_t kernel_snprintf(char* buffer, const size_t size, const char* fmt, ...);
+
+/**
+ * @brief Initializes the asynchronous kernel log.
+ *
+ * @details Creates the log drain thread. Once this function returns, the
+ * kernel_printf, kernel_error, kernel_success, kernel_info, kernel_uart_debug
+ * and kernel_doprint messages are formatted in the log ring of the current CPU
+ * and written to the output by the drain thread. A message is dropped if the
+ * ring is full, threads drain the rings themselves when they fill up.
+ *
+ * @warning The scheduler must be initialized before calling this function.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the log is already initialized.
+ * - Other error codes returned by the thread creation.
+ */
+OS_RETURN_E kernel_log_init(void);
+
+/**
+ * @brief Writes the pending log messages to the output.
+ *
+ * @details Writes the pending log messages of all the CPUs to the output. The
+ * function waits for the thread draining the log, if any, so the messages are
+ * always written in order.
+ */
+void kernel_log_flush(void);
+
+/**
+ * @brief Switches the kernel log to synchronous output.
+ *
+ * @details Writes the pending log messages to the output, even if a drainer
+ * was interrupted, and prints the following messages directly. The serial
+ * output is also switched back to polled output. This function is used when
+ * the drain thread will not run anymore, for instance on panic.
+ */
+void kernel_log_sync(void);
+
+/**
+ * @brief Returns the number of log messages dropped since boot.
+ *
+ * @return The number of messages dropped because a log ring was full.
+ */
+uint32_t kernel_log_get_dropped(void);
+
+/**
+ * @brief Tells if the log messages are written by the drain thread.
+ *
+ * @return TRUE if the kernel log is asynchronous, FALSE otherwise.
+ */
+bool_t kernel_log_is_async(void);
+
 #endif /* #ifndef __IO_KERNEL_OUTPUT_H_ */
 
 /************************************ EOF *************************************/
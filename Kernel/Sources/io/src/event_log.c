@@ -0,0 +1,310 @@
+/*******************************************************************************
+ * @file event_log.c
+ *
+ * @see event_log.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 04/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel binary event log.
+ *
+ * @details Kernel binary event log. Each CPU owns a ring of 32 bits words.
+ * Records are written with interrupts disabled by the CPU owning the ring and
+ * published by advancing the ring head. The drainer releases them by advancing
+ * the ring tail. A record is made of the descriptor offset, the CPU
+ * identifier and the arguments size in words, the 64 bits timestamp and the
+ * raw arguments stack words.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>        /* Generic int types */
+#include <stddef.h>        /* Standard definitions */
+#include <string.h>        /* Memory manipulation */
+#include <cpu_api.h>       /* CPU API */
+#include <critical.h>      /* Critical sections */
+#include <uart.h>          /* UART driver */
+#include <kernel_output.h> /* Kernel output methods */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <event_log.h>
+
+#ifdef KERNEL_EVENT_LOG_ENABLED
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal number of argument words in a record. */
+#define EVENT_LOG_MAX_ARGS 16
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Per CPU event ring. */
+typedef struct
+{
+    /** @brief The records storage. */
+    uint32_t buffer[EVENT_LOG_RING_SIZE];
+
+    /** @brief Words written by the CPU owning the ring. */
+    volatile uint32_t head;
+
+    /** @brief Words released by the drainer. */
+    volatile uint32_t tail;
+
+    /** @brief Start of the last record written. */
+    volatile uint32_t last;
+} event_ring_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Event rings, one per CPU. */
+static event_ring_t event_rings[MAX_CPU_COUNT];
+
+/** @brief Number of events dropped because a ring was full. */
+static volatile uint32_t event_dropped = 0;
+
+/** @brief Hexadecimal digits. */
+static const char event_hex[] = "0123456789abcdef";
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Writes a 32 bits word as hexadecimal to a buffer.
+ *
+ * @param[out] buffer The buffer to write, 9 characters are written.
+ * @param[in] word The word to write.
+ */
+static void event_log_put_word(char* buffer, uint32_t word);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void event_log_put_word(char* buffer, uint32_t word)
+{
+    int32_t i;
+
+    buffer[0] = ' ';
+    for(i = 8; i > 0; --i)
+    {
+        buffer[i] = event_hex[word & 0xF];
+        word >>= 4;
+    }
+}
+
+void event_log_write(const event_log_desc_t* desc,
+                     const uint32_t args_size, ...)
+{
+    __builtin_va_list args;
+    event_ring_t*     ring;
+    uint64_t          timestamp;
+    uint32_t          int_state;
+    uint32_t          arg_count;
+    uint32_t          head;
+    int32_t           cpu_id;
+    uint32_t          i;
+
+    arg_count = args_size / sizeof(uint32_t);
+    if(arg_count > EVENT_LOG_MAX_ARGS)
+    {
+        arg_count = EVENT_LOG_MAX_ARGS;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    cpu_id = cpu_get_id();
+    if(cpu_id < 0 || cpu_id >= MAX_CPU_COUNT)
+    {
+        cpu_id = 0;
+    }
+    ring = &event_rings[cpu_id];
+
+    head = ring->head;
+    if(head + EVENT_LOG_HEADER_SIZE + arg_count - ring->tail >
+       EVENT_LOG_RING_SIZE)
+    {
+        ++event_dropped;
+        EXIT_CRITICAL(int_state);
+        return;
+    }
+
+    timestamp  = cpu_get_timestamp();
+    ring->last = head;
+
+    ring->buffer[head++ & (EVENT_LOG_RING_SIZE - 1)] = (uint32_t)(uintptr_t)desc;
+    ring->buffer[head++ & (EVENT_LOG_RING_SIZE - 1)] = (cpu_id << 16) |
+                                                        arg_count;
+    ring->buffer[head++ & (EVENT_LOG_RING_SIZE - 1)] = (uint32_t)timestamp;
+    ring->buffer[head++ & (EVENT_LOG_RING_SIZE - 1)] = timestamp >> 32;
+
+    /* Arguments are copied as the raw stack words, the host decodes them */
+    __builtin_va_start(args, args_size);
+    for(i = 0; i < arg_count; ++i)
+    {
+        ring->buffer[head++ & (EVENT_LOG_RING_SIZE - 1)] =
+            __builtin_va_arg(args, uint32_t);
+    }
+    __builtin_va_end(args);
+
+    /* Publish the record once it is written */
+    __asm__ __volatile__("" ::: "memory");
+    ring->head = head;
+
+    EXIT_CRITICAL(int_state);
+
+    /* Nobody drains the rings, write the event now */
+    if(kernel_log_is_async() == FALSE)
+    {
+        event_log_flush();
+    }
+}
+
+void event_log_flush(void)
+{
+    event_ring_t* ring;
+    char          line[sizeof(EVENT_LOG_LINE_TAG) +
+                       (EVENT_LOG_HEADER_SIZE + EVENT_LOG_MAX_ARGS) * 9 + 1];
+    uint32_t      length;
+    uint32_t      size;
+    uint32_t      cpu;
+    uint32_t      i;
+
+    for(cpu = 0; cpu < MAX_CPU_COUNT; ++cpu)
+    {
+        ring = &event_rings[cpu];
+        while(ring->tail != ring->head)
+        {
+            size = EVENT_LOG_HEADER_SIZE +
+                   (ring->buffer[(ring->tail + 1) &
+                                 (EVENT_LOG_RING_SIZE - 1)] & 0xFFFF);
+
+            memcpy(line, EVENT_LOG_LINE_TAG, sizeof(EVENT_LOG_LINE_TAG) - 1);
+            length = sizeof(EVENT_LOG_LINE_TAG) - 1;
+            for(i = 0; i < size; ++i)
+            {
+                event_log_put_word(line + length,
+                                   ring->buffer[(ring->tail + i) &
+                                                (EVENT_LOG_RING_SIZE - 1)]);
+                length += 9;
+            }
+            line[length++] = '\n';
+            line[length]   = 0;
+
+            /* Release the record before the slow output */
+            ring->tail += size;
+
+            uart_put_string(line);
+        }
+    }
+}
+
+uint32_t event_log_get_dropped(void)
+{
+    return event_dropped;
+}
+
+uint32_t event_log_get_last(uint32_t* buffer, const uint32_t size)
+{
+    event_ring_t* ring;
+    uint32_t      int_state;
+    uint32_t      count;
+    int32_t       cpu_id;
+    uint32_t      i;
+
+    if(buffer == NULL)
+    {
+        return 0;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    cpu_id = cpu_get_id();
+    if(cpu_id < 0 || cpu_id >= MAX_CPU_COUNT)
+    {
+        cpu_id = 0;
+    }
+    ring = &event_rings[cpu_id];
+
+    count = 0;
+    if(ring->head != 0)
+    {
+        count = EVENT_LOG_HEADER_SIZE +
+                (ring->buffer[(ring->last + 1) & (EVENT_LOG_RING_SIZE - 1)] &
+                 0xFFFF);
+        if(count > size)
+        {
+            count = 0;
+        }
+        for(i = 0; i < count; ++i)
+        {
+            buffer[i] = ring->buffer[(ring->last + i) &
+                                     (EVENT_LOG_RING_SIZE - 1)];
+        }
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return count;
+}
+
+#else
+
+void event_log_write(const event_log_desc_t* desc,
+                     const uint32_t args_size, ...)
+{
+    (void)desc;
+    (void)args_size;
+}
+
+void event_log_flush(void)
+{
+}
+
+uint32_t event_log_get_dropped(void)
+{
+    return 0;
+}
+
+uint32_t event_log_get_last(uint32_t* buffer, const uint32_t size)
+{
+    (void)buffer;
+    (void)size;
+
+    return 0;
+}
+
+#endif /* #ifdef KERNEL_EVENT_LOG_ENABLED */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -15,6 +15,11 @@
  * really basic output too allow early kernel boot output and debug. These
  * functions can be used in interrupts handlers since no lock is required to use
  * them. This also makes them non thread safe.
+ * Once the log drain thread is started, the messages are formatted in the log
+ * ring of the current CPU and written to the output by the drain thread. The
+ * messages are formatted with interrupts disabled, the ring is never locked:
+ * records are reserved by the CPU owning the ring and released by the drainer
+ * through the record committed flag.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -24,11 +29,15 @@
  ******************************************************************************/
 
 /* Included headers */
-#include <string.h>   /* memset, strlen */
-#include <stdlib.h>   /* uitoa, itoa */
-#include <uart.h>     /* UART driver */
-#include <graphic.h>  /* Graphic definitions */
-#include <vga_text.h> /* VGA colors */
+#include <string.h>    /* memset, memcpy */
+#include <uart.h>      /* UART driver */
+#include <graphic.h>   /* Graphic definitions */
+#include <vga_text.h>  /* VGA colors */
+#include <cpu_api.h>   /* CPU API */
+#include <critical.h>  /* Critical sections */
+#include <scheduler.h> /* Kernel scheduler */
+#include <event_log.h> /* Binary event log */
+#include <mutex.h>     /* Mutex API */
 
 /* Configuration files */
 #include <config.h>
@@ -41,12 +50,109 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Size in bytes of the log ring of each CPU, must be a power of two. */
+#define KERNEL_LOG_RING_SIZE 0x4000
+
+/** @brief Size of the buffer grouping the formatted output. */
+#define FORMATER_BUFFER_SIZE 128
+
+/** @brief Maximal number of characters of a formatted integer. */
+#define FORMATER_NUMBER_SIZE 20
+
+/** @brief Maximal size of a log record payload, longer messages are split. */
+#define KERNEL_LOG_LINE_SIZE 252
+
+/** @brief Ring usage above which a thread drains the rings before logging. */
+#define KERNEL_LOG_DRAIN_THRESHOLD ((KERNEL_LOG_RING_SIZE * 3) / 4)
+
+/** @brief Period in milliseconds at which the drain thread empties the rings. */
+#define KERNEL_LOG_DRAIN_PERIOD 10
+
+/** @brief Priority of the log drain thread, just above the idle thread. */
+#define KERNEL_LOG_DRAIN_PRIORITY (KERNEL_LOWEST_PRIORITY - 1)
+
+/** @brief Stack size of the log drain thread. */
+#define KERNEL_LOG_DRAIN_STACK_SIZE 0x1000
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
+/** @brief Formater destination, either a caller buffer or an output flushed
+ * each time the buffer is full.
+ */
+typedef struct
+{
+    /** @brief The buffer receiving the formatted string. */
+    char* buffer;
+
+    /** @brief Size of the buffer. */
+    size_t size;
+
+    /** @brief Number of characters in the buffer. */
+    size_t pos;
+
+    /** @brief Number of characters of the formatted string. */
+    size_t length;
+
+    /** @brief The handler writing the full buffer, NULL to truncate. */
+    void (*flush)(const char*);
+} format_sink_t;
+
+/** @brief Log record types. */
+typedef enum
+{
+    /** @brief Padding up to the end of the ring, skipped by the drainer. */
+    LOG_RECORD_PAD = 0,
+    /** @brief Regular output. */
+    LOG_RECORD_TEXT,
+    /** @brief Output with the error tag. */
+    LOG_RECORD_ERROR,
+    /** @brief Output with the success tag. */
+    LOG_RECORD_SUCCESS,
+    /** @brief Output with the info tag. */
+    LOG_RECORD_INFO,
+    /** @brief Debug output, only sent to the uart port. */
+    LOG_RECORD_UART,
+    /** @brief Following parts of a split debug output, sent untagged. */
+    LOG_RECORD_UART_NEXT
+} LOG_RECORD_TYPE_E;
+
+/** @brief Log record header, followed by the payload padded to 4 bytes. */
+typedef struct
+{
+    /** @brief Size of the payload. */
+    uint16_t length;
+
+    /** @brief Set once the payload is written, cleared by the drainer. */
+    volatile uint8_t committed;
+
+    /** @brief The record type, see LOG_RECORD_TYPE_E. */
+    uint8_t type;
+} log_record_t;
+
+/** @brief Per CPU log ring. */
+typedef struct
+{
+    /** @brief The records storage. */
+    uint8_t buffer[KERNEL_LOG_RING_SIZE];
+
+    /** @brief Bytes reserved by the CPU owning the ring. */
+    volatile uint32_t head;
+
+    /** @brief Bytes released by the drainer. */
+    volatile uint32_t tail;
+
+    /** @brief The message being formatted. */
+    char staging[KERNEL_LOG_LINE_SIZE];
+
+    /** @brief Size of the message being formatted. */
+    uint32_t staging_length;
+
+    /** @brief Type of the message being formatted. */
+    uint8_t staging_type;
+} log_ring_t;
+
 /** @brief Output descriptor, used to define the handlers that manage outputs */
 typedef struct
 {
@@ -60,51 +166,7 @@ typedef struct
  * MACROS
  ******************************************************************************/
 
-/**
- * @brief Adds a padding sequence before a formated input.
- */
-#define PAD_SEQ                         \
-{                                       \
-    str_size = strlen(tmp_seq);         \
-                                        \
-    while(padding_mod > str_size)       \
-    {                                   \
-        used_output.putc(pad_char_mod); \
-        --padding_mod;                  \
-    }                                   \
-}
-
-/**
- * @brief Get a sequence value argument.
- */
-#define GET_SEQ_VAL(val, args, length_mod)                     \
-{                                                              \
-                                                               \
-    /* Harmonize length */                                     \
-    if(length_mod > 8)                                         \
-    {                                                          \
-        length_mod = 8;                                        \
-    }                                                          \
-                                                               \
-    switch(length_mod)                                         \
-    {                                                          \
-        case 1:                                                \
-            val = (__builtin_va_arg(args, uint32_t) & 0xFF);   \
-            break;                                             \
-        case 2:                                                \
-            val = (__builtin_va_arg(args, uint32_t) & 0xFFFF); \
-            break;                                             \
-        case 4:                                                \
-            val = __builtin_va_arg(args, uint32_t);            \
-            break;                                             \
-        case 8:                                                \
-            val = __builtin_va_arg(args, uint64_t);            \
-            break;                                             \
-        default:                                               \
-           val = __builtin_va_arg(args, uint32_t);             \
-    }                                                          \
-                                                               \
-}
+/* None */
 
 /*******************************************************************************
  * GLOBAL VARIABLES
@@ -120,35 +182,112 @@ typedef struct
 /** @brief Stores the current output type. */
 static output_t current_output;
 
+/** @brief Powers of ten from 10^19 to 10^9, used to convert 64 bits values. */
+static const uint64_t format_pow10[] = {
+    10000000000000000000ULL, 1000000000000000000ULL, 100000000000000000ULL,
+    10000000000000000ULL, 1000000000000000ULL, 100000000000000ULL,
+    10000000000000ULL, 1000000000000ULL, 100000000000ULL, 10000000000ULL,
+    1000000000ULL
+};
+
+/** @brief Lowercase hexadecimal digits. */
+static const char format_hex_lower[] = "0123456789abcdef";
+
+/** @brief Uppercase hexadecimal digits. */
+static const char format_hex_upper[] = "0123456789ABCDEF";
+
+/** @brief Log rings, one per CPU. */
+static log_ring_t log_rings[MAX_CPU_COUNT];
+
+/** @brief Set when the messages are written by the drain thread. */
+static volatile bool_t log_async = FALSE;
+
+/** @brief Serializes the drainers, a record is written before the next one
+ * is taken.
+ */
+static mutex_t log_drain_mutex;
+
+/** @brief Number of messages dropped because a ring was full. */
+static volatile uint32_t log_dropped = 0;
+
+/** @brief Number of dropped messages already reported. */
+static uint32_t log_dropped_reported = 0;
+
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
 
 /**
- * @brief Converts a string to upper case characters.
+ * @brief Writes characters to a formater destination.
  *
- * @details Transforms all lowercase character of a NULL terminated string to
- * uppercase characters.
+ * @details Copies the characters to the destination buffer. The buffer is
+ * flushed each time it is full, or the characters are dropped if the
+ * destination has no flush handler.
  *
- * @param[in,out] string The string to tranform.
+ * @param[in, out] sink The formater destination.
+ * @param[in] data The characters to write.
+ * @param[in] length The number of characters to write.
  */
-static void toupper(char* string);
+static void format_write(format_sink_t* sink,
+                         const char* data,
+                         size_t length);
 
 /**
- * @brief Converts a string to upper case characters.
+ * @brief Writes a character several times to a formater destination.
  *
- * @details Transforms all uppercase character of a NULL terminated string to
- * lowercase characters.
+ * @param[in, out] sink The formater destination.
+ * @param[in] character The character to write.
+ * @param[in] count The number of times to write the character.
+ */
+static void format_repeat(format_sink_t* sink,
+                          const char character,
+                          size_t count);
+
+/**
+ * @brief Converts an unsigned value to decimal without division.
+ *
+ * @details 32 bits values are divided by ten with a multiplication by the
+ * reciprocal, the upper digits of 64 bits values are extracted by subtracting
+ * powers of ten.
+ *
+ * @param[in] value The value to convert.
+ * @param[out] buffer The buffer receiving the digits, not NULL terminated.
+ *
+ * @return The number of digits.
+ */
+static size_t format_udec(uint64_t value, char* buffer);
+
+/**
+ * @brief Converts an unsigned value to hexadecimal.
+ *
+ * @param[in] value The value to convert.
+ * @param[out] buffer The buffer receiving the digits, not NULL terminated.
+ * @param[in] digits The digits to use, lowercase or uppercase.
+ *
+ * @return The number of digits.
+ */
+static size_t format_hex(uint64_t value, char* buffer, const char* digits);
+
+/**
+ * @brief Formats a string to a formater destination.
  *
- * @param[in,out] string The string to tranform.
+ * @details Formats a string to a formater destination. Literal runs are
+ * written at once, integers are converted without division.
+ *
+ * @param[in] str The formated string to output.
+ * @param[in] args The arguments to use with the formated string.
+ * @param[in, out] sink The formater destination.
  */
-static void tolower(char* string);
+static void format_string(const char* str,
+                          __builtin_va_list args,
+                          format_sink_t* sink);
 
 /**
  * @brief Prints a formated string.
  *
  * @details Prints a formated string to the output and managing the formated
- * string arguments.
+ * string arguments. The output is grouped in a buffer and written with the
+ * output string handler.
  *
  * @param[in] str The formated string to output.
  * @param[in] args The arguments to use with the formated string.
@@ -190,214 +329,426 @@ static void kprint_fmt_uart(const char* str, __builtin_va_list args);
  */
 static void tag_printf(const char* fmt, ...);
 
+/**
+ * @brief Returns the log ring of the current CPU.
+ *
+ * @return The log ring of the current CPU.
+ */
+static inline log_ring_t* log_get_ring(void);
+
+/**
+ * @brief Copies the message being formatted to the log ring.
+ *
+ * @details Reserves a record in the ring and copies the staging buffer in it.
+ * The message is dropped if the ring is full. Interrupts must be disabled.
+ *
+ * @param[in, out] ring The ring of the current CPU.
+ */
+static void log_commit(log_ring_t* ring);
+
+/**
+ * @brief Log output character handler.
+ *
+ * @param[in] character The character to add to the message being formatted.
+ */
+static void log_putc(const char character);
+
+/**
+ * @brief Log output string handler.
+ *
+ * @param[in] str The string to add to the message being formatted.
+ */
+static void log_puts(const char* str);
+
+/**
+ * @brief Formats a message in the log ring of the current CPU.
+ *
+ * @param[in] type The record type.
+ * @param[in] fmt The formated string to print.
+ * @param[in] args The arguments to use with the formated string.
+ */
+static void log_vprintf(const LOG_RECORD_TYPE_E type,
+                        const char* fmt,
+                        __builtin_va_list args);
+
+/**
+ * @brief Writes a log record to the output.
+ *
+ * @param[in] type The record type.
+ * @param[in] str The record payload.
+ */
+static void log_print_record(const uint8_t type, const char* str);
+
+/**
+ * @brief Takes the oldest committed record of a ring.
+ *
+ * @details Copies the oldest committed record of the ring and releases it.
+ * The record is taken with interrupts disabled. The caller must hold the
+ * drain mutex.
+ *
+ * @param[in, out] ring The ring to take the record from.
+ * @param[out] line The buffer receiving the record payload.
+ * @param[out] type The buffer receiving the record type.
+ *
+ * @return TRUE if a record was taken, FALSE otherwise.
+ */
+static bool_t log_take_record(log_ring_t* ring, char* line, uint8_t* type);
+
+/**
+ * @brief Writes the pending log records to the output.
+ *
+ * @details Writes the committed records of every ring to the output in order,
+ * then the pending binary events. One drainer at a time takes and writes the
+ * records, the others block on the drain mutex. The mutex elevates its owner
+ * so a preempted drain thread does not hold the producers waiting on it.
+ *
+ * @param[in] force Set to TRUE to drain even if another drainer holds the
+ * mutex, only used when the kernel will not resume the other drainer.
+ */
+static void log_drain(const bool_t force);
+
+/**
+ * @brief Log drain thread routine.
+ *
+ * @param[in] args Unused.
+ *
+ * @return This function never returns.
+ */
+static void* log_drain_routine(void* args);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
 
-static void toupper(char* string)
+static void format_write(format_sink_t* sink,
+                         const char* data,
+                         size_t length)
 {
-    /* For each character of the string */
-    while(*string != 0)
+    size_t copy;
+
+    sink->length += length;
+    while(length > 0)
     {
-        /* If the character is lowercase, makes it uppercase */
-        if(*string > 96 && *string < 123)
+        /* Keep room for the NULL terminator */
+        if(sink->pos + 1 >= sink->size)
         {
-            *string = *string - 32;
+            if(sink->flush == NULL)
+            {
+                return;
+            }
+            sink->buffer[sink->pos] = 0;
+            sink->flush(sink->buffer);
+            sink->pos = 0;
+        }
+
+        copy = sink->size - 1 - sink->pos;
+        if(copy > length)
+        {
+            copy = length;
         }
-        ++string;
+        memcpy(sink->buffer + sink->pos, data, copy);
+        sink->pos += copy;
+        data      += copy;
+        length    -= copy;
+    }
+}
+
+static void format_repeat(format_sink_t* sink,
+                          const char character,
+                          size_t count)
+{
+    while(count > 0)
+    {
+        format_write(sink, &character, 1);
+        --count;
     }
 }
 
-static void tolower(char* string)
+static size_t format_udec(uint64_t value, char* buffer)
 {
-    /* For each character of the string */
-    while(*string != 0)
+    char     digits[10];
+    char*    cursor;
+    char     digit;
+    uint32_t low;
+    uint32_t quot;
+    size_t   min_digits;
+    size_t   length;
+    size_t   count;
+    size_t   i;
+
+    length     = 0;
+    min_digits = 1;
+
+    /* Bring the value below 10^9, the remainder is converted on 32 bits */
+    if(value > 0xFFFFFFFFULL)
     {
-        /* If the character is uppercase, makes it lowercase */
-        if(*string > 64 && *string < 91)
+        for(i = 0; i < sizeof(format_pow10) / sizeof(uint64_t); ++i)
         {
-            *string = *string + 32;
+            digit = '0';
+            while(value >= format_pow10[i])
+            {
+                value -= format_pow10[i];
+                ++digit;
+            }
+            if(digit != '0' || length != 0)
+            {
+                buffer[length++] = digit;
+            }
         }
-        ++string;
+        min_digits = 9;
     }
+
+    /* n / 10 == (n * 0xCCCCCCCD) >> 35 for all 32 bits values */
+    low    = (uint32_t)value;
+    cursor = digits + sizeof(digits);
+    do
+    {
+        quot      = (uint32_t)(((uint64_t)low * 0xCCCCCCCDULL) >> 35);
+        *--cursor = '0' + (low - quot * 10);
+        low       = quot;
+    } while(low != 0 ||
+            (size_t)(digits + sizeof(digits) - cursor) < min_digits);
+
+    count = digits + sizeof(digits) - cursor;
+    memcpy(buffer + length, cursor, count);
+
+    return length + count;
 }
 
-static void formater(const char* str,
-                     __builtin_va_list args,
-                     output_t used_output)
+static size_t format_hex(uint64_t value, char* buffer, const char* digits)
 {
-    size_t   pos;
-    size_t   str_length;
-    uint64_t seq_val;
-    size_t   str_size;
+    char   tmp[16];
+    size_t count;
+
+    count = 0;
+    do
+    {
+        tmp[count++] = digits[value & 0xF];
+        value >>= 4;
+    } while(value != 0);
+
+    for(value = 0; value < count; ++value)
+    {
+        buffer[value] = tmp[count - 1 - value];
+    }
 
+    return count;
+}
 
-    uint8_t  modifier;
+static void format_string(const char* str,
+                          __builtin_va_list args,
+                          format_sink_t* sink)
+{
+    __builtin_va_list ap;
+    const char*       run;
+    const char*       args_value;
+    char              tmp_seq[FORMATER_NUMBER_SIZE + 1];
+    uint64_t          seq_val;
+    size_t            seq_length;
+    bool_t            negative;
 
     uint8_t  length_mod;
     uint8_t  padding_mod;
-    bool_t   upper_mod;
     char     pad_char_mod;
 
-    char tmp_seq[128];
+    __builtin_va_copy(ap, args);
 
-    char* args_value;
+    while(*str != 0)
+    {
+        /* Write the literal run at once */
+        run = str;
+        while(*str != 0 && *str != '%')
+        {
+            ++str;
+        }
+        if(str != run)
+        {
+            format_write(sink, run, str - run);
+        }
+        if(*str == 0)
+        {
+            break;
+        }
 
-    modifier     = 0;
-    length_mod   = 4;
-    padding_mod  = 0;
-    upper_mod    = FALSE;
-    pad_char_mod = ' ';
-    str_length   = strlen(str);
+        /* Parse the modifiers */
+        ++str;
+        length_mod   = 4;
+        padding_mod  = 0;
+        pad_char_mod = ' ';
+        negative     = FALSE;
+        seq_length   = 0;
 
-    for(pos = 0; pos < str_length; ++pos)
-    {
-        if(str[pos] == '%')
+        while(*str != 0)
         {
-            /* If we encouter this character in a modifier sequence, it was
-             * just an escape one.
-             */
-            modifier = !modifier;
-            if(modifier)
+            if(*str == 'h')
+            {
+                length_mod /= 2;
+            }
+            else if(*str == 'l')
+            {
+                length_mod *= 2;
+            }
+            else if(*str == '0' && padding_mod == 0)
             {
-                continue;
+                pad_char_mod = '0';
             }
-            else
+            else if(*str >= '0' && *str <= '9')
             {
-                used_output.putc(str[pos]);
+                padding_mod = padding_mod * 10 + (*str - '0');
             }
+            else if(*str == '%' || *str == 's' || *str == 'd' ||
+                    *str == 'i' || *str == 'u' || *str == 'x' ||
+                    *str == 'X' || *str == 'p' || *str == 'P' ||
+                    *str == 'c')
+            {
+                break;
+            }
+            ++str;
+        }
+        if(*str == 0)
+        {
+            break;
+        }
+
+        if(*str == 'p' || *str == 'P')
+        {
+            padding_mod  = 2 * sizeof(uintptr_t);
+            pad_char_mod = '0';
+            length_mod   = sizeof(uintptr_t);
         }
-        else if(modifier)
+
+        /* Get the integer argument */
+        seq_val = 0;
+        if(*str != '%' && *str != 's')
         {
-            switch(str[pos])
+            if(*str == 'c')
             {
-                /* Length mods */
-                case 'h':
-                    length_mod /= 2;
-                    continue;
-                case 'l':
-                    length_mod *= 2;
-                    continue;
-
-                /* Specifier mods */
-                case 's':
-                    args_value = __builtin_va_arg(args, char*);
-                    used_output.puts(args_value);
-                    break;
-                case 'd':
-                case 'i':
-                    GET_SEQ_VAL(seq_val, args, length_mod);
-                    memset(tmp_seq, 0, sizeof(tmp_seq));
-                    itoa(seq_val, tmp_seq, 10);
-                    PAD_SEQ
-                    used_output.puts(tmp_seq);
-                    break;
-                case 'u':
-                    GET_SEQ_VAL(seq_val, args, length_mod);
-                    memset(tmp_seq, 0, sizeof(tmp_seq));
-                    uitoa(seq_val, tmp_seq, 10);
-                    PAD_SEQ
-                    used_output.puts(tmp_seq);
-                    break;
-                case 'X':
-                    upper_mod = TRUE;
-                    __attribute__ ((fallthrough));
-                case 'x':
-                    GET_SEQ_VAL(seq_val, args, length_mod);
-                    memset(tmp_seq, 0, sizeof(tmp_seq));
-                    uitoa(seq_val, tmp_seq, 16);
-                    PAD_SEQ
-                    if(upper_mod == TRUE)
-                    {
-                        toupper(tmp_seq);
-                    }
-                    else
-                    {
-                        tolower(tmp_seq);
-                    }
-                    used_output.puts(tmp_seq);
+                length_mod = sizeof(char);
+            }
+            switch(length_mod)
+            {
+                case 1:
+                    seq_val = __builtin_va_arg(ap, uint32_t) & 0xFF;
                     break;
-                case 'P':
-                    upper_mod = TRUE;
-                    __attribute__ ((fallthrough));
-                case 'p':
-                    padding_mod  = 2 * sizeof(uintptr_t);
-                    pad_char_mod = '0';
-                    length_mod = sizeof(uintptr_t);
-                    GET_SEQ_VAL(seq_val, args, length_mod);
-                    memset(tmp_seq, 0, sizeof(tmp_seq));
-                    uitoa(seq_val, tmp_seq, 16);
-                    PAD_SEQ
-                    if(upper_mod == TRUE)
-                    {
-                        toupper(tmp_seq);
-                    }
-                    else
-                    {
-                        tolower(tmp_seq);
-                    }
-                    used_output.puts(tmp_seq);
+                case 2:
+                    seq_val = __builtin_va_arg(ap, uint32_t) & 0xFFFF;
                     break;
-                case 'c':
-                    length_mod = sizeof(char);
-                    GET_SEQ_VAL(tmp_seq[0], args, length_mod);
-                    used_output.putc(tmp_seq[0]);
+                case 0:
+                case 4:
+                    seq_val = __builtin_va_arg(ap, uint32_t);
                     break;
-
-                /* Padding mods */
-                case '0':
-                    if(padding_mod == 0)
-                    {
-                        pad_char_mod = '0';
-                    }
-                    else
-                    {
-                        padding_mod *= 10;
-                    }
-                    continue;
-                case '1':
-                    padding_mod = padding_mod * 10 + 1;
-                    continue;
-                case '2':
-                    padding_mod = padding_mod * 10 + 2;
-                    continue;
-                case '3':
-                    padding_mod = padding_mod * 10 + 3;
-                    continue;
-                case '4':
-                    padding_mod = padding_mod * 10 + 4;
-                    continue;
-                case '5':
-                    padding_mod = padding_mod * 10 + 5;
-                    continue;
-                case '6':
-                    padding_mod = padding_mod * 10 + 6;
-                    continue;
-                case '7':
-                    padding_mod = padding_mod * 10 + 7;
-                    continue;
-                case '8':
-                    padding_mod = padding_mod * 10 + 8;
-                    continue;
-                case '9':
-                    padding_mod = padding_mod * 10 + 9;
-                    continue;
                 default:
-                    continue;
+                    seq_val = __builtin_va_arg(ap, uint64_t);
             }
         }
-        else
+
+        switch(*str)
         {
-            used_output.putc(str[pos]);
+            case '%':
+                format_write(sink, str, 1);
+                break;
+            case 's':
+                args_value = __builtin_va_arg(ap, const char*);
+                if(args_value == NULL)
+                {
+                    args_value = "(null)";
+                }
+                run = args_value;
+                while(*args_value != 0)
+                {
+                    ++args_value;
+                }
+                format_write(sink, run, args_value - run);
+                break;
+            case 'c':
+                tmp_seq[0] = (char)seq_val;
+                format_write(sink, tmp_seq, 1);
+                break;
+            case 'd':
+            case 'i':
+                /* Sign extend the value to its argument size */
+                if(length_mod == 1)
+                {
+                    seq_val = (uint64_t)(int64_t)(int8_t)seq_val;
+                }
+                else if(length_mod == 2)
+                {
+                    seq_val = (uint64_t)(int64_t)(int16_t)seq_val;
+                }
+                else if(length_mod < 8)
+                {
+                    seq_val = (uint64_t)(int64_t)(int32_t)seq_val;
+                }
+                if((int64_t)seq_val < 0)
+                {
+                    negative = TRUE;
+                    seq_val  = -seq_val;
+                }
+                seq_length = format_udec(seq_val, tmp_seq);
+                break;
+            case 'u':
+                seq_length = format_udec(seq_val, tmp_seq);
+                break;
+            case 'x':
+            case 'p':
+                seq_length = format_hex(seq_val, tmp_seq, format_hex_lower);
+                break;
+            default:
+                seq_length = format_hex(seq_val, tmp_seq, format_hex_upper);
+                break;
         }
 
-        /* Reinit mods */
-        length_mod   = 4;
-        padding_mod  = 0;
-        upper_mod    = FALSE;
-        pad_char_mod = ' ';
-        modifier     = 0;
+        /* Pad the integers, the sign is written before the zero padding */
+        if(seq_length != 0)
+        {
+            if(negative == TRUE)
+            {
+                ++seq_length;
+                if(pad_char_mod == '0')
+                {
+                    format_write(sink, "-", 1);
+                }
+            }
+            if(padding_mod > seq_length)
+            {
+                format_repeat(sink, pad_char_mod, padding_mod - seq_length);
+            }
+            if(negative == TRUE)
+            {
+                --seq_length;
+                if(pad_char_mod != '0')
+                {
+                    format_write(sink, "-", 1);
+                }
+            }
+            format_write(sink, tmp_seq, seq_length);
+        }
+
+        ++str;
+    }
+
+    __builtin_va_end(ap);
+}
 
+static void formater(const char* str,
+                     __builtin_va_list args,
+                     output_t used_output)
+{
+    char          buffer[FORMATER_BUFFER_SIZE];
+    format_sink_t sink = {
+        .buffer = buffer,
+        .size   = sizeof(buffer),
+        .pos    = 0,
+        .length = 0,
+        .flush  = used_output.puts
+    };
+
+    format_string(str, args, &sink);
+
+    if(sink.pos != 0)
+    {
+        buffer[sink.pos] = 0;
+        used_output.puts(buffer);
     }
 }
 
@@ -430,6 +781,345 @@ static void tag_printf(const char* fmt, ...)
     __builtin_va_end(args);
 }
 
+static inline log_ring_t* log_get_ring(void)
+{
+    int32_t cpu_id;
+
+    cpu_id = cpu_get_id();
+    if(cpu_id < 0 || cpu_id >= MAX_CPU_COUNT)
+    {
+        cpu_id = 0;
+    }
+
+    return &log_rings[cpu_id];
+}
+
+static void log_commit(log_ring_t* ring)
+{
+    log_record_t* record;
+    log_record_t* pad;
+    uint32_t      offset;
+    uint32_t      size;
+    uint32_t      pad_size;
+
+    if(ring->staging_length == 0)
+    {
+        return;
+    }
+
+    size = (sizeof(log_record_t) + ring->staging_length + 3) & ~3U;
+
+    /* Records are never split, pad up to the end of the ring if needed */
+    offset   = ring->head & (KERNEL_LOG_RING_SIZE - 1);
+    pad_size = 0;
+    if(offset + size > KERNEL_LOG_RING_SIZE)
+    {
+        pad_size = KERNEL_LOG_RING_SIZE - offset;
+    }
+
+    if(ring->head + pad_size + size - ring->tail > KERNEL_LOG_RING_SIZE)
+    {
+        ++log_dropped;
+        ring->staging_length = 0;
+        return;
+    }
+
+    if(pad_size != 0)
+    {
+        pad = (log_record_t*)&ring->buffer[offset];
+        pad->length    = pad_size - sizeof(log_record_t);
+        pad->type      = LOG_RECORD_PAD;
+        pad->committed = 1;
+        offset = 0;
+    }
+
+    record = (log_record_t*)&ring->buffer[offset];
+    record->length    = ring->staging_length;
+    record->type      = ring->staging_type;
+    record->committed = 0;
+
+    ring->head += pad_size + size;
+
+    memcpy(record + 1, ring->staging, ring->staging_length);
+
+    /* Publish the record once its payload is written */
+    __asm__ __volatile__("" ::: "memory");
+    record->committed = 1;
+
+    /* The following parts of a split message are not tagged again */
+    ring->staging_length = 0;
+    if(ring->staging_type == LOG_RECORD_UART ||
+       ring->staging_type == LOG_RECORD_UART_NEXT)
+    {
+        ring->staging_type = LOG_RECORD_UART_NEXT;
+    }
+    else
+    {
+        ring->staging_type = LOG_RECORD_TEXT;
+    }
+}
+
+static void log_putc(const char character)
+{
+    log_ring_t* ring;
+
+    ring = log_get_ring();
+    ring->staging[ring->staging_length++] = character;
+    if(ring->staging_length == KERNEL_LOG_LINE_SIZE)
+    {
+        log_commit(ring);
+    }
+}
+
+static void log_puts(const char* str)
+{
+    log_ring_t* ring;
+    uint32_t    length;
+
+    ring = log_get_ring();
+    while(*str != 0)
+    {
+        /* Copy the run fitting in the staging buffer at once */
+        length = 0;
+        while(str[length] != 0 &&
+              ring->staging_length + length < KERNEL_LOG_LINE_SIZE)
+        {
+            ++length;
+        }
+        memcpy(ring->staging + ring->staging_length, str, length);
+        ring->staging_length += length;
+        str += length;
+
+        if(ring->staging_length == KERNEL_LOG_LINE_SIZE)
+        {
+            log_commit(ring);
+        }
+    }
+}
+
+static void log_vprintf(const LOG_RECORD_TYPE_E type,
+                        const char* fmt,
+                        __builtin_va_list args)
+{
+    log_ring_t* ring;
+    output_t    log_out = {
+        .putc = log_putc,
+        .puts = log_puts
+    };
+    uint32_t    int_state;
+
+    /* Do not drop messages when the drain thread is starving, threads drain
+     * the rings themselves.
+     */
+    ring = log_get_ring();
+    if(cpu_get_interrupt_state() != 0 &&
+       ring->head - ring->tail > KERNEL_LOG_DRAIN_THRESHOLD)
+    {
+        log_drain(FALSE);
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    ring = log_get_ring();
+    ring->staging_length = 0;
+    ring->staging_type   = type;
+
+    formater(fmt, args, log_out);
+    log_commit(ring);
+
+    EXIT_CRITICAL(int_state);
+}
+
+static void log_print_record(const uint8_t type, const char* str)
+{
+    colorscheme_t buffer;
+    colorscheme_t new_scheme;
+    const char*   tag;
+
+    current_output.putc = graphic_put_char;
+    current_output.puts = graphic_put_string;
+
+    switch(type)
+    {
+        case LOG_RECORD_ERROR:
+            new_scheme.foreground = FG_RED;
+            tag = "[ERROR] ";
+            break;
+        case LOG_RECORD_SUCCESS:
+            new_scheme.foreground = FG_GREEN;
+            tag = "[OK] ";
+            break;
+        case LOG_RECORD_INFO:
+            new_scheme.foreground = FG_CYAN;
+            tag = "[INFO] ";
+            break;
+        case LOG_RECORD_UART:
+            uart_put_string("[DEBUG] ");
+            uart_put_string(str);
+            return;
+        case LOG_RECORD_UART_NEXT:
+            uart_put_string(str);
+            return;
+        default:
+            graphic_put_string(str);
+            return;
+    }
+
+    new_scheme.background = BG_BLACK;
+    new_scheme.vga_color  = TRUE;
+
+    graphic_save_color_scheme(&buffer);
+    graphic_set_color_scheme(new_scheme);
+    graphic_put_string(tag);
+    graphic_set_color_scheme(buffer);
+
+    graphic_put_string(str);
+}
+
+static bool_t log_take_record(log_ring_t* ring, char* line, uint8_t* type)
+{
+    log_record_t* record;
+    uint32_t      int_state;
+    bool_t        taken;
+
+    /* The producer of the ring runs on this CPU */
+    ENTER_CRITICAL(int_state);
+
+    taken = FALSE;
+    while(taken == FALSE && ring->tail != ring->head)
+    {
+        record = (log_record_t*)&ring->buffer[ring->tail &
+                                              (KERNEL_LOG_RING_SIZE - 1)];
+        if(record->committed == 0)
+        {
+            break;
+        }
+
+        if(record->type != LOG_RECORD_PAD)
+        {
+            memcpy(line, record + 1, record->length);
+            line[record->length] = 0;
+            *type = record->type;
+            taken = TRUE;
+        }
+
+        /* Release the record to the producer */
+        record->committed = 0;
+        ring->tail += (sizeof(log_record_t) + record->length + 3) & ~3U;
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return taken;
+}
+
+static void log_drain(const bool_t force)
+{
+    char     line[KERNEL_LOG_LINE_SIZE + 1];
+    uint8_t  type;
+    uint32_t dropped;
+    uint32_t i;
+    bool_t   locked;
+
+    /* The records are written in the order they are taken. Without the drain
+     * thread nobody else drains, a forced drain never waits as the other
+     * drainers are not resumed.
+     */
+    locked = FALSE;
+    if(force == FALSE && log_async == TRUE)
+    {
+        locked = (mutex_lock(&log_drain_mutex) == OS_NO_ERR);
+    }
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        while(log_take_record(&log_rings[i], line, &type) == TRUE)
+        {
+            log_print_record(type, line);
+        }
+    }
+
+    event_log_flush();
+
+    dropped = log_dropped;
+    if(dropped != log_dropped_reported)
+    {
+        log_dropped_reported = dropped;
+        tag_printf("[LOG] %u messages dropped\n", dropped);
+    }
+
+    if(locked == TRUE)
+    {
+        mutex_unlock(&log_drain_mutex);
+    }
+}
+
+static void* log_drain_routine(void* args)
+{
+    (void)args;
+
+    while(TRUE)
+    {
+        log_drain(FALSE);
+        sched_sleep(KERNEL_LOG_DRAIN_PERIOD);
+    }
+
+    return NULL;
+}
+
+OS_RETURN_E kernel_log_init(void)
+{
+    kernel_thread_t* thread;
+    OS_RETURN_E      err;
+
+    if(log_async == TRUE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    err = mutex_init(&log_drain_mutex, MUTEX_FLAG_NONE,
+                     KERNEL_HIGHEST_PRIORITY);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    err = sched_create_kernel_thread(&thread, KERNEL_LOG_DRAIN_PRIORITY,
+                                     "log_drain", THREAD_TYPE_KERNEL,
+                                     KERNEL_LOG_DRAIN_STACK_SIZE,
+                                     log_drain_routine, NULL);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    log_async = TRUE;
+
+    return OS_NO_ERR;
+}
+
+void kernel_log_flush(void)
+{
+    log_drain(FALSE);
+}
+
+void kernel_log_sync(void)
+{
+    log_async = FALSE;
+    log_drain(TRUE);
+    uart_sync();
+}
+
+uint32_t kernel_log_get_dropped(void)
+{
+    return log_dropped;
+}
+
+bool_t kernel_log_is_async(void)
+{
+    return log_async;
+}
+
 void kernel_printf(const char* fmt, ...)
 {
     __builtin_va_list args;
@@ -439,6 +1129,14 @@ void kernel_printf(const char* fmt, ...)
         return;
     }
 
+    if(log_async == TRUE)
+    {
+        __builtin_va_start(args, fmt);
+        log_vprintf(LOG_RECORD_TEXT, fmt, args);
+        __builtin_va_end(args);
+        return;
+    }
+
     /* Prtinf format string */
     __builtin_va_start(args, fmt);
     current_output.putc = graphic_put_char;
@@ -458,6 +1156,14 @@ void kernel_error(const char* fmt, ...)
         return;
     }
 
+    if(log_async == TRUE)
+    {
+        __builtin_va_start(args, fmt);
+        log_vprintf(LOG_RECORD_ERROR, fmt, args);
+        __builtin_va_end(args);
+        return;
+    }
+
     new_scheme.foreground = FG_RED;
     new_scheme.background = BG_BLACK;
     new_scheme.vga_color  = TRUE;
@@ -494,6 +1200,14 @@ void kernel_success(const char* fmt, ...)
         return;
     }
 
+    if(log_async == TRUE)
+    {
+        __builtin_va_start(args, fmt);
+        log_vprintf(LOG_RECORD_SUCCESS, fmt, args);
+        __builtin_va_end(args);
+        return;
+    }
+
     new_scheme.foreground = FG_GREEN;
     new_scheme.background = BG_BLACK;
     new_scheme.vga_color  = TRUE;
@@ -530,6 +1244,14 @@ void kernel_info(const char* fmt, ...)
         return;
     }
 
+    if(log_async == TRUE)
+    {
+        __builtin_va_start(args, fmt);
+        log_vprintf(LOG_RECORD_INFO, fmt, args);
+        __builtin_va_end(args);
+        return;
+    }
+
     new_scheme.foreground = FG_CYAN;
     new_scheme.background = BG_BLACK;
     new_scheme.vga_color  = TRUE;
@@ -564,6 +1286,14 @@ void kernel_uart_debug(const char* fmt, ...)
         return;
     }
 
+    if(log_async == TRUE)
+    {
+        __builtin_va_start(args, fmt);
+        log_vprintf(LOG_RECORD_UART, fmt, args);
+        __builtin_va_end(args);
+        return;
+    }
+
     __builtin_va_start(args, fmt);
     kprint_fmt_uart("[DEBUG] ", args);
 
@@ -572,6 +1302,59 @@ void kernel_uart_debug(const char* fmt, ...)
 
 }
 
+void kernel_uart_printf(const char* fmt, ...)
+{
+    __builtin_va_list args;
+
+    if(fmt == NULL)
+    {
+        return;
+    }
+
+    __builtin_va_start(args, fmt);
+    kprint_fmt_uart(fmt, args);
+    __builtin_va_end(args);
+}
+
+int32_t kernel_vsnprintf(char* buffer,
+                         const size_t size,
+                         const char* fmt,
+                         __builtin_va_list args)
+{
+    char          empty;
+    format_sink_t sink;
+
+    if(fmt == NULL || (buffer == NULL && size != 0))
+    {
+        return -1;
+    }
+
+    /* Only the length is computed when no buffer is given */
+    sink.buffer = (size != 0) ? buffer : &empty;
+    sink.size   = (size != 0) ? size : 1;
+    sink.pos    = 0;
+    sink.length = 0;
+    sink.flush  = NULL;
+
+    format_string(fmt, args, &sink);
+
+    sink.buffer[sink.pos] = 0;
+
+    return (int32_t)sink.length;
+}
+
+int32_t kernel_snprintf(char* buffer, const size_t size, const char* fmt, ...)
+{
+    __builtin_va_list args;
+    int32_t           length;
+
+    __builtin_va_start(args, fmt);
+    length = kernel_vsnprintf(buffer, size, fmt, args);
+    __builtin_va_end(args);
+
+    return length;
+}
+
 void kernel_doprint(const char* str, __builtin_va_list args)
 {
     if(str == NULL)
@@ -579,6 +1362,12 @@ void kernel_doprint(const char* str, __builtin_va_list args)
         return;
     }
 
+    if(log_async == TRUE)
+    {
+        log_vprintf(LOG_RECORD_TEXT, str, args);
+        return;
+    }
+
     current_output.putc = graphic_put_char;
     current_output.puts = graphic_put_string;
     kprint_fmt(str, args);
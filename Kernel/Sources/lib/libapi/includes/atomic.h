@@ -13,6 +13,9 @@
  *
  * @details Atomic primitives implementation. Defines the different basic
  * synchronization primitives used in the kernel and by the user.
+ * Spinlocks are ticket locks: threads acquire the lock in the order they
+ * requested it. Each spinlock counts its acquisitions and the acquisitions that
+ * had to wait for the lock, allowing to detect contended locks.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -26,13 +29,14 @@
 
 #include <stdint.h>    /* Standard int definitons */
 #include <cpu_api.h>   /* CPU API for atomic */
+#include <critical.h>  /* Kernel critical sections */
 
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
 
 /** @brief Initial spinlock value */
-#define SPINLOCK_INIT_VALUE 0
+#define SPINLOCK_INIT_VALUE {0, 0, 0}
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -42,7 +46,22 @@
  * @brief Defines the spinlock structure.
  *
  */
-typedef volatile uint32_t spinlock_t;
+typedef struct
+{
+    /**
+     * @brief Ticket lock word.
+     * @details The lock word is defined bitwise;
+     *  - [0-15]  = Ticket currently owning the lock.
+     *  - [16-31] = Next ticket to distribute.
+     */
+    volatile uint32_t lockword;
+
+    /** @brief Number of times the lock was acquired. */
+    volatile uint32_t acquisitions;
+
+    /** @brief Number of acquisitions that had to wait for the lock. */
+    volatile uint32_t contentions;
+} spinlock_t;
 
 /*******************************************************************************
  * MACROS
@@ -53,8 +72,10 @@ typedef volatile uint32_t spinlock_t;
  *
  * @details Initialize the spinlock to the start value.
  */
-#define SPINLOCK_INIT(lock) {    \
-    *lock = SPINLOCK_INIT_VALUE; \
+#define SPINLOCK_INIT(lock) {   \
+    (lock)->lockword     = 0;   \
+    (lock)->acquisitions = 0;   \
+    (lock)->contentions  = 0;   \
 }
 
 /**
@@ -65,8 +86,29 @@ typedef volatile uint32_t spinlock_t;
  *
  * @param[in,out] lock The spinlock to use.
  */
-#define SPINLOCK_LOCK(lock) { \
-    cpu_lock_spinlock(&lock); \
+#define SPINLOCK_LOCK(lock) {                       \
+    if(cpu_lock_spinlock(&(lock).lockword) != 0)    \
+    {                                               \
+        ++(lock).contentions;                       \
+    }                                               \
+    ++(lock).acquisitions;                          \
+}
+
+/**
+ * @brief Try to lock the spinlock.
+ *
+ * @details Try to lock the spinlock. This function is non blocking, the lock
+ * is not acquired if it is held or if other threads are waiting for it.
+ *
+ * @param[in,out] lock The spinlock to use.
+ * @param[out] acquired Set to 1 if the lock was acquired, 0 otherwise.
+ */
+#define SPINLOCK_TRYLOCK(lock, acquired) {                    \
+    acquired = cpu_trylock_spinlock(&(lock).lockword);        \
+    if(acquired != 0)                                         \
+    {                                                         \
+        ++(lock).acquisitions;                                \
+    }                                                         \
 }
 
 /**
@@ -76,8 +118,37 @@ typedef volatile uint32_t spinlock_t;
  *
  * @param[in,out] lock The spinlock to use.
  */
-#define SPINLOCK_UNLOCK(lock) { \
-    lock = 0;                   \
+#define SPINLOCK_UNLOCK(lock) {                 \
+    cpu_unlock_spinlock(&(lock).lockword);      \
+}
+
+/**
+ * @brief Disables the interrupts and locks the spinlock.
+ *
+ * @details Disables the interrupts and locks the spinlock. This must be used
+ * when the lock can also be acquired from an interrupt handler.
+ *
+ * @warning A lock acquired with this macro must always be acquired with
+ * interrupts disabled. Otherwise, a preempted holder could never release the
+ * lock while another thread spins with interrupts disabled.
+ *
+ * @param[in,out] lock The spinlock to use.
+ * @param[out] int_state The interrupt state to give to the unlock call.
+ */
+#define SPINLOCK_LOCK_IRQSAVE(lock, int_state) { \
+    ENTER_CRITICAL(int_state);                   \
+    SPINLOCK_LOCK(lock);                         \
+}
+
+/**
+ * @brief Unlocks the spinlock and restores the interrupts state.
+ *
+ * @param[in,out] lock The spinlock to use.
+ * @param[in] int_state The interrupt state returned by the lock call.
+ */
+#define SPINLOCK_UNLOCK_IRQRESTORE(lock, int_state) { \
+    SPINLOCK_UNLOCK(lock);                            \
+    EXIT_CRITICAL(int_state);                         \
 }
 
 /**
@@ -122,6 +193,19 @@ typedef volatile uint32_t spinlock_t;
  */
 #define ATOMIC_STORE(memory, val) cpu_atomic_store(memory, val)
 
+/**
+ * @brief Atomically exchanges a value in the memory.
+ *
+ * @details Atomically stores a value in the memory and returns the value that
+ * was stored before.
+ *
+ * @param[out] memory The memory region to modify.
+ * @param[in] val The value to store.
+ *
+ * @returns The previous value contained in the memory region is returned.
+ */
+#define ATOMIC_SWAP(memory, val) cpu_atomic_swap(memory, val)
+
 /*******************************************************************************
  * GLOBAL VARIABLES
  ******************************************************************************/
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * @file barrier.h
+ *
+ * @see barrier.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 27/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Barrier synchronization primitive.
+ *
+ * @details Barrier synchronization primitive implementation. A barrier blocks
+ * a fixed number of threads until all of them reached it. The barrier is
+ * reusable, each time all the threads reached it a new generation starts. The
+ * last thread reaching the barrier wakes all the waiting threads with a single
+ * futex wake.
+ *
+ * @warning Barriers can only be used when the current system is running and
+ * the scheduler initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __LIB_BARRIER_H_
+#define __LIB_BARRIER_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stddef.h>       /* Standard definitions */
+#include <stdint.h>       /* Generic int types */
+#include <kernel_error.h> /* Kernel error API */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Barrier structure definition. */
+typedef struct
+{
+    /** @brief Barrier generation, the waiting threads wait on it. */
+    volatile int32_t generation;
+
+    /** @brief Number of threads that reached the barrier this generation. */
+    volatile int32_t arrived;
+
+    /** @brief Number of threads to wait for. */
+    int32_t count;
+
+    /** @brief Barrier initialization state. */
+    volatile bool_t init;
+} barrier_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the barrier structure.
+ *
+ * @param[out] barrier The pointer to the barrier to initialize.
+ * @param[in] count The number of threads that have to reach the barrier to
+ * release it.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the barrier is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the count is not positive.
+ */
+OS_RETURN_E barrier_init(barrier_t* barrier, const int32_t count);
+
+/**
+ * @brief Destroys the barrier given as parameter.
+ *
+ * @details Destroys the barrier given as parameter. Also wakes all the threads
+ * waiting on the barrier, they will return OS_ERR_NOT_INITIALIZED.
+ *
+ * @param[in, out] barrier The barrier to destroy.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the barrier is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the barrier has not been
+ *   initialized.
+ */
+OS_RETURN_E barrier_destroy(barrier_t* barrier);
+
+/**
+ * @brief Waits on the barrier given as parameter.
+ *
+ * @details Waits on the barrier given as parameter. The calling thread blocks
+ * until the number of threads given at initialization reached the barrier.
+ * The last thread to reach the barrier does not block and wakes the other
+ * threads.
+ *
+ * @param[in, out] barrier The barrier to wait on.
+ * @param[out] serial Set to TRUE for the last thread reaching the barrier and
+ * to FALSE for the other threads. Can be NULL.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the barrier is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the barrier has not been
+ *   initialized or was destroyed while waiting.
+ */
+OS_RETURN_E barrier_wait(barrier_t* barrier, bool_t* serial);
+
+#endif /* #ifndef __LIB_BARRIER_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * @file cond.h
+ *
+ * @see cond.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 20/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Condition variable synchronization primitive.
+ *
+ * @details Condition variable synchronization primitive implementation. A
+ * condition variable is always used with a mutex. Broadcasting a condition
+ * variable wakes a single thread and requeues the other waiting threads on the
+ * mutex, avoiding to wake threads that would immediately block on the mutex.
+ *
+ * @warning Condition variables can only be used when the current system is
+ * running and the scheduler initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __LIB_COND_H_
+#define __LIB_COND_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stddef.h>       /* Standard definitions */
+#include <stdint.h>       /* Generic int types */
+#include <kernel_error.h> /* Kernel error API */
+#include <mutex.h>        /* Mutex API */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Condition variable structure definition. */
+typedef struct
+{
+    /** @brief Condition sequence counter, the waiting threads wait on it. */
+    volatile int32_t seq;
+
+    /** @brief Number of threads waiting on the condition. */
+    volatile int32_t waiters;
+
+    /** @brief The mutex used with the condition by the waiting threads. */
+    mutex_t* mutex;
+
+    /** @brief Condition variable initialization state. */
+    volatile bool_t init;
+} cond_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the condition variable structure.
+ *
+ * @param[out] cond The pointer to the condition variable to initialize.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the condition variable
+ *   is NULL.
+ */
+OS_RETURN_E cond_init(cond_t* cond);
+
+/**
+ * @brief Destroys the condition variable given as parameter.
+ *
+ * @details Destroys the condition variable given as parameter. Also wakes all
+ * the threads waiting on the condition, they will return
+ * OS_ERR_NOT_INITIALIZED after reacquiring the mutex.
+ *
+ * @param[in, out] cond The condition variable to destroy.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the condition variable
+ *   is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the condition variable has not been
+ *   initialized.
+ */
+OS_RETURN_E cond_destroy(cond_t* cond);
+
+/**
+ * @brief Waits on the condition variable given as parameter.
+ *
+ * @details Waits on the condition variable given as parameter. The mutex must
+ * be held by the calling thread, it is released while waiting and reacquired
+ * before returning. All the threads waiting on the same condition must use
+ * the same mutex.
+ *
+ * @param[in, out] cond The condition variable to wait on.
+ * @param[in, out] mutex The mutex held by the calling thread.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if one of the pointers is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the condition variable has not been
+ *   initialized or was destroyed while waiting.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if another mutex is already used
+ *   with the condition.
+ */
+OS_RETURN_E cond_wait(cond_t* cond, mutex_t* mutex);
+
+/**
+ * @brief Wakes one thread waiting on the condition variable.
+ *
+ * @param[in, out] cond The condition variable to signal.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the condition variable
+ *   is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the condition variable has not been
+ *   initialized.
+ */
+OS_RETURN_E cond_signal(cond_t* cond);
+
+/**
+ * @brief Wakes all the threads waiting on the condition variable.
+ *
+ * @details Wakes all the threads waiting on the condition variable. When the
+ * mutex is held, only one thread is woken, the other threads are requeued on
+ * the mutex and are woken one by one as the mutex is released.
+ *
+ * @param[in, out] cond The condition variable to broadcast.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the condition variable
+ *   is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the condition variable has not been
+ *   initialized.
+ */
+OS_RETURN_E cond_broadcast(cond_t* cond);
+
+#endif /* #ifndef __LIB_COND_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
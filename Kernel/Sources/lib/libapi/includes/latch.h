@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * @file latch.h
+ *
+ * @see latch.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 27/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Latch synchronization primitive.
+ *
+ * @details Latch synchronization primitive implementation. A latch is a
+ * single use down counter, threads waiting on the latch are released once the
+ * counter reaches zero. Contrary to the barrier, the threads counting the latch
+ * down are not required to wait on it.
+ *
+ * @warning Latches can only be used when the current system is running and
+ * the scheduler initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __LIB_LATCH_H_
+#define __LIB_LATCH_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stddef.h>       /* Standard definitions */
+#include <stdint.h>       /* Generic int types */
+#include <kernel_error.h> /* Kernel error API */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Latch structure definition. */
+typedef struct
+{
+    /** @brief Latch counter, the waiting threads wait on it. */
+    volatile int32_t count;
+
+    /** @brief Latch initialization state. */
+    volatile bool_t init;
+} latch_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the latch structure.
+ *
+ * @param[out] latch The pointer to the latch to initialize.
+ * @param[in] count The initial value of the latch counter.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the latch is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the count is negative.
+ */
+OS_RETURN_E latch_init(latch_t* latch, const int32_t count);
+
+/**
+ * @brief Destroys the latch given as parameter.
+ *
+ * @details Destroys the latch given as parameter. Also wakes all the threads
+ * waiting on the latch, they will return OS_ERR_NOT_INITIALIZED.
+ *
+ * @param[in, out] latch The latch to destroy.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the latch is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the latch has not been initialized.
+ */
+OS_RETURN_E latch_destroy(latch_t* latch);
+
+/**
+ * @brief Decrements the latch counter.
+ *
+ * @details Decrements the latch counter. When the counter reaches zero, all
+ * the threads waiting on the latch are woken with a single futex wake.
+ *
+ * @param[in, out] latch The latch to count down.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the latch is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the latch has not been initialized.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the latch was already open.
+ */
+OS_RETURN_E latch_count_down(latch_t* latch);
+
+/**
+ * @brief Waits for the latch counter to reach zero.
+ *
+ * @param[in, out] latch The latch to wait on.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the latch is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the latch has not been initialized
+ *   or was destroyed while waiting.
+ */
+OS_RETURN_E latch_wait(latch_t* latch);
+
+/**
+ * @brief Checks if the latch counter reached zero.
+ *
+ * @details Checks if the latch counter reached zero. This function is non
+ * blocking.
+ *
+ * @param[in] latch The latch to check.
+ * @param[out] value The buffer that receives the latch counter. Can be NULL.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if the latch is open.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the latch is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the latch has not been initialized.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the latch is still closed.
+ */
+OS_RETURN_E latch_try_wait(latch_t* latch, int32_t* value);
+
+/**
+ * @brief Decrements the latch counter and waits for it to reach zero.
+ *
+ * @param[in, out] latch The latch to count down and wait on.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the latch is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the latch has not been initialized
+ *   or was destroyed while waiting.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the latch was already open.
+ */
+OS_RETURN_E latch_arrive_and_wait(latch_t* latch);
+
+#endif /* #ifndef __LIB_LATCH_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
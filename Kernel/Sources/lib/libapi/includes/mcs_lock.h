@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * @file mcs_lock.h
+ *
+ * @see mcs_lock.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 26/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief MCS queued spinlock implementation.
+ *
+ * @details MCS queued spinlock implementation. Each thread waiting for the lock
+ * spins on its own queue node instead of the shared lock word, the lock is
+ * handed over in FIFO order by the releasing thread. The queue node must stay
+ * valid until the lock is released and is usually allocated on the caller's
+ * stack.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __LIB_MCS_LOCK_H_
+#define __LIB_MCS_LOCK_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stddef.h>       /* Standard definitions */
+#include <stdint.h>       /* Generic int types */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Initial MCS lock value */
+#define MCS_LOCK_INIT_VALUE {NULL, 0, 0}
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief MCS lock queue node, one per thread acquiring the lock. */
+typedef struct mcs_node
+{
+    /** @brief Next thread's node in the waiting queue. */
+    struct mcs_node* volatile next;
+
+    /** @brief Set while the thread waits for the lock. */
+    volatile uint32_t locked;
+} mcs_node_t;
+
+/** @brief MCS lock structure definition. */
+typedef struct
+{
+    /** @brief Last node of the waiting queue, NULL if the lock is free. */
+    mcs_node_t* volatile tail;
+
+    /** @brief Number of times the lock was acquired. */
+    volatile uint32_t acquisitions;
+
+    /** @brief Number of acquisitions that had to wait for the lock. */
+    volatile uint32_t contentions;
+} mcs_lock_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the MCS lock.
+ *
+ * @param[out] lock The lock to initialize.
+ */
+void mcs_lock_init(mcs_lock_t* lock);
+
+/**
+ * @brief Locks the MCS lock.
+ *
+ * @details Locks the MCS lock. The calling thread is queued and spins on its
+ * own node until the previous owner hands the lock over.
+ *
+ * @param[in, out] lock The lock to acquire.
+ * @param[out] node The caller's queue node.
+ */
+void mcs_lock(mcs_lock_t* lock, mcs_node_t* node);
+
+/**
+ * @brief Tries to lock the MCS lock.
+ *
+ * @details Tries to lock the MCS lock. This function is non blocking, the lock
+ * is acquired only if it is free.
+ *
+ * @param[in, out] lock The lock to acquire.
+ * @param[out] node The caller's queue node.
+ *
+ * @return TRUE is returned if the lock was acquired, FALSE otherwise.
+ */
+bool_t mcs_trylock(mcs_lock_t* lock, mcs_node_t* node);
+
+/**
+ * @brief Unlocks the MCS lock.
+ *
+ * @details Unlocks the MCS lock and hands it over to the next queued thread.
+ *
+ * @param[in, out] lock The lock to release.
+ * @param[in, out] node The node used to acquire the lock.
+ */
+void mcs_unlock(mcs_lock_t* lock, mcs_node_t* node);
+
+/**
+ * @brief Disables the interrupts and locks the MCS lock.
+ *
+ * @details Disables the interrupts and locks the MCS lock. This must be used
+ * when the lock can also be acquired from an interrupt handler. A lock
+ * acquired with this function must always be acquired with interrupts
+ * disabled.
+ *
+ * @param[in, out] lock The lock to acquire.
+ * @param[out] node The caller's queue node.
+ *
+ * @return The interrupt state to give to mcs_unlock_irqrestore.
+ */
+uint32_t mcs_lock_irqsave(mcs_lock_t* lock, mcs_node_t* node);
+
+/**
+ * @brief Unlocks the MCS lock and restores the interrupts state.
+ *
+ * @param[in, out] lock The lock to release.
+ * @param[in, out] node The node used to acquire the lock.
+ * @param[in] int_state The interrupt state returned by mcs_lock_irqsave.
+ */
+void mcs_unlock_irqrestore(mcs_lock_t* lock,
+                           mcs_node_t* node,
+                           const uint32_t int_state);
+
+#endif /* #ifndef __LIB_MCS_LOCK_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -46,6 +46,17 @@
 /** @brief Mutex flags: priority elevation disabled flag. */
 #define MUTEX_PRIORITY_ELEVATION_NONE 0x0000FFFF
 
+/** @brief Mutex state unlocked. */
+#define MUTEX_STATE_UNLOCKED    0
+/** @brief Mutex state locked. */
+#define MUTEX_STATE_LOCKED      1
+/** @brief Mutex state locked with waiting threads. */
+#define MUTEX_STATE_LOCKED_WAIT 2
+/** @brief Mutex state waiting to be initialized. */
+#define MUTEX_STATE_WAIT_INIT   3
+/** @brief Mutex state destroyed. */
+#define MUTEX_STATE_DESTROYED   4
+
 /*******************************************************************************
  * STRUCTURES
  ******************************************************************************/
@@ -157,6 +168,25 @@ OS_RETURN_E mutex_destroy(mutex_t* mutex);
  */
 OS_RETURN_E mutex_lock(mutex_t* mutex);
 
+/**
+ * @brief Lock on the mutex given as parameter, assuming contention.
+ *
+ * @details Lock on the mutex given as parameter. The function will block the
+ * thread until it can aquire the mutex. Contrary to mutex_lock, the mutex is
+ * always acquired in the contended state, ensuring the next unlock wakes a
+ * waiting thread. This is used by threads that were requeued on the mutex
+ * without being woken, such as condition variable waiters.
+ *
+ * @param[in] mutex The mutex to lock on.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the mutex is NULL.
+ * - OS_ERR_MUTEX_UNINITIALIZED is returned if the mutex has not been
+ *   initialized.
+ */
+OS_RETURN_E mutex_lock_contended(mutex_t* mutex);
+
 /**
  * @brief Unlocks the mutex given as parameter.
  *
@@ -0,0 +1,229 @@
+/*******************************************************************************
+ * @file rwlock.h
+ *
+ * @see rwlock.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 20/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Reader-writer lock synchronization primitive.
+ *
+ * @details Reader-writer lock synchronization primitive implementation. The
+ * lock allows multiple concurrent readers or a single writer. The uncontended
+ * read lock is acquired with a single atomic addition, threads only call the
+ * kernel through the futex API when they have to wait. The lock can be
+ * configured to give the preference to writers, in which case new readers
+ * wait as long as a writer is waiting for the lock.
+ *
+ * @warning Reader-writer locks can only be used when the current system is
+ * running and the scheduler initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __LIB_RWLOCK_H_
+#define __LIB_RWLOCK_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stddef.h>       /* Standard definitions */
+#include <stdint.h>       /* Generic int types */
+#include <kernel_error.h> /* Kernel error API */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Reader-writer lock flags: empty flag, readers have the preference. */
+#define RWLOCK_FLAG_NONE              0x00000000
+/** @brief Reader-writer lock flags: writers have the preference. */
+#define RWLOCK_FLAG_WRITER_PREFERENCE 0x00000001
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Reader-writer lock structure definition. */
+typedef struct
+{
+    /**
+     * @brief Reader-writer lock state.
+     * @details The state is defined bitwise;
+     *  - [0-15]  = Number of readers holding the lock.
+     *  - [16-29] = Number of writers waiting for the lock.
+     *  - [30]    = Writer holding the lock.
+     *  - [31]    = Unused.
+     */
+    volatile int32_t state;
+
+    /** @brief Futex sequence the waiting readers wait on. */
+    volatile int32_t read_seq;
+
+    /** @brief Futex sequence the waiting writers wait on. */
+    volatile int32_t write_seq;
+
+    /** @brief Number of readers waiting for the lock. */
+    volatile int32_t waiting_readers;
+
+    /** @brief Reader-writer lock flags. */
+    uint32_t flags;
+
+    /** @brief Reader-writer lock initialization state. */
+    volatile bool_t init;
+} rwlock_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the reader-writer lock structure.
+ *
+ * @details Initializes the reader-writer lock structure. The lock is
+ * initialized unlocked.
+ *
+ * @param[out] rwlock The pointer to the reader-writer lock to initialize.
+ * @param[in] flags Reader-writer lock flags, see defines to get all the
+ * possible flags.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the lock to initialize is
+ *   NULL.
+ */
+OS_RETURN_E rwlock_init(rwlock_t* rwlock, const uint32_t flags);
+
+/**
+ * @brief Destroys the reader-writer lock given as parameter.
+ *
+ * @details Destroys the reader-writer lock given as parameter. Also unlocks all
+ * the threads waiting on this lock, they will return OS_ERR_NOT_INITIALIZED.
+ *
+ * @param[in, out] rwlock The reader-writer lock to destroy.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the lock is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the lock has not been initialized.
+ */
+OS_RETURN_E rwlock_destroy(rwlock_t* rwlock);
+
+/**
+ * @brief Acquires the reader-writer lock for reading.
+ *
+ * @details Acquires the reader-writer lock for reading. The calling thread will
+ * block until no writer holds the lock. If the lock gives the preference to
+ * writers, the thread also blocks while writers are waiting.
+ *
+ * @param[in, out] rwlock The reader-writer lock to acquire.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the lock is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the lock has not been initialized or
+ *   was destroyed while waiting.
+ */
+OS_RETURN_E rwlock_read_lock(rwlock_t* rwlock);
+
+/**
+ * @brief Releases the reader-writer lock acquired for reading.
+ *
+ * @param[in, out] rwlock The reader-writer lock to release.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the lock is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the lock has not been initialized.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the lock is not held by readers.
+ */
+OS_RETURN_E rwlock_read_unlock(rwlock_t* rwlock);
+
+/**
+ * @brief Tries to acquire the reader-writer lock for reading.
+ *
+ * @details Tries to acquire the reader-writer lock for reading. The function
+ * never blocks.
+ *
+ * @param[in, out] rwlock The reader-writer lock to acquire.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if the lock was acquired.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the lock could not be acquired.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the lock is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the lock has not been initialized.
+ */
+OS_RETURN_E rwlock_try_read_lock(rwlock_t* rwlock);
+
+/**
+ * @brief Acquires the reader-writer lock for writing.
+ *
+ * @details Acquires the reader-writer lock for writing. The calling thread will
+ * block until no reader nor writer holds the lock.
+ *
+ * @param[in, out] rwlock The reader-writer lock to acquire.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the lock is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the lock has not been initialized or
+ *   was destroyed while waiting.
+ */
+OS_RETURN_E rwlock_write_lock(rwlock_t* rwlock);
+
+/**
+ * @brief Releases the reader-writer lock acquired for writing.
+ *
+ * @param[in, out] rwlock The reader-writer lock to release.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the lock is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the lock has not been initialized.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the lock is not held by a
+ *   writer.
+ */
+OS_RETURN_E rwlock_write_unlock(rwlock_t* rwlock);
+
+/**
+ * @brief Tries to acquire the reader-writer lock for writing.
+ *
+ * @details Tries to acquire the reader-writer lock for writing. The function
+ * never blocks.
+ *
+ * @param[in, out] rwlock The reader-writer lock to acquire.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if the lock was acquired.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the lock could not be acquired.
+ * - OS_ERR_NULL_POINTER is returned if the pointer to the lock is NULL.
+ * - OS_ERR_NOT_INITIALIZED is returned if the lock has not been initialized.
+ */
+OS_RETURN_E rwlock_try_write_lock(rwlock_t* rwlock);
+
+#endif /* #ifndef __LIB_RWLOCK_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
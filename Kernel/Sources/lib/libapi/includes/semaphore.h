@@ -7,13 +7,16 @@
  *
  * @date 15/12/2021
  *
- * @version 3.0
+ * @version 4.0
  *
  * @brief Semaphore synchronization primitive.
  *
  * @details Semaphore synchronization primitive implemantation.
  * The semaphore are used to synchronyse the threads. The semaphore waiting list
  * is a FIFO with no regards of the waiting threads priority.
+ * The semaphore level and its waiters count share a single word, uncontended
+ * pend and post operations are a single atomic operation. The kernel futex is
+ * only used when a thread has to block or be woken up.
  *
  * @warning Semaphores can only be used when the current system is running and
  * the scheduler initialized.
@@ -30,13 +33,20 @@
 
 #include <stddef.h> /* Standard definitions */
 #include <stdint.h> /* Generic int types */
-#include <atomic.h> /* Spinlock */
+#include <atomic.h> /* Atomic operations */
 
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Minimal level a semaphore can hold. */
+#define SEM_LEVEL_MIN -32768
+
+/** @brief Maximal level a semaphore can hold. */
+#define SEM_LEVEL_MAX 32767
+
+/** @brief Maximal number of threads that can wait on a semaphore. */
+#define SEM_MAX_WAITING_THREAD 0x7FFF
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -45,17 +55,16 @@
 /** @brief Semaphore structure definition. */
 typedef struct
 {
-    /** @brief Semaphore level counter */
-    volatile int32_t level;
-
-    /** @brief Semaphore waiters counter */
-    volatile int32_t waiters;
-
-    /** @brief Semaphore lock. */
-    spinlock_t lock;
+    /**
+     * @brief Semaphore state, the low 16 bits hold the level biased by
+     * 0x8000, the next 15 bits hold the waiters counter and the high bit is
+     * set when the semaphore is destroyed. The waiting threads wait on this
+     * word.
+     */
+    volatile int32_t state;
 
     /** @brief Semaphore initialization state. */
-    bool_t init;
+    volatile bool_t init;
 } semaphore_t;
 
 /*******************************************************************************
@@ -94,6 +103,8 @@ typedef struct
  * - OS_NO_ERR is returned if no error is encountered.
  * - OS_ERR_NULL_POINTER is returned if the pointer to the semaphore to
  *   initialize is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the initial level is not between
+ *   SEM_LEVEL_MIN and SEM_LEVEL_MAX.
  */
 OS_RETURN_E sem_init(semaphore_t* sem, const int32_t init_level);
 
@@ -118,7 +129,8 @@ OS_RETURN_E sem_destroy(semaphore_t* sem);
  * @brief Pends on the semaphore given as parameter.
  *
  * @details Pends on the semaphore given as parameter. The calling thread will
- * block on this call until the semaphore is aquired.
+ * block on this call until the semaphore is aquired. When the semaphore level
+ * is positive, the semaphore is acquired without any system call.
  *
  * @param[in] sem The semaphore to pend.
  *
@@ -134,6 +146,9 @@ OS_RETURN_E sem_pend(semaphore_t* sem);
 /**
  * @brief Post the semaphore given as parameter.
  *
+ * @details Post the semaphore given as parameter. The kernel is only called
+ * when threads are waiting on the semaphore.
+ *
  * @param[in] sem The semaphore to post.
  *
  * @return The success state or the error code.
@@ -142,6 +157,8 @@ OS_RETURN_E sem_pend(semaphore_t* sem);
  *   is NULL.
  * - OS_ERR_SEM_UNINITIALIZED is returned if the semaphore has not been
  *   initialized.
+ * - OS_ERR_OUT_OF_BOUND is returned if the semaphore level would exceed
+ *   SEM_LEVEL_MAX.
  */
 OS_RETURN_E sem_post(semaphore_t* sem);
 
@@ -103,6 +103,26 @@ int32_t waitpid(const int32_t pid,
  */
 void exit(int32_t ret_value);
 
+/**
+ * @brief Returns the current process identifier.
+ *
+ * @details Returns the current process identifier. The value is read from the
+ * kernel shared data page, no system call is raised.
+ *
+ * @return The current process identifier.
+ */
+int32_t getpid(void);
+
+/**
+ * @brief Returns the calling thread identifier.
+ *
+ * @details Returns the calling thread identifier. The value is read from the
+ * kernel shared data page, no system call is raised.
+ *
+ * @return The calling thread identifier.
+ */
+int32_t gettid(void);
+
 #endif /* #ifndef __LIB_PROCESS_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -87,6 +87,29 @@ typedef struct
     OS_RETURN_E error;
 } sched_param_t;
 
+/** @brief Scheduling statistics system call parameters.*/
+typedef struct
+{
+    /** @brief The tid of the thread to get the statistics of, -1 for the
+     * calling thread. The thread must belong to the calling process.
+     */
+    int32_t tid;
+
+    /** @brief The priority to get the wake up latency histogram of. */
+    uint32_t priority;
+
+    /** @brief Receives the statistics of the thread. */
+    thread_stats_t thread_stats;
+
+    /** @brief Receives the wake up latency histogram of the priority, see
+     * SCHED_LATENCY_BUCKETS.
+     */
+    uint32_t latency[SCHED_LATENCY_BUCKETS];
+
+    /** @brief Receives the system call error status. */
+    OS_RETURN_E error;
+} sched_stats_param_t;
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -124,6 +147,70 @@ typedef struct
  */
 OS_RETURN_E syscall_do(const SYSCALL_FUNCTION_E func, void* params);
 
+/**
+ * @brief Initializes a system call ring and registers it for the calling
+ * thread.
+ *
+ * @details Initializes a system call ring and registers it for the calling
+ * thread. The ring must stay valid until the thread registers another ring or
+ * exits.
+ *
+ * @param[out] ring The ring to initialize.
+ *
+ * @return OS_NO_ERR is returned on success. Otherwise an error is returned.
+ */
+OS_RETURN_E syscall_ring_init(syscall_ring_t* ring);
+
+/**
+ * @brief Queues a system call in the ring.
+ *
+ * @details Queues a system call in the ring. The system call is executed on
+ * the next call to syscall_ring_submit. No system call is raised.
+ *
+ * @param[in, out] ring The ring to use.
+ * @param[in] func The system call ID to queue.
+ * @param[in, out] params The system call parameters, they must stay valid until
+ * the completion is posted.
+ * @param[in] user_data Caller's data reported in the completion entry.
+ *
+ * @return OS_NO_ERR is returned on success, OS_ERR_OUT_OF_BOUND is returned if
+ * the submission queue is full. Otherwise an error is returned.
+ */
+OS_RETURN_E syscall_ring_push(syscall_ring_t* ring,
+                              const SYSCALL_FUNCTION_E func,
+                              void* params,
+                              const uint32_t user_data);
+
+/**
+ * @brief Executes all the queued system calls of the ring.
+ *
+ * @details Executes all the queued system calls of the ring in order with a
+ * single system call.
+ *
+ * @param[in, out] ring The ring to use, must be the calling thread's
+ * registered ring.
+ * @param[out] processed The buffer receiving the number of executed system
+ * calls, can be NULL.
+ *
+ * @return OS_NO_ERR is returned on success. Otherwise an error is returned.
+ */
+OS_RETURN_E syscall_ring_submit(syscall_ring_t* ring, uint32_t* processed);
+
+/**
+ * @brief Retreives the next completion entry of the ring.
+ *
+ * @details Retreives the next completion entry of the ring. This function
+ * only reads the shared ring and never raises a system call.
+ *
+ * @param[in, out] ring The ring to use.
+ * @param[out] cqe The buffer receiving the completion entry.
+ *
+ * @return OS_NO_ERR is returned if a completion was retreived,
+ * OS_ERR_NO_SUCH_ID is returned if no completion is pending. Otherwise an error
+ * is returned.
+ */
+OS_RETURN_E syscall_ring_poll(syscall_ring_t* ring, syscall_ring_cqe_t* cqe);
+
 #endif /* #ifndef __LIB_SYSCALL_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,216 @@
+/***************************************************************************//**
+ * @file barrier.c
+ *
+ * @see barrier.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 27/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Barrier synchronization primitive.
+ *
+ * @details Barrier synchronization primitive implementation. The threads
+ * count their arrival with an atomic addition and wait on the barrier
+ * generation. The last arriving thread resets the arrival counter, starts a
+ * new generation and wakes all the waiting threads at once.
+ *
+ * @warning Barriers can only be used when the current system is running and
+ * the scheduler initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <atomic.h>          /* Atomic operations */
+#include <kernel_output.h>   /* Kernel outputs */
+#include <kernel_error.h>    /* Kernel errors */
+#include <futex.h>           /* Futex API */
+#include <sys/syscall_api.h> /* System calls API */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <barrier.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Defines the maximal number of threads waiting on the barrier. */
+#define BARRIER_MAX_WAITING_THREAD 0xFFFFFFFF
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Wakes all the threads waiting on the barrier.
+ *
+ * @param[in, out] barrier The barrier.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E barrier_wake(barrier_t* barrier);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E barrier_wake(barrier_t* barrier)
+{
+    futex_t futex;
+
+    futex.addr = (uint32_t*)&barrier->generation;
+    futex.val  = BARRIER_MAX_WAITING_THREAD;
+    syscall_do(SYSCALL_FUTEX_WAKE, &futex);
+
+    /* No thread blocked yet, they will see the new generation */
+    if(futex.error == OS_ERR_NO_SUCH_ID)
+    {
+        return OS_NO_ERR;
+    }
+
+    return futex.error;
+}
+
+OS_RETURN_E barrier_init(barrier_t* barrier, const int32_t count)
+{
+    if(barrier == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(count <= 0)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    barrier->generation = 0;
+    barrier->arrived    = 0;
+    barrier->count      = count;
+    barrier->init       = TRUE;
+
+    KERNEL_DEBUG(BARRIER_DEBUG_ENABLED, "BARRIER",
+                 "Barrier 0x%p initialized for %d threads", barrier, count);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E barrier_destroy(barrier_t* barrier)
+{
+    if(barrier == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(barrier->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    barrier->init = FALSE;
+
+    ATOMIC_FETCH_ADD(&barrier->generation, 1);
+
+    KERNEL_DEBUG(BARRIER_DEBUG_ENABLED, "BARRIER", "Barrier 0x%p destroyed",
+                 barrier);
+
+    return barrier_wake(barrier);
+}
+
+OS_RETURN_E barrier_wait(barrier_t* barrier, bool_t* serial)
+{
+    futex_t futex;
+    int32_t generation;
+
+    if(barrier == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(barrier->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    if(serial != NULL)
+    {
+        *serial = FALSE;
+    }
+
+    /* The generation cannot change before we arrive, read it first */
+    generation = barrier->generation;
+
+    if(ATOMIC_FETCH_ADD(&barrier->arrived, 1) + 1 == barrier->count)
+    {
+        /* Last thread, open the barrier. The counter is reset before the new
+         * generation starts so that the released threads can reuse the
+         * barrier straight away.
+         */
+        ATOMIC_STORE(&barrier->arrived, 0);
+        ATOMIC_FETCH_ADD(&barrier->generation, 1);
+
+        if(serial != NULL)
+        {
+            *serial = TRUE;
+        }
+
+        KERNEL_DEBUG(BARRIER_DEBUG_ENABLED, "BARRIER",
+                     "Barrier 0x%p released generation %d",
+                     barrier, generation);
+
+        return barrier_wake(barrier);
+    }
+
+    /* Wait for the generation to change */
+    while(barrier->generation == generation)
+    {
+        futex.addr = (uint32_t*)&barrier->generation;
+        futex.val  = generation;
+        syscall_do(SYSCALL_FUTEX_WAIT, &futex);
+
+        if(futex.error != OS_NO_ERR)
+        {
+            return futex.error;
+        }
+    }
+
+    if(barrier->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,291 @@
+/***************************************************************************//**
+ * @file cond.c
+ *
+ * @see cond.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 20/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Condition variable synchronization primitive.
+ *
+ * @details Condition variable synchronization primitive implementation. The
+ * waiting threads wait on a sequence counter that is incremented on each
+ * signal. On broadcast, the kernel futex requeue is used to move the waiting
+ * threads to the mutex wait queue instead of waking them all at once.
+ *
+ * @warning Condition variables can only be used when the current system is
+ * running and the scheduler initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <atomic.h>          /* Atomic operations */
+#include <kernel_output.h>   /* Kernel outputs */
+#include <kernel_error.h>    /* Kernel errors */
+#include <futex.h>           /* Futex API */
+#include <mutex.h>           /* Mutex API */
+#include <sys/syscall_api.h> /* System calls API */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <cond.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Defines the maximal number of threads waiting on the condition. */
+#define COND_MAX_WAITING_THREAD 0xFFFFFFFF
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Wakes threads waiting on the condition.
+ *
+ * @param[in, out] cond The condition variable.
+ * @param[in] count The maximal number of threads to wake.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E cond_wake(cond_t* cond, const uint32_t count);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E cond_wake(cond_t* cond, const uint32_t count)
+{
+    futex_t futex;
+
+    futex.addr = (uint32_t*)&cond->seq;
+    futex.val  = count;
+    syscall_do(SYSCALL_FUTEX_WAKE, &futex);
+
+    /* A waiter might not have reached the futex yet, it will see the new
+     * sequence value and will not block.
+     */
+    if(futex.error == OS_ERR_NO_SUCH_ID)
+    {
+        return OS_NO_ERR;
+    }
+
+    return futex.error;
+}
+
+OS_RETURN_E cond_init(cond_t* cond)
+{
+    if(cond == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    cond->seq     = 0;
+    cond->waiters = 0;
+    cond->mutex   = NULL;
+    cond->init    = TRUE;
+
+    KERNEL_DEBUG(COND_DEBUG_ENABLED, "COND", "Cond 0x%p initialized", cond);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E cond_destroy(cond_t* cond)
+{
+    if(cond == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(cond->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    cond->init = FALSE;
+
+    ATOMIC_FETCH_ADD(&cond->seq, 1);
+
+    KERNEL_DEBUG(COND_DEBUG_ENABLED, "COND", "Cond 0x%p destroyed", cond);
+
+    return cond_wake(cond, COND_MAX_WAITING_THREAD);
+}
+
+OS_RETURN_E cond_wait(cond_t* cond, mutex_t* mutex)
+{
+    OS_RETURN_E err;
+    futex_t     futex;
+
+    if(cond == NULL || mutex == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(cond->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    /* Bind the mutex to the condition */
+    if(cond->mutex == NULL)
+    {
+        cond->mutex = mutex;
+    }
+    else if(cond->mutex != mutex)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* Get the sequence before releasing the mutex, any signal sent after
+     * this point will make the wait return.
+     */
+    futex.addr = (uint32_t*)&cond->seq;
+    futex.val  = cond->seq;
+
+    ATOMIC_FETCH_ADD(&cond->waiters, 1);
+
+    err = mutex_unlock(mutex);
+    if(err != OS_NO_ERR)
+    {
+        ATOMIC_FETCH_ADD(&cond->waiters, -1);
+        return err;
+    }
+
+    syscall_do(SYSCALL_FUTEX_WAIT, &futex);
+
+    ATOMIC_FETCH_ADD(&cond->waiters, -1);
+
+    /* We might have been requeued on the mutex, other threads can wait on it,
+     * lock it in contended state.
+     */
+    err = mutex_lock_contended(mutex);
+
+    if(futex.error != OS_NO_ERR)
+    {
+        return futex.error;
+    }
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    if(cond->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    KERNEL_DEBUG(COND_DEBUG_ENABLED, "COND", "Cond 0x%p woken", cond);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E cond_signal(cond_t* cond)
+{
+    if(cond == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(cond->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    ATOMIC_FETCH_ADD(&cond->seq, 1);
+
+    if(cond->waiters == 0)
+    {
+        return OS_NO_ERR;
+    }
+
+    KERNEL_DEBUG(COND_DEBUG_ENABLED, "COND", "Cond 0x%p signaled", cond);
+
+    return cond_wake(cond, 1);
+}
+
+OS_RETURN_E cond_broadcast(cond_t* cond)
+{
+    futex_requeue_t requeue;
+    mutex_t*        mutex;
+
+    if(cond == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(cond->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    ATOMIC_FETCH_ADD(&cond->seq, 1);
+
+    if(cond->waiters == 0)
+    {
+        return OS_NO_ERR;
+    }
+
+    KERNEL_DEBUG(COND_DEBUG_ENABLED, "COND", "Cond 0x%p broadcasted", cond);
+
+    mutex = cond->mutex;
+    if(mutex != NULL)
+    {
+        /* Mark the mutex as contended, its next release will then wake one of
+         * the requeued threads. If the mutex is not locked the requeue fails
+         * and all the threads are woken.
+         */
+        ATOMIC_CAS(&mutex->state, MUTEX_STATE_LOCKED, MUTEX_STATE_LOCKED_WAIT);
+
+        requeue.addr          = (uint32_t*)&cond->seq;
+        requeue.wake_count    = 1;
+        requeue.requeue_addr  = (uint32_t*)&mutex->state;
+        requeue.requeue_val   = MUTEX_STATE_LOCKED_WAIT;
+        requeue.requeue_count = COND_MAX_WAITING_THREAD;
+        syscall_do(SYSCALL_FUTEX_REQUEUE, &requeue);
+
+        if(requeue.error == OS_NO_ERR || requeue.error == OS_ERR_NO_SUCH_ID)
+        {
+            return OS_NO_ERR;
+        }
+        if(requeue.error != OS_ERR_INCORRECT_VALUE)
+        {
+            return requeue.error;
+        }
+    }
+
+    return cond_wake(cond, COND_MAX_WAITING_THREAD);
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,251 @@
+/***************************************************************************//**
+ * @file latch.c
+ *
+ * @see latch.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 27/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Latch synchronization primitive.
+ *
+ * @details Latch synchronization primitive implementation. The waiting
+ * threads wait on the latch counter itself. The thread bringing the counter to
+ * zero wakes all the waiting threads at once.
+ *
+ * @warning Latches can only be used when the current system is running and
+ * the scheduler initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <atomic.h>          /* Atomic operations */
+#include <kernel_output.h>   /* Kernel outputs */
+#include <kernel_error.h>    /* Kernel errors */
+#include <futex.h>           /* Futex API */
+#include <sys/syscall_api.h> /* System calls API */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <latch.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Defines the maximal number of threads waiting on the latch. */
+#define LATCH_MAX_WAITING_THREAD 0xFFFFFFFF
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Wakes all the threads waiting on the latch.
+ *
+ * @param[in, out] latch The latch.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E latch_wake(latch_t* latch);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E latch_wake(latch_t* latch)
+{
+    futex_t futex;
+
+    futex.addr = (uint32_t*)&latch->count;
+    futex.val  = LATCH_MAX_WAITING_THREAD;
+    syscall_do(SYSCALL_FUTEX_WAKE, &futex);
+
+    /* Nobody waits on the latch */
+    if(futex.error == OS_ERR_NO_SUCH_ID)
+    {
+        return OS_NO_ERR;
+    }
+
+    return futex.error;
+}
+
+OS_RETURN_E latch_init(latch_t* latch, const int32_t count)
+{
+    if(latch == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(count < 0)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    latch->count = count;
+    latch->init  = TRUE;
+
+    KERNEL_DEBUG(LATCH_DEBUG_ENABLED, "LATCH",
+                 "Latch 0x%p initialized with %d", latch, count);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E latch_destroy(latch_t* latch)
+{
+    if(latch == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(latch->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    latch->init = FALSE;
+
+    /* Open the latch, the woken threads check the initialization state */
+    ATOMIC_STORE(&latch->count, 0);
+
+    KERNEL_DEBUG(LATCH_DEBUG_ENABLED, "LATCH", "Latch 0x%p destroyed", latch);
+
+    return latch_wake(latch);
+}
+
+OS_RETURN_E latch_count_down(latch_t* latch)
+{
+    int32_t prev;
+
+    if(latch == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(latch->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    /* Never let the counter go below zero */
+    do
+    {
+        prev = latch->count;
+        if(prev <= 0)
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+    } while(ATOMIC_CAS(&latch->count, prev, prev - 1) != prev);
+
+    if(prev != 1)
+    {
+        return OS_NO_ERR;
+    }
+
+    KERNEL_DEBUG(LATCH_DEBUG_ENABLED, "LATCH", "Latch 0x%p open", latch);
+
+    return latch_wake(latch);
+}
+
+OS_RETURN_E latch_wait(latch_t* latch)
+{
+    futex_t futex;
+    int32_t count;
+
+    if(latch == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(latch->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    while((count = latch->count) > 0)
+    {
+        futex.addr = (uint32_t*)&latch->count;
+        futex.val  = count;
+        syscall_do(SYSCALL_FUTEX_WAIT, &futex);
+
+        if(futex.error != OS_NO_ERR)
+        {
+            return futex.error;
+        }
+    }
+
+    if(latch->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E latch_try_wait(latch_t* latch, int32_t* value)
+{
+    int32_t count;
+
+    if(latch == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(latch->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    count = latch->count;
+    if(value != NULL)
+    {
+        *value = count;
+    }
+
+    return (count > 0) ? OS_ERR_UNAUTHORIZED_ACTION : OS_NO_ERR;
+}
+
+OS_RETURN_E latch_arrive_and_wait(latch_t* latch)
+{
+    OS_RETURN_E err;
+
+    err = latch_count_down(latch);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    return latch_wait(latch);
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
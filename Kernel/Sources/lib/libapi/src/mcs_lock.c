@@ -0,0 +1,168 @@
+/***************************************************************************//**
+ * @file mcs_lock.c
+ *
+ * @see mcs_lock.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 26/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief MCS queued spinlock implementation.
+ *
+ * @details MCS queued spinlock implementation. The lock only contains the tail
+ * of the waiting queue. A thread joins the queue by swapping its node with the
+ * tail, then spins on its node's flag that the previous owner clears when
+ * releasing the lock. Waiting threads never write the shared lock word.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <atomic.h>          /* Atomic operations */
+#include <cpu_api.h>         /* CPU API */
+#include <critical.h>        /* Kernel critical sections */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <mcs_lock.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+void mcs_lock_init(mcs_lock_t* lock)
+{
+    lock->tail         = NULL;
+    lock->acquisitions = 0;
+    lock->contentions  = 0;
+}
+
+void mcs_lock(mcs_lock_t* lock, mcs_node_t* node)
+{
+    mcs_node_t* prev;
+
+    node->next   = NULL;
+    node->locked = 1;
+
+    /* Enqueue our node */
+    prev = (mcs_node_t*)ATOMIC_SWAP((volatile int32_t*)&lock->tail,
+                                    (int32_t)node);
+    if(prev != NULL)
+    {
+        /* Link to the previous node and wait for the hand over */
+        prev->next = node;
+        while(node->locked != 0)
+        {
+            cpu_pause();
+        }
+        ++lock->contentions;
+    }
+
+    ++lock->acquisitions;
+}
+
+bool_t mcs_trylock(mcs_lock_t* lock, mcs_node_t* node)
+{
+    node->next   = NULL;
+    node->locked = 0;
+
+    if(ATOMIC_CAS((volatile int32_t*)&lock->tail,
+                  (int32_t)NULL,
+                  (int32_t)node) != (int32_t)NULL)
+    {
+        return FALSE;
+    }
+
+    ++lock->acquisitions;
+
+    return TRUE;
+}
+
+void mcs_unlock(mcs_lock_t* lock, mcs_node_t* node)
+{
+    if(node->next == NULL)
+    {
+        /* No known successor, release the lock if we are still the tail */
+        if(ATOMIC_CAS((volatile int32_t*)&lock->tail,
+                      (int32_t)node,
+                      (int32_t)NULL) == (int32_t)node)
+        {
+            return;
+        }
+
+        /* A thread is enqueuing, wait for it to link itself */
+        while(node->next == NULL)
+        {
+            cpu_pause();
+        }
+    }
+
+    /* Hand over the lock */
+    node->next->locked = 0;
+}
+
+uint32_t mcs_lock_irqsave(mcs_lock_t* lock, mcs_node_t* node)
+{
+    uint32_t int_state;
+
+    ENTER_CRITICAL(int_state);
+    mcs_lock(lock, node);
+
+    return int_state;
+}
+
+void mcs_unlock_irqrestore(mcs_lock_t* lock,
+                           mcs_node_t* node,
+                           const uint32_t int_state)
+{
+    mcs_unlock(lock, node);
+    EXIT_CRITICAL(int_state);
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
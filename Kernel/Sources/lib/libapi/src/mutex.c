@@ -37,6 +37,7 @@
 #include <futex.h>           /* Futex API */
 #include <sys/process.h>     /* Process and threads management API */
 #include <sys/syscall_api.h> /* System calls API */
+#include <vdso.h>            /* Kernel shared data page */
 
 /* Configuration files */
 #include <config.h>
@@ -49,17 +50,6 @@
  * CONSTANTS
  ******************************************************************************/
 
-/** @brief Mutex state unlocked. */
-#define MUTEX_STATE_UNLOCKED    0
-/** @brief Mutex state locked. */
-#define MUTEX_STATE_LOCKED      1
-/** @brief Mutex state locked with waiting threads. */
-#define MUTEX_STATE_LOCKED_WAIT 2
-/** @brief Mutex state waiting to be initialized. */
-#define MUTEX_STATE_WAIT_INIT   3
-/** @brief Mutex state destroyed. */
-#define MUTEX_STATE_DESTROYED   4
-
 /** @brief Defines the maximal number of threads locked on the mutex. */
 #define MUTEX_MAX_LOCKED_THREAD 0xFFFFFFFF
 
@@ -92,7 +82,20 @@
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
 
-/* None */
+/**
+ * @brief Lock on the mutex given as parameter.
+ *
+ * @details Lock on the mutex given as parameter. The function will block the
+ * thread until it can aquire the mutex. The lock state used when the mutex is
+ * acquired without contention is given as parameter.
+ *
+ * @param[in] mutex The mutex to lock on.
+ * @param[in] lock_state The state to set when acquiring an unlocked mutex,
+ * either MUTEX_STATE_LOCKED or MUTEX_STATE_LOCKED_WAIT.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E mutex_lock_state(mutex_t* mutex, const int32_t lock_state);
 
 /*******************************************************************************
  * FUNCTIONS
@@ -102,8 +105,6 @@ OS_RETURN_E mutex_init(mutex_t* mutex,
                        const uint32_t flags,
                        const uint16_t priority)
 {
-    sched_param_t sched_params;
-
     if(mutex == NULL)
     {
         return OS_ERR_NULL_POINTER;
@@ -121,13 +122,7 @@ OS_RETURN_E mutex_init(mutex_t* mutex,
 
     mutex->flags      = flags | priority << 8;
 
-    syscall_do(SYSCALL_SCHED_GET_PARAMS, &sched_params);
-    if(sched_params.error != OS_NO_ERR)
-    {
-        return sched_params.error;
-    }
-
-    mutex->owner = sched_params.tid;
+    mutex->owner = vdso_get_tid();
     mutex->state = MUTEX_STATE_UNLOCKED;
 
     KERNEL_DEBUG(MUTEX_DEBUG_ENABLED, "MUTEX", "Mutex 0x%p initialized", mutex);
@@ -167,15 +162,22 @@ OS_RETURN_E mutex_destroy(mutex_t* mutex)
 
     KERNEL_DEBUG(MUTEX_DEBUG_ENABLED, "MUTEX", "Mutex 0x%p destroyed", mutex);
 
+    /* No thread was waiting on the mutex */
+    if(futex.error == OS_ERR_NO_SUCH_ID)
+    {
+        return OS_NO_ERR;
+    }
+
     return futex.error;
 }
 
-OS_RETURN_E mutex_lock(mutex_t* mutex)
+static OS_RETURN_E mutex_lock_state(mutex_t* mutex, const int32_t lock_state)
 {
     OS_RETURN_E   err;
     uint32_t      prio;
     uint32_t      recursive;
     int32_t       mutex_state;
+    int32_t       tid;
     sched_param_t sched_params;
     futex_t       futex;
 
@@ -196,21 +198,15 @@ OS_RETURN_E mutex_lock(mutex_t* mutex)
         return OS_ERR_NOT_INITIALIZED;
     }
 
-    /* Prepare data in case of specific parameters */
+    /* Prepare data in case of specific parameters, the thread identity is
+     * read from the kernel shared data page
+     */
     prio = (mutex->flags >> 8) & MUTEX_PRIORITY_ELEVATION_NONE;
     recursive = mutex->flags & MUTEX_FLAG_RECURSIVE;
-    if(prio != MUTEX_PRIORITY_ELEVATION_NONE || recursive != 0)
-    {
-        syscall_do(SYSCALL_SCHED_GET_PARAMS, &sched_params);
-
-        if(sched_params.error != OS_NO_ERR)
-        {
-            return sched_params.error;
-        }
-    }
+    tid = vdso_get_tid();
 
     /* If the current thread is the mutex's locked, just return */
-    if(recursive != 0 && sched_params.tid == mutex->locker_tid)
+    if(recursive != 0 && tid == mutex->locker_tid)
     {
         return OS_NO_ERR;
     }
@@ -218,7 +214,7 @@ OS_RETURN_E mutex_lock(mutex_t* mutex)
     /* Get mutex state */
     mutex_state = ATOMIC_CAS(&mutex->state,
                              MUTEX_STATE_UNLOCKED,
-                             MUTEX_STATE_LOCKED);
+                             lock_state);
     if(mutex_state != MUTEX_STATE_UNLOCKED)
     {
         do
@@ -259,13 +255,13 @@ OS_RETURN_E mutex_lock(mutex_t* mutex)
     /* We aquired the mutex, set the relevant information */
     if(recursive != 0)
     {
-        mutex->locker_tid = sched_params.tid;
+        mutex->locker_tid = tid;
     }
 
     /* Set the inherited priority */
     if(prio != MUTEX_PRIORITY_ELEVATION_NONE)
     {
-        mutex->acquired_thread_priority = sched_params.priority;
+        mutex->acquired_thread_priority = vdso_get_priority();
 
         sched_params.priority = prio >> 8;
         syscall_do(SYSCALL_SCHED_SET_PARAMS, &sched_params);
@@ -288,6 +284,16 @@ OS_RETURN_E mutex_lock(mutex_t* mutex)
     return OS_NO_ERR;
 }
 
+OS_RETURN_E mutex_lock(mutex_t* mutex)
+{
+    return mutex_lock_state(mutex, MUTEX_STATE_LOCKED);
+}
+
+OS_RETURN_E mutex_lock_contended(mutex_t* mutex)
+{
+    return mutex_lock_state(mutex, MUTEX_STATE_LOCKED_WAIT);
+}
+
 OS_RETURN_E mutex_unlock(mutex_t* mutex)
 {
     uint32_t      prio;
@@ -317,12 +323,6 @@ OS_RETURN_E mutex_unlock(mutex_t* mutex)
     if(prio != MUTEX_PRIORITY_ELEVATION_NONE)
     {
         /* Update the thread priority */
-        syscall_do(SYSCALL_SCHED_GET_PARAMS, &sched_params);
-        if(sched_params.error != OS_NO_ERR)
-        {
-            return sched_params.error;
-        }
-
         sched_params.priority = mutex->acquired_thread_priority;
 
         syscall_do(SYSCALL_SCHED_SET_PARAMS, &sched_params);
@@ -343,7 +343,11 @@ OS_RETURN_E mutex_unlock(mutex_t* mutex)
         futex.addr = (uint32_t*)&mutex->state;
         futex.val  = 1;
         syscall_do(SYSCALL_FUTEX_WAKE, &futex);
-        if(futex.error != OS_NO_ERR)
+
+        /* The mutex might have been marked as contended while no thread was
+         * actually waiting on it.
+         */
+        if(futex.error != OS_NO_ERR && futex.error != OS_ERR_NO_SUCH_ID)
         {
             return futex.error;
         }
@@ -367,6 +371,7 @@ OS_RETURN_E mutex_trylock(mutex_t* mutex, int32_t* value)
     uint32_t    prio;
     uint32_t    recursive;
     int32_t     mutex_state;
+    int32_t     tid;
 
     sched_param_t sched_params;
 
@@ -387,21 +392,15 @@ OS_RETURN_E mutex_trylock(mutex_t* mutex, int32_t* value)
         return OS_ERR_NOT_INITIALIZED;
     }
 
-    /* Prepare data in case of specific parameters */
+    /* Prepare data in case of specific parameters, the thread identity is
+     * read from the kernel shared data page
+     */
     prio = (mutex->flags >> 8) & MUTEX_PRIORITY_ELEVATION_NONE;
     recursive = mutex->flags & MUTEX_FLAG_RECURSIVE;
-    if(prio != MUTEX_PRIORITY_ELEVATION_NONE || recursive != 0)
-    {
-        syscall_do(SYSCALL_SCHED_GET_PARAMS, &sched_params);
-
-        if(sched_params.error != OS_NO_ERR)
-        {
-            return sched_params.error;
-        }
-    }
+    tid = vdso_get_tid();
 
     /* If the current thread is the mutex's locked, just return */
-    if(recursive != 0 && sched_params.tid == mutex->locker_tid)
+    if(recursive != 0 && tid == mutex->locker_tid)
     {
         return OS_NO_ERR;
     }
@@ -420,13 +419,13 @@ OS_RETURN_E mutex_trylock(mutex_t* mutex, int32_t* value)
     /* We aquired the mutex, set the relevant information */
     if(recursive != 0)
     {
-        mutex->locker_tid = sched_params.tid;
+        mutex->locker_tid = tid;
     }
 
     /* Set the inherited priority */
     if(prio != MUTEX_PRIORITY_ELEVATION_NONE)
     {
-        mutex->acquired_thread_priority = sched_params.priority;
+        mutex->acquired_thread_priority = vdso_get_priority();
 
         sched_params.priority = prio >> 8;
         syscall_do(SYSCALL_SCHED_SET_PARAMS, &sched_params);
@@ -26,6 +26,7 @@
 #include <stdint.h>          /* Generic int types */
 #include <scheduler.h>       /* Scheduler */
 #include <sys/syscall_api.h> /* Syscall API */
+#include <vdso.h>            /* Kernel shared data page */
 
 /* Configuration files */
 #include <config.h>
@@ -117,4 +118,15 @@ void exit(int32_t ret_value)
 {
     syscall_do(SYSCALL_EXIT, (void*)ret_value);
 }
+
+int32_t getpid(void)
+{
+    return vdso_get_pid();
+}
+
+int32_t gettid(void)
+{
+    return vdso_get_tid();
+}
+
 /************************************ EOF *************************************/
\ No newline at end of file
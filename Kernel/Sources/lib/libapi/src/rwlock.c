@@ -0,0 +1,474 @@
+/***************************************************************************//**
+ * @file rwlock.c
+ *
+ * @see rwlock.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 20/03/2022
+ *
+ * @version 1.0
+ *
+ * @brief Reader-writer lock synchronization primitive.
+ *
+ * @details Reader-writer lock synchronization primitive implementation. The
+ * lock state is a single word containing the number of readers, the number of
+ * waiting writers and the writer bit. Readers and writers wait on two distinct
+ * futex sequence counters. A thread releasing the lock increments the
+ * sequence before waking the waiters, ensuring a thread that checked the lock
+ * state before the release does not sleep on a stale value.
+ *
+ * @warning Reader-writer locks can only be used when the current system is
+ * running and the scheduler initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <atomic.h>          /* Atomic operations */
+#include <kernel_output.h>   /* Kernel outputs */
+#include <kernel_error.h>    /* Kernel errors */
+#include <futex.h>           /* Futex API */
+#include <sys/syscall_api.h> /* System calls API */
+
+/* Configuration files */
+#include <config.h>
+#include <test_bank.h>
+
+/* Header file */
+#include <rwlock.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Reader count increment in the lock state. */
+#define RWLOCK_READER_UNIT      0x00000001
+/** @brief Reader count mask in the lock state. */
+#define RWLOCK_READER_MASK      0x0000FFFF
+/** @brief Waiting writers count increment in the lock state. */
+#define RWLOCK_WRITER_WAIT_UNIT 0x00010000
+/** @brief Waiting writers count mask in the lock state. */
+#define RWLOCK_WRITER_WAIT_MASK 0x3FFF0000
+/** @brief Writer bit in the lock state. */
+#define RWLOCK_WRITER_BIT       0x40000000
+
+/** @brief Defines the maximal number of threads waiting on the lock. */
+#define RWLOCK_MAX_WAITING_THREAD 0xFFFFFFFF
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Tells if a reader can acquire the lock in the given state.
+ *
+ * @param[in] RWLOCK The reader-writer lock.
+ * @param[in] STATE The lock state to check.
+ */
+#define RWLOCK_CAN_READ(RWLOCK, STATE)                                    \
+    (((STATE) & RWLOCK_WRITER_BIT) == 0 &&                               \
+     (((RWLOCK)->flags & RWLOCK_FLAG_WRITER_PREFERENCE) == 0 ||          \
+      ((STATE) & RWLOCK_WRITER_WAIT_MASK) == 0))
+
+/**
+ * @brief Tells if a writer can acquire the lock in the given state.
+ *
+ * @param[in] STATE The lock state to check.
+ */
+#define RWLOCK_CAN_WRITE(STATE) \
+    (((STATE) & (RWLOCK_WRITER_BIT | RWLOCK_READER_MASK)) == 0)
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Wakes the threads waiting on a sequence counter.
+ *
+ * @details Wakes the threads waiting on a sequence counter. The sequence is
+ * incremented before waking the threads so that threads about to wait see
+ * the change.
+ *
+ * @param[in, out] seq The sequence counter the threads wait on.
+ * @param[in] count The maximal number of threads to wake.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E rwlock_wake(volatile int32_t* seq, const uint32_t count);
+
+/**
+ * @brief Releases a reader reference on the lock.
+ *
+ * @details Releases a reader reference on the lock. If the released reader
+ * was the last one and writers are waiting, a writer is woken.
+ *
+ * @param[in, out] rwlock The reader-writer lock to release.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E rwlock_reader_release(rwlock_t* rwlock);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E rwlock_wake(volatile int32_t* seq, const uint32_t count)
+{
+    futex_t futex;
+
+    ATOMIC_FETCH_ADD(seq, 1);
+
+    futex.addr = (uint32_t*)seq;
+    futex.val  = count;
+    syscall_do(SYSCALL_FUTEX_WAKE, &futex);
+
+    /* No thread was waiting */
+    if(futex.error == OS_ERR_NO_SUCH_ID)
+    {
+        return OS_NO_ERR;
+    }
+
+    return futex.error;
+}
+
+static OS_RETURN_E rwlock_reader_release(rwlock_t* rwlock)
+{
+    int32_t state;
+
+    state = ATOMIC_FETCH_ADD(&rwlock->state, -RWLOCK_READER_UNIT);
+
+    /* If we were the last reader and writers are waiting, wake one */
+    if((state & RWLOCK_READER_MASK) == RWLOCK_READER_UNIT &&
+       (state & RWLOCK_WRITER_BIT) == 0 &&
+       (state & RWLOCK_WRITER_WAIT_MASK) != 0)
+    {
+        return rwlock_wake(&rwlock->write_seq, 1);
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E rwlock_init(rwlock_t* rwlock, const uint32_t flags)
+{
+    if(rwlock == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    rwlock->state           = 0;
+    rwlock->read_seq        = 0;
+    rwlock->write_seq       = 0;
+    rwlock->waiting_readers = 0;
+    rwlock->flags           = flags;
+    rwlock->init            = TRUE;
+
+    KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK", "RWLock 0x%p initialized",
+                 rwlock);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E rwlock_destroy(rwlock_t* rwlock)
+{
+    OS_RETURN_E err;
+
+    if(rwlock == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(rwlock->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    rwlock->init = FALSE;
+
+    /* Wakeup all threads waiting on the lock */
+    err = rwlock_wake(&rwlock->read_seq, RWLOCK_MAX_WAITING_THREAD);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    err = rwlock_wake(&rwlock->write_seq, RWLOCK_MAX_WAITING_THREAD);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK", "RWLock 0x%p destroyed",
+                 rwlock);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E rwlock_read_lock(rwlock_t* rwlock)
+{
+    OS_RETURN_E err;
+    int32_t     state;
+    futex_t     futex;
+
+    if(rwlock == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(rwlock->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    /* Fast path, a single atomic add when no writer is involved */
+    state = ATOMIC_FETCH_ADD(&rwlock->state, RWLOCK_READER_UNIT);
+    if(RWLOCK_CAN_READ(rwlock, state))
+    {
+        KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK",
+                     "RWLock 0x%p read acquired", rwlock);
+        return OS_NO_ERR;
+    }
+
+    /* Revert our reference, a writer might wait on it */
+    err = rwlock_reader_release(rwlock);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    /* Slow path, wait for the writers to release the lock */
+    ATOMIC_FETCH_ADD(&rwlock->waiting_readers, 1);
+    while(TRUE)
+    {
+        futex.val = rwlock->read_seq;
+
+        if(rwlock->init == FALSE)
+        {
+            ATOMIC_FETCH_ADD(&rwlock->waiting_readers, -1);
+            return OS_ERR_NOT_INITIALIZED;
+        }
+
+        state = rwlock->state;
+        if(RWLOCK_CAN_READ(rwlock, state))
+        {
+            if(ATOMIC_CAS(&rwlock->state,
+                          state,
+                          state + RWLOCK_READER_UNIT) == state)
+            {
+                break;
+            }
+            continue;
+        }
+
+        futex.addr = (uint32_t*)&rwlock->read_seq;
+        syscall_do(SYSCALL_FUTEX_WAIT, &futex);
+        if(futex.error != OS_NO_ERR)
+        {
+            ATOMIC_FETCH_ADD(&rwlock->waiting_readers, -1);
+            return futex.error;
+        }
+    }
+    ATOMIC_FETCH_ADD(&rwlock->waiting_readers, -1);
+
+    KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK",
+                 "RWLock 0x%p read acquired", rwlock);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E rwlock_read_unlock(rwlock_t* rwlock)
+{
+    if(rwlock == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(rwlock->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+    if((rwlock->state & RWLOCK_READER_MASK) == 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK",
+                 "RWLock 0x%p read released", rwlock);
+
+    return rwlock_reader_release(rwlock);
+}
+
+OS_RETURN_E rwlock_try_read_lock(rwlock_t* rwlock)
+{
+    int32_t state;
+
+    if(rwlock == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(rwlock->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    do
+    {
+        state = rwlock->state;
+        if(!RWLOCK_CAN_READ(rwlock, state))
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+    } while(ATOMIC_CAS(&rwlock->state,
+                       state,
+                       state + RWLOCK_READER_UNIT) != state);
+
+    KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK",
+                 "RWLock 0x%p read acquired", rwlock);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E rwlock_write_lock(rwlock_t* rwlock)
+{
+    int32_t state;
+    futex_t futex;
+
+    if(rwlock == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(rwlock->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    /* Fast path, the lock is free */
+    if(ATOMIC_CAS(&rwlock->state, 0, RWLOCK_WRITER_BIT) == 0)
+    {
+        KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK",
+                     "RWLock 0x%p write acquired", rwlock);
+        return OS_NO_ERR;
+    }
+
+    /* Slow path, register as waiting writer and wait for the lock */
+    ATOMIC_FETCH_ADD(&rwlock->state, RWLOCK_WRITER_WAIT_UNIT);
+    while(TRUE)
+    {
+        futex.val = rwlock->write_seq;
+
+        if(rwlock->init == FALSE)
+        {
+            ATOMIC_FETCH_ADD(&rwlock->state, -RWLOCK_WRITER_WAIT_UNIT);
+            return OS_ERR_NOT_INITIALIZED;
+        }
+
+        state = rwlock->state;
+        if(RWLOCK_CAN_WRITE(state))
+        {
+            if(ATOMIC_CAS(&rwlock->state,
+                          state,
+                          state - RWLOCK_WRITER_WAIT_UNIT +
+                          RWLOCK_WRITER_BIT) == state)
+            {
+                break;
+            }
+            continue;
+        }
+
+        futex.addr = (uint32_t*)&rwlock->write_seq;
+        syscall_do(SYSCALL_FUTEX_WAIT, &futex);
+        if(futex.error != OS_NO_ERR)
+        {
+            ATOMIC_FETCH_ADD(&rwlock->state, -RWLOCK_WRITER_WAIT_UNIT);
+            return futex.error;
+        }
+    }
+
+    KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK",
+                 "RWLock 0x%p write acquired", rwlock);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E rwlock_write_unlock(rwlock_t* rwlock)
+{
+    int32_t state;
+
+    if(rwlock == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(rwlock->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+    if((rwlock->state & RWLOCK_WRITER_BIT) == 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    state = ATOMIC_FETCH_ADD(&rwlock->state, -RWLOCK_WRITER_BIT) -
+            RWLOCK_WRITER_BIT;
+
+    KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK",
+                 "RWLock 0x%p write released", rwlock);
+
+    /* Hand the lock to a writer if they have the preference or if no reader is
+     * waiting, otherwise release all the readers.
+     */
+    if((state & RWLOCK_WRITER_WAIT_MASK) != 0 &&
+       ((rwlock->flags & RWLOCK_FLAG_WRITER_PREFERENCE) != 0 ||
+        rwlock->waiting_readers == 0))
+    {
+        return rwlock_wake(&rwlock->write_seq, 1);
+    }
+    if(rwlock->waiting_readers != 0)
+    {
+        return rwlock_wake(&rwlock->read_seq, RWLOCK_MAX_WAITING_THREAD);
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E rwlock_try_write_lock(rwlock_t* rwlock)
+{
+    if(rwlock == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(rwlock->init == FALSE)
+    {
+        return OS_ERR_NOT_INITIALIZED;
+    }
+
+    if(ATOMIC_CAS(&rwlock->state, 0, RWLOCK_WRITER_BIT) != 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    KERNEL_DEBUG(RWLOCK_DEBUG_ENABLED, "RWLOCK",
+                 "RWLock 0x%p write acquired", rwlock);
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
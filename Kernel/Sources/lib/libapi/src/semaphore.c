@@ -7,13 +7,17 @@
  *
  * @date 15/12/2021
  *
- * @version 3.0
+ * @version 4.0
  *
  * @brief Semaphore synchronization primitive.
  *
  * @details Semaphore synchronization primitive implemantation.
  * The semaphore are used to synchronyse the threads. The semaphore waiting list
  * is a FIFO with no regards of the waiting threads priority.
+ * The level and the number of waiting threads are stored in the same word.
+ * Pending decrements the level while it is positive and posting increments
+ * it, the futex is only used when the level does not allow the thread to
+ * continue or when a post finds waiting threads.
  *
  * @warning Semaphores can only be used when the current system is running and
  * the scheduler initialized.
@@ -27,7 +31,7 @@
 
 /* Included headers */
 #include <scheduler.h>       /* Scheduler constants */
-#include <atomic.h>          /* Spinlock API */
+#include <atomic.h>          /* Atomic operations */
 #include <kernel_output.h>   /* Kernel outputs */
 #include <string.h>          /* Standard memory lib */
 #include <kernel_error.h>    /* Kernel errors */
@@ -46,7 +50,23 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Bias applied to the level stored in the semaphore state. */
+#define SEM_LEVEL_BIAS 0x8000
+
+/** @brief Mask of the level in the semaphore state. */
+#define SEM_LEVEL_MASK 0xFFFF
+
+/** @brief Shift of the waiters counter in the semaphore state. */
+#define SEM_WAITERS_SHIFT 16
+
+/** @brief Value of one waiting thread in the semaphore state. */
+#define SEM_WAITER_UNIT (1 << SEM_WAITERS_SHIFT)
+
+/** @brief Mask of the waiters counter once shifted. */
+#define SEM_WAITERS_MASK 0x7FFF
+
+/** @brief Semaphore state flag set when the semaphore is destroyed. */
+#define SEM_STATE_DESTROYED ((int32_t)0x80000000)
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -58,7 +78,13 @@
  * MACROS
  ******************************************************************************/
 
-/* None */
+/** @brief Extracts the level from a semaphore state. */
+#define SEM_STATE_LEVEL(STATE) \
+    ((int32_t)((uint32_t)(STATE) & SEM_LEVEL_MASK) - SEM_LEVEL_BIAS)
+
+/** @brief Extracts the waiters counter from a semaphore state. */
+#define SEM_STATE_WAITERS(STATE) \
+    (((uint32_t)(STATE) >> SEM_WAITERS_SHIFT) & SEM_WAITERS_MASK)
 
 /*******************************************************************************
  * GLOBAL VARIABLES
@@ -77,24 +103,108 @@
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
 
-/* None */
+/**
+ * @brief Wakes threads waiting on the semaphore.
+ *
+ * @param[in, out] sem The semaphore.
+ * @param[in] count The maximal number of threads to wake.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E sem_wake(semaphore_t* sem, const uint32_t count);
+
+/**
+ * @brief Semaphore pend slow path.
+ *
+ * @details Semaphore pend slow path. The calling thread must already be
+ * accounted in the waiters counter. The thread blocks on the futex until it
+ * acquires the semaphore or the semaphore is destroyed.
+ *
+ * @param[in, out] sem The semaphore to pend.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E sem_pend_slow(semaphore_t* sem);
 
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
 
+static OS_RETURN_E sem_wake(semaphore_t* sem, const uint32_t count)
+{
+    futex_t futex;
+
+    futex.addr = (uint32_t*)&sem->state;
+    futex.val  = count;
+    syscall_do(SYSCALL_FUTEX_WAKE, &futex);
+
+    /* The waiters might not have reached the futex yet, they will see the new
+     * state and will not block.
+     */
+    if(futex.error == OS_ERR_NO_SUCH_ID)
+    {
+        return OS_NO_ERR;
+    }
+
+    return futex.error;
+}
+
+static OS_RETURN_E sem_pend_slow(semaphore_t* sem)
+{
+    futex_t futex;
+    int32_t state;
+
+    while(TRUE)
+    {
+        /* The state must be read before the initialization state, a destroy
+         * updates the state after clearing the initialization state.
+         */
+        state = sem->state;
+
+        if(sem->init == FALSE)
+        {
+            ATOMIC_FETCH_ADD(&sem->state, -SEM_WAITER_UNIT);
+            return OS_ERR_NOT_INITIALIZED;
+        }
+
+        /* Acquire the semaphore and leave the waiters at once */
+        if(SEM_STATE_LEVEL(state) > 0)
+        {
+            if(ATOMIC_CAS(&sem->state, state,
+                          state - 1 - SEM_WAITER_UNIT) == state)
+            {
+                return OS_NO_ERR;
+            }
+            continue;
+        }
+
+        /* Wait until the state changes */
+        futex.addr = (uint32_t*)&sem->state;
+        futex.val  = state;
+        syscall_do(SYSCALL_FUTEX_WAIT, &futex);
+
+        if(futex.error != OS_NO_ERR)
+        {
+            ATOMIC_FETCH_ADD(&sem->state, -SEM_WAITER_UNIT);
+            return futex.error;
+        }
+    }
+}
+
 OS_RETURN_E sem_init(semaphore_t* sem, const int32_t init_level)
 {
     if(sem == NULL)
     {
         return OS_ERR_NULL_POINTER;
     }
+    if(init_level < SEM_LEVEL_MIN || init_level > SEM_LEVEL_MAX)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
 
     /* Init the semaphore*/
-    sem->level   = init_level;
-    sem->waiters = 0;
-    sem->lock    = SPINLOCK_INIT_VALUE;
-    sem->init    = TRUE;
+    sem->state = init_level + SEM_LEVEL_BIAS;
+    sem->init  = TRUE;
 
     KERNEL_DEBUG(SEMAPHORE_DEBUG_ENABLED, "SEM", "Semaphore 0x%p initialized.",
                  sem);
@@ -104,8 +214,7 @@ OS_RETURN_E sem_init(semaphore_t* sem, const int32_t init_level)
 
 OS_RETURN_E sem_destroy(semaphore_t* sem)
 {
-    futex_t futex;
-    int32_t waiters;
+    int32_t state;
 
     /* Check if semaphore is initialized */
     if(sem == NULL)
@@ -117,38 +226,35 @@ OS_RETURN_E sem_destroy(semaphore_t* sem)
         return OS_ERR_NOT_INITIALIZED;
     }
 
-    SPINLOCK_LOCK(sem->lock);
-
-    /* Destroy the mutex */
+    /* Destroy the semaphore */
     sem->init = FALSE;
 
-    /* Wakeup all threads locked on the semaphore */
-    if((waiters = sem->waiters) > 0)
-    {
-        sem->level = sem->waiters;
-        SPINLOCK_UNLOCK(sem->lock);
-        futex.val  = waiters;
-        futex.addr = (uint32_t*)&sem->level;
-        syscall_do(SYSCALL_FUTEX_WAKE, &futex);
-        if(futex.error != OS_NO_ERR)
-        {
-            return futex.error;
-        }
-    }
-    else
+    /* Change the state so that no thread blocks with the old one, the level
+     * is left untouched.
+     */
+    do
     {
-        SPINLOCK_UNLOCK(sem->lock);
-    }
+        state = sem->state;
+    } while(ATOMIC_CAS(&sem->state, state, state | SEM_STATE_DESTROYED) !=
+            state);
 
     KERNEL_DEBUG(SEMAPHORE_DEBUG_ENABLED, "SEM", "Semaphore 0x%p destroyed.",
                  sem);
 
+    /* Wakeup all threads locked on the semaphore */
+    if(SEM_STATE_WAITERS(state) != 0)
+    {
+        return sem_wake(sem, SEM_MAX_WAITING_THREAD);
+    }
+
     return OS_NO_ERR;
 }
 
 OS_RETURN_E sem_pend(semaphore_t* sem)
 {
-    futex_t     futex;
+    OS_RETURN_E err;
+    int32_t     state;
+    int32_t     new_state;
 
     /* Check if semaphore is initialized */
     if(sem == NULL)
@@ -160,45 +266,36 @@ OS_RETURN_E sem_pend(semaphore_t* sem)
         return OS_ERR_NOT_INITIALIZED;
     }
 
-    SPINLOCK_LOCK(sem->lock);
-
-    /* Wait to get the semaphore */
-    while(sem->level <= 0)
+    /* Take the semaphore if it is available, register as waiter otherwise.
+     * The level is only decremented while positive, it never borrows from
+     * the waiters counter.
+     */
+    do
     {
-        ++sem->waiters;
-
-        /* Wait on futex until the semaphore is opened */
-        futex.addr = (uint32_t*)&sem->level;
-        futex.val  = sem->level;
-
-        SPINLOCK_UNLOCK(sem->lock);
-
-        syscall_do(SYSCALL_FUTEX_WAIT, &futex);
-
-        SPINLOCK_LOCK(sem->lock);
-
-        /* We are not waiting anymore */
-        --sem->waiters;
-
-        if(futex.error != OS_NO_ERR)
+        state = sem->state;
+        if(SEM_STATE_LEVEL(state) > 0)
         {
-            SPINLOCK_UNLOCK(sem->lock);
-            return futex.error;
+            new_state = state - 1;
         }
-
-        /* Check if the semaphore is still initialized */
-        if(sem->init == FALSE)
+        else
         {
-            SPINLOCK_UNLOCK(sem->lock);
-
-            return OS_ERR_NOT_INITIALIZED;
+            new_state = state + SEM_WAITER_UNIT;
         }
-    }
+    } while(ATOMIC_CAS(&sem->state, state, new_state) != state);
 
-    /* We acquired the semaphore */
-    --sem->level;
+    /* Fast path, the semaphore was available */
+    if(SEM_STATE_LEVEL(state) > 0)
+    {
+        KERNEL_DEBUG(SEMAPHORE_DEBUG_ENABLED, "SEM",
+                     "Semaphore 0x%p acquired.", sem);
+        return OS_NO_ERR;
+    }
 
-    SPINLOCK_UNLOCK(sem->lock);
+    err = sem_pend_slow(sem);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
 
     KERNEL_DEBUG(SEMAPHORE_DEBUG_ENABLED, "SEM", "Semaphore 0x%p acquired.",
                  sem);
@@ -208,7 +305,7 @@ OS_RETURN_E sem_pend(semaphore_t* sem)
 
 OS_RETURN_E sem_post(semaphore_t* sem)
 {
-    futex_t futex;
+    int32_t prev;
 
     /* Check if semaphore is initialized */
     if(sem == NULL)
@@ -220,35 +317,33 @@ OS_RETURN_E sem_post(semaphore_t* sem)
         return OS_ERR_NOT_INITIALIZED;
     }
 
-    SPINLOCK_LOCK(sem->lock);
-
-    /* We released the semaphore */
-    ++sem->level;
-
-    /* Check if we should wakeup threads */
-    if(sem->level > 0 && sem->waiters > 0)
+    /* We release the semaphore, never above its maximal level */
+    do
     {
-        futex.addr = (uint32_t*)&sem->level;
-        futex.val  = 1;
-        syscall_do(SYSCALL_FUTEX_WAKE, &futex);
-
-        if(futex.error != OS_NO_ERR)
+        prev = sem->state;
+        if(SEM_STATE_LEVEL(prev) >= SEM_LEVEL_MAX)
         {
-            SPINLOCK_UNLOCK(sem->lock);
-            return futex.error;
+            return OS_ERR_OUT_OF_BOUND;
         }
-    }
-
-    SPINLOCK_UNLOCK(sem->lock);
+    } while(ATOMIC_CAS(&sem->state, prev, prev + 1) != prev);
 
     KERNEL_DEBUG(SEMAPHORE_DEBUG_ENABLED, "SEM", "Semaphore 0x%p released.",
                  sem);
 
-    return OS_NO_ERR;
+    /* Only wake a thread if the level became positive and threads wait */
+    if(SEM_STATE_WAITERS(prev) == 0 || SEM_STATE_LEVEL(prev) < 0)
+    {
+        return OS_NO_ERR;
+    }
+
+    return sem_wake(sem, 1);
 }
 
 OS_RETURN_E sem_trypend(semaphore_t* sem, int32_t* value)
 {
+    int32_t state;
+    int32_t level;
+
     /* Check if semaphore is initialized */
     if(sem == NULL)
     {
@@ -259,29 +354,27 @@ OS_RETURN_E sem_trypend(semaphore_t* sem, int32_t* value)
         return OS_ERR_NOT_INITIALIZED;
     }
 
-    SPINLOCK_LOCK(sem->lock);
-
-    /* Check to get the semaphore */
-    if(sem->level <= 0)
+    /* Never let the level go down when the semaphore cannot be acquired */
+    do
     {
-        if(value != NULL)
+        state = sem->state;
+        level = SEM_STATE_LEVEL(state);
+        if(level <= 0)
         {
-            *value = sem->level;
+            if(value != NULL)
+            {
+                *value = level;
+            }
+            return OS_ERR_UNAUTHORIZED_ACTION;
         }
-        SPINLOCK_UNLOCK(sem->lock);
-        return OS_ERR_UNAUTHORIZED_ACTION;
-    }
+    } while(ATOMIC_CAS(&sem->state, state, state - 1) != state);
 
     /* We acquired the semaphore */
-    --sem->level;
-
     if(value != NULL)
     {
-        *value = sem->level;
+        *value = level - 1;
     }
 
-    SPINLOCK_UNLOCK(sem->lock);
-
     KERNEL_DEBUG(SEMAPHORE_DEBUG_ENABLED, "SEM", "Semaphore 0x%p acquired.",
                  sem);
 
@@ -87,8 +87,113 @@ OS_RETURN_E syscall_do(const SYSCALL_FUNCTION_E func, void* params)
         return OS_ERR_SYSCALL_UNKNOWN;
     }
 
-    /* Generate the syscall */
-    cpu_syscall(func, params);
+    /* Generate the syscall, the interrupt is kept for the system calls that
+     * need the caller's interrupt context
+     */
+    if(syscall_fast_allowed(func) == TRUE)
+    {
+        cpu_syscall_fast(func, params);
+    }
+    else
+    {
+        cpu_syscall(func, params);
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E syscall_ring_init(syscall_ring_t* ring)
+{
+    syscall_ring_params_t params;
+
+    if(ring == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    ring->sq_head = 0;
+    ring->sq_tail = 0;
+    ring->cq_head = 0;
+    ring->cq_tail = 0;
+
+    params.ring = ring;
+    syscall_do(SYSCALL_RING_REGISTER, &params);
+
+    return params.error;
+}
+
+OS_RETURN_E syscall_ring_push(syscall_ring_t* ring,
+                              const SYSCALL_FUNCTION_E func,
+                              void* params,
+                              const uint32_t user_data)
+{
+    volatile syscall_ring_sqe_t* sqe;
+    uint32_t                     tail;
+
+    if(ring == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    tail = ring->sq_tail;
+    if(tail - ring->sq_head >= SYSCALL_RING_SIZE)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    sqe = &ring->sq[tail & (SYSCALL_RING_SIZE - 1)];
+    sqe->func      = func;
+    sqe->params    = params;
+    sqe->user_data = user_data;
+
+    /* Publish the entry once it is complete */
+    ring->sq_tail = tail + 1;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E syscall_ring_submit(syscall_ring_t* ring, uint32_t* processed)
+{
+    syscall_ring_params_t params;
+
+    if(ring == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    params.ring = ring;
+    syscall_do(SYSCALL_RING_ENTER, &params);
+
+    if(processed != NULL)
+    {
+        *processed = params.processed;
+    }
+
+    return params.error;
+}
+
+OS_RETURN_E syscall_ring_poll(syscall_ring_t* ring, syscall_ring_cqe_t* cqe)
+{
+    volatile syscall_ring_cqe_t* entry;
+    uint32_t                     head;
+
+    if(ring == NULL || cqe == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    head = ring->cq_head;
+    if(head == ring->cq_tail)
+    {
+        return OS_ERR_NO_SUCH_ID;
+    }
+
+    entry = &ring->cq[head & (SYSCALL_RING_SIZE - 1)];
+    cqe->user_data = entry->user_data;
+    cqe->status    = entry->status;
+
+    /* Release the slot once it has been read */
+    ring->cq_head = head + 1;
 
     return OS_NO_ERR;
 }
@@ -107,7 +107,8 @@ int vprintf(const char *__format, __builtin_va_list __vl)
  * @param[in] __format The format string to print.
  * @param[in] __vl The arguments attached to the format string.
  *
- * @return 0 in all cases.
+ * @return The number of characters written without the NULL terminator, or
+ * -1 on error.
  */
 int vsprintf(char *__dest, const char *__format, __builtin_va_list __vl)
              __attribute__((format (printf, 2, 0)));
@@ -123,12 +124,30 @@ int vsprintf(char *__dest, const char *__format, __builtin_va_list __vl)
  * @param[in] __format The format string to print.
  * @param[in] __vl The arguments attached to the format string.
  *
- * @return 0 in all cases.
+ * @return The length of the formatted string without truncation, or -1 on
+ * error.
  */
 int vsnprintf(char *__dest, unsigned int __size, const char *__format,
               __builtin_va_list __vl)
               __attribute__((format (printf, 3, 0)));
 
+/**
+ * @brief Prints a formated string into a buffer.
+ *
+ * @details Prints a formated string into a buffer with the attached parameters
+ * to be included in the string.
+ *
+ * @param[out] __dest The buffer to print the string into.
+ * @param[in] __size The maximal size of the buffer.
+ * @param[in] __format The format string to print.
+ * @param[in] ... The arguments attached to the format string.
+ *
+ * @return The length of the formatted string without truncation, or -1 on
+ * error.
+ */
+int snprintf(char *__dest, unsigned int __size, const char *__format, ...)
+             __attribute__((format (printf, 3, 4)));
+
 #endif /* #ifndef __LIB_STDIO_H_ */
 
 /************************************ EOF *************************************/
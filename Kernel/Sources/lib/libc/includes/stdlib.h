@@ -106,6 +106,31 @@ void* malloc(const size_t size);
  */
 void free(void* ptr);
 
+/**
+ * @brief Returns the process heap available memory.
+ *
+ * @return The process heap available memory is returned.
+ */
+uint32_t malloc_get_free(void);
+
+/**
+ * @brief Returns the process heap memory used by the chunks meta data.
+ *
+ * @return The process heap memory used by the chunks meta data is returned.
+ */
+uint32_t malloc_get_meta(void);
+
+/**
+ * @brief Returns the size of the largest free chunk of the process heap.
+ *
+ * @details Returns the size of the largest free chunk of the process heap,
+ * which is the largest allocation that can succeed. Compared to the free
+ * memory, it gives the heap fragmentation.
+ *
+ * @return The size of the largest free chunk of the process heap is returned.
+ */
+uint32_t malloc_get_largest_free(void);
+
 #endif /* #ifndef __LIB_STDLIB_H_ */
 
 /************************************ EOF *************************************/
@@ -676,6 +676,65 @@ void* malloc(size_t size)
     return chunk->data;
 }
 
+uint32_t malloc_get_free(void)
+{
+    return mem_free;
+}
+
+uint32_t malloc_get_meta(void)
+{
+    return mem_meta;
+}
+
+uint32_t malloc_get_largest_free(void)
+{
+    list_t*      node;
+    mem_chunk_t* chunk;
+    uint32_t     largest;
+    uint32_t     size;
+    int32_t      n;
+    OS_RETURN_E  err;
+
+    if(init == FALSE)
+    {
+        return 0;
+    }
+
+    err = mutex_lock(&lock);
+    MALLOC_ASSERT(err == OS_NO_ERR,
+                  "Could not lock user heap lock.",
+                  err);
+
+    /* The largest chunk is in the highest non empty size class */
+    largest = 0;
+    for(n = NUM_SIZES - 1; n >= 0 && largest == 0; --n)
+    {
+        if(free_chunk[n] == NULL)
+        {
+            continue;
+        }
+
+        node = &free_chunk[n]->free;
+        do
+        {
+            chunk = CONTAINER(mem_chunk_t, free, node);
+            size  = memory_chunk_size(chunk);
+            if(size > largest)
+            {
+                largest = size;
+            }
+            node = node->next;
+        } while(node != &free_chunk[n]->free);
+    }
+
+    err = mutex_unlock(&lock);
+    MALLOC_ASSERT(err == OS_NO_ERR,
+                  "Could not unlock user heap lock.",
+                  err);
+
+    return largest;
+}
+
 void free(void* ptr)
 {
     uint32_t     used;
@@ -94,4 +94,30 @@ int printf(const char *fmt, ...)
     return err;
 }
 
+int vsprintf(char *dest, const char *fmt, __builtin_va_list args)
+{
+    /* The destination size is unknown, do not limit it */
+    return kernel_vsnprintf(dest, (size_t)-1, fmt, args);
+}
+
+int vsnprintf(char *dest, unsigned int size, const char *fmt,
+              __builtin_va_list args)
+{
+    return kernel_vsnprintf(dest, size, fmt, args);
+}
+
+int snprintf(char *dest, unsigned int size, const char *fmt, ...)
+{
+    __builtin_va_list    args;
+    int                  err;
+
+    __builtin_va_start(args, fmt);
+
+    err = vsnprintf(dest, size, fmt, args);
+
+    __builtin_va_end(args);
+
+    return err;
+}
+
 /************************************ EOF *************************************/
\ No newline at end of file
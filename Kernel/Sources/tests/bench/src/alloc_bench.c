@@ -0,0 +1,349 @@
+
+
+#include <test_bank.h>
+
+#if ALLOC_BENCH == 1
+
+#include <kheap.h>
+#include <stdlib.h>
+#include <cpu_api.h>
+#include <kernel_output.h>
+#include <bench.h>
+
+#define ALLOC_BENCH_STEPS      4000
+#define ALLOC_BENCH_SLOTS      256
+#define ALLOC_BENCH_BATCH      128
+#define ALLOC_BENCH_BURST      8
+#define ALLOC_BENCH_LONG_LIVED 512
+#define ALLOC_BENCH_SEED       0x2545F491
+#define ALLOC_BENCH_NAME_SIZE  64
+
+typedef struct
+{
+    const char* name;
+    void*       (*alloc)(size_t size);
+    void        (*release)(void* ptr);
+    uint32_t    (*get_free)(void);
+    uint32_t    (*get_meta)(void);
+    uint32_t    (*get_largest_free)(void);
+} alloc_bench_heap_t;
+
+typedef struct
+{
+    const char* name;
+    void        (*replay)(const alloc_bench_heap_t* heap);
+} alloc_bench_trace_t;
+
+static void* bench_slots[ALLOC_BENCH_SLOTS];
+static void* bench_long_lived[ALLOC_BENCH_LONG_LIVED];
+
+static uint32_t bench_seed;
+static uint32_t bench_errors;
+static uint32_t bench_ops;
+static uint64_t bench_cycles;
+static uint32_t bench_peak_meta;
+
+static uint32_t alloc_bench_rand(void)
+{
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 17;
+    bench_seed ^= bench_seed << 5;
+
+    return bench_seed;
+}
+
+/* The size class is uniform in 8..2048, small blocks are the most frequent */
+static size_t alloc_bench_size(void)
+{
+    uint32_t base;
+
+    base = 8 << (alloc_bench_rand() % 9);
+
+    return base + alloc_bench_rand() % base;
+}
+
+static void alloc_bench_account(const uint64_t start)
+{
+    bench_cycles += bench_record_elapsed(start, 1);
+    ++bench_ops;
+}
+
+static void* alloc_bench_alloc(const alloc_bench_heap_t* heap,
+                               const size_t size)
+{
+    uint64_t start;
+    uint32_t meta;
+    void*    block;
+
+    start = cpu_get_timestamp();
+    block = heap->alloc(size);
+    alloc_bench_account(start);
+
+    if(block == NULL)
+    {
+        ++bench_errors;
+    }
+
+    meta = heap->get_meta();
+    if(meta > bench_peak_meta)
+    {
+        bench_peak_meta = meta;
+    }
+
+    return block;
+}
+
+static void alloc_bench_release(const alloc_bench_heap_t* heap, void* block)
+{
+    uint64_t start;
+
+    if(block == NULL)
+    {
+        return;
+    }
+
+    start = cpu_get_timestamp();
+    heap->release(block);
+    alloc_bench_account(start);
+}
+
+static void alloc_bench_release_all(const alloc_bench_heap_t* heap,
+                                    void** blocks,
+                                    const uint32_t count)
+{
+    uint32_t i;
+
+    for(i = 0; i < count; ++i)
+    {
+        if(blocks[i] != NULL)
+        {
+            heap->release(blocks[i]);
+            blocks[i] = NULL;
+        }
+    }
+}
+
+static void alloc_bench_random(const alloc_bench_heap_t* heap)
+{
+    uint32_t i;
+    uint32_t slot;
+
+    for(i = 0; i < ALLOC_BENCH_STEPS; ++i)
+    {
+        slot = alloc_bench_rand() % ALLOC_BENCH_SLOTS;
+        if(bench_slots[slot] == NULL)
+        {
+            bench_slots[slot] = alloc_bench_alloc(heap, alloc_bench_size());
+        }
+        else
+        {
+            alloc_bench_release(heap, bench_slots[slot]);
+            bench_slots[slot] = NULL;
+        }
+    }
+}
+
+static void alloc_bench_lifo(const alloc_bench_heap_t* heap)
+{
+    uint32_t i;
+    uint32_t j;
+
+    for(i = 0; i < ALLOC_BENCH_STEPS / (2 * ALLOC_BENCH_BATCH); ++i)
+    {
+        for(j = 0; j < ALLOC_BENCH_BATCH; ++j)
+        {
+            bench_slots[j] = alloc_bench_alloc(heap, alloc_bench_size());
+        }
+        for(j = ALLOC_BENCH_BATCH; j > 0; --j)
+        {
+            alloc_bench_release(heap, bench_slots[j - 1]);
+            bench_slots[j - 1] = NULL;
+        }
+    }
+}
+
+static void alloc_bench_fifo(const alloc_bench_heap_t* heap)
+{
+    uint32_t i;
+    uint32_t j;
+
+    for(i = 0; i < ALLOC_BENCH_STEPS / (2 * ALLOC_BENCH_BATCH); ++i)
+    {
+        for(j = 0; j < ALLOC_BENCH_BATCH; ++j)
+        {
+            bench_slots[j] = alloc_bench_alloc(heap, alloc_bench_size());
+        }
+        for(j = 0; j < ALLOC_BENCH_BATCH; ++j)
+        {
+            alloc_bench_release(heap, bench_slots[j]);
+            bench_slots[j] = NULL;
+        }
+    }
+}
+
+/* The producer queues bursts of blocks that the consumer frees later, oldest
+ * first. The queue is a ring over the slots.
+ */
+static void alloc_bench_producer_consumer(const alloc_bench_heap_t* heap)
+{
+    uint32_t head;
+    uint32_t tail;
+    uint32_t burst;
+
+    head = 0;
+    tail = 0;
+    while(bench_ops < ALLOC_BENCH_STEPS)
+    {
+        burst = 1 + alloc_bench_rand() % ALLOC_BENCH_BURST;
+        while(burst-- > 0 && head - tail < ALLOC_BENCH_SLOTS)
+        {
+            bench_slots[head % ALLOC_BENCH_SLOTS] =
+                alloc_bench_alloc(heap, alloc_bench_size());
+            ++head;
+        }
+
+        burst = 1 + alloc_bench_rand() % ALLOC_BENCH_BURST;
+        while(burst-- > 0 && tail != head)
+        {
+            alloc_bench_release(heap, bench_slots[tail % ALLOC_BENCH_SLOTS]);
+            bench_slots[tail % ALLOC_BENCH_SLOTS] = NULL;
+            ++tail;
+        }
+    }
+}
+
+/* Small long lived blocks are interleaved with short lived ones, freeing the
+ * latter leaves holes the random trace has to work around.
+ */
+static void alloc_bench_long_lived(const alloc_bench_heap_t* heap)
+{
+    uint32_t i;
+    uint32_t slot;
+
+    for(i = 0; i < ALLOC_BENCH_LONG_LIVED; ++i)
+    {
+        slot = i % ALLOC_BENCH_SLOTS;
+
+        bench_long_lived[i] = heap->alloc(16 + alloc_bench_rand() % 48);
+        bench_slots[slot]   = heap->alloc(alloc_bench_size());
+        if(bench_long_lived[i] == NULL || bench_slots[slot] == NULL)
+        {
+            ++bench_errors;
+        }
+
+        if(slot == ALLOC_BENCH_SLOTS - 1)
+        {
+            alloc_bench_release_all(heap, bench_slots, ALLOC_BENCH_SLOTS);
+        }
+    }
+
+    alloc_bench_random(heap);
+}
+
+static const alloc_bench_heap_t bench_heaps[] = {
+    {"kheap", kmalloc, kfree, kheap_get_free, kheap_get_meta,
+     kheap_get_largest_free},
+    {"malloc", malloc, free, malloc_get_free, malloc_get_meta,
+     malloc_get_largest_free}
+};
+
+static const alloc_bench_trace_t bench_traces[] = {
+    {"random", alloc_bench_random},
+    {"lifo", alloc_bench_lifo},
+    {"fifo", alloc_bench_fifo},
+    {"producer_consumer", alloc_bench_producer_consumer},
+    {"long_lived", alloc_bench_long_lived}
+};
+
+static void alloc_bench_metric(const alloc_bench_heap_t* heap,
+                               const alloc_bench_trace_t* trace,
+                               const char* metric,
+                               const uint64_t value)
+{
+    char name[ALLOC_BENCH_NAME_SIZE];
+
+    kernel_snprintf(name, sizeof(name), "%s_%s_%s",
+                    heap->name, trace->name, metric);
+    bench_metric(name, value);
+}
+
+static void alloc_bench_replay(const alloc_bench_heap_t* heap,
+                               const alloc_bench_trace_t* trace)
+{
+    char     name[ALLOC_BENCH_NAME_SIZE];
+    uint32_t free_mem;
+    uint32_t largest;
+    uint32_t frag;
+
+    bench_seed      = ALLOC_BENCH_SEED;
+    bench_ops       = 0;
+    bench_cycles    = 0;
+    bench_peak_meta = heap->get_meta();
+
+    trace->replay(heap);
+
+    /* Measure the fragmentation with the live blocks of the trace */
+    free_mem = heap->get_free();
+    largest  = heap->get_largest_free();
+    frag     = 0;
+    if(free_mem != 0 && largest < free_mem)
+    {
+        frag = 1000 - (uint32_t)((uint64_t)largest * 1000 / free_mem);
+    }
+
+    alloc_bench_release_all(heap, bench_slots, ALLOC_BENCH_SLOTS);
+    alloc_bench_release_all(heap, bench_long_lived, ALLOC_BENCH_LONG_LIVED);
+
+    kernel_snprintf(name, sizeof(name), "%s_%s", heap->name, trace->name);
+    bench_report(name, NULL);
+
+    alloc_bench_metric(heap, trace, "ops_per_mcycle",
+                       bench_cycles != 0 ?
+                       (uint64_t)bench_ops * 1000000 / bench_cycles : 0);
+    alloc_bench_metric(heap, trace, "peak_meta_bytes", bench_peak_meta);
+    alloc_bench_metric(heap, trace, "frag_permille", frag);
+}
+
+void alloc_bench(void)
+{
+    const alloc_bench_heap_t* heap;
+    uint32_t                  free_before;
+    uint32_t                  i;
+    uint32_t                  j;
+
+    bench_suite_start("Alloc");
+
+    bench_errors = 0;
+
+    for(i = 0; i < sizeof(bench_heaps) / sizeof(bench_heaps[0]); ++i)
+    {
+        heap = &bench_heaps[i];
+
+        /* The user heap is initialized on its first allocation */
+        heap->release(heap->alloc(16));
+        free_before = heap->get_free();
+
+        for(j = 0; j < sizeof(bench_traces) / sizeof(bench_traces[0]); ++j)
+        {
+            alloc_bench_replay(heap, &bench_traces[j]);
+        }
+
+        if(heap->get_free() != free_before)
+        {
+            bench_fail("free memory changed");
+        }
+    }
+
+    if(bench_errors != 0)
+    {
+        bench_fail("allocation failed");
+    }
+
+    bench_suite_end();
+}
+#else
+void alloc_bench(void)
+{
+
+}
+#endif
\ No newline at end of file
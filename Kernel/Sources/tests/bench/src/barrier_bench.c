@@ -0,0 +1,111 @@
+#include <test_bank.h>
+
+#if BARRIER_BENCH == 1
+
+#include <scheduler.h>
+#include <barrier.h>
+#include <cpu_api.h>
+#include <bench.h>
+
+#define BARRIER_BENCH_MAX_THREADS 8
+#define BARRIER_BENCH_WARMUP      10
+#define BARRIER_BENCH_ROUNDS      1000
+
+static kernel_thread_t* thread_workers[BARRIER_BENCH_MAX_THREADS];
+
+static barrier_t bench_barrier;
+
+static volatile uint64_t bench_round_start;
+static volatile uint32_t bench_errors;
+
+void *barrier_bench_worker(void *args);
+
+void *barrier_bench_worker(void *args)
+{
+    bool_t serial;
+    int    i;
+
+    (void)args;
+
+    for(i = 0; i < BARRIER_BENCH_WARMUP + BARRIER_BENCH_ROUNDS; ++i)
+    {
+        if(barrier_wait(&bench_barrier, &serial) != OS_NO_ERR)
+        {
+            ++bench_errors;
+            return NULL;
+        }
+
+        /* The serial thread of a round is the only one writing, a sample is
+         * the time between two consecutive barrier releases.
+         */
+        if(serial == TRUE)
+        {
+            if(i >= BARRIER_BENCH_WARMUP)
+            {
+                bench_record_elapsed(bench_round_start, 1);
+            }
+            bench_round_start = cpu_get_timestamp();
+        }
+    }
+
+    return NULL;
+}
+
+static void barrier_bench_run(const char* name, const int32_t threads)
+{
+    int i;
+
+    if(barrier_init(&bench_barrier, threads) != OS_NO_ERR)
+    {
+        bench_fail("could not init the barrier");
+        return;
+    }
+
+    for(i = 0; i < threads; ++i)
+    {
+        if(sched_create_kernel_thread(&thread_workers[i], 5, "barrier_bench",
+                                      THREAD_TYPE_KERNEL, 0x1000,
+                                      barrier_bench_worker, NULL) != OS_NO_ERR)
+        {
+            bench_fail("could not create a worker thread");
+        }
+    }
+    for(i = 0; i < threads; ++i)
+    {
+        if(sched_join_thread(thread_workers[i], NULL, NULL) != OS_NO_ERR)
+        {
+            bench_fail("could not wait a worker thread");
+        }
+    }
+
+    if(barrier_destroy(&bench_barrier) != OS_NO_ERR)
+    {
+        bench_fail("could not destroy the barrier");
+    }
+
+    bench_report(name, NULL);
+}
+
+void barrier_bench(void)
+{
+    bench_suite_start("Barrier");
+
+    bench_errors = 0;
+
+    barrier_bench_run("round_2_threads", 2);
+    barrier_bench_run("round_4_threads", 4);
+    barrier_bench_run("round_8_threads", 8);
+
+    if(bench_errors != 0)
+    {
+        bench_fail("barrier wait failed");
+    }
+
+    bench_suite_end();
+}
+#else
+void barrier_bench(void)
+{
+
+}
+#endif
\ No newline at end of file
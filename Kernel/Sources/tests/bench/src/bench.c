@@ -0,0 +1,328 @@
+/*******************************************************************************
+ * @file bench.c
+ *
+ * @see bench.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 05/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel benchmark harness.
+ *
+ * @details Kernel benchmark harness. The samples of the current benchmark are
+ * kept in a static buffer and sorted when reported.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#include <test_bank.h>
+
+#ifdef TEST_MODE_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>        /* Generic int types */
+#include <stddef.h>        /* Standard definitions */
+#include <cpu_api.h>       /* CPU API */
+#include <kernel_output.h> /* Kernel output methods */
+
+/* Header file */
+#include <bench.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of reads used to measure the timestamp overhead. */
+#define BENCH_OVERHEAD_ROUNDS 64
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Samples of the current benchmark. */
+static uint64_t bench_samples[BENCH_MAX_SAMPLES];
+
+/** @brief Number of samples of the current benchmark. */
+static uint32_t bench_sample_count = 0;
+
+/** @brief Name of the current suite. */
+static const char* bench_suite = "";
+
+/** @brief Number of failures of the current suite. */
+static uint32_t bench_failures = 0;
+
+/** @brief Cycles measured between two consecutive timestamp reads. */
+static uint64_t bench_timer_overhead = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Moves a sample down the max heap until the heap is valid.
+ *
+ * @param[in, out] heap The samples heap.
+ * @param[in] root The index of the sample to move.
+ * @param[in] size The heap size.
+ */
+static void bench_sift_down(uint64_t* heap, uint32_t root, const uint32_t size);
+
+/**
+ * @brief Sorts the samples in ascending order.
+ *
+ * @param[in, out] samples The samples to sort.
+ * @param[in] count The number of samples.
+ */
+static void bench_sort(uint64_t* samples, const uint32_t count);
+
+/**
+ * @brief Returns a percentile of sorted samples with the nearest rank method.
+ *
+ * @param[in] samples The sorted samples.
+ * @param[in] count The number of samples, not 0.
+ * @param[in] percent The percentile.
+ *
+ * @return The percentile of the samples.
+ */
+static uint64_t bench_percentile(const uint64_t* samples,
+                                 const uint32_t count,
+                                 const uint32_t percent);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void bench_sift_down(uint64_t* heap, uint32_t root, const uint32_t size)
+{
+    uint32_t child;
+    uint64_t tmp;
+
+    while((child = 2 * root + 1) < size)
+    {
+        if(child + 1 < size && heap[child + 1] > heap[child])
+        {
+            ++child;
+        }
+        if(heap[root] >= heap[child])
+        {
+            return;
+        }
+
+        tmp         = heap[root];
+        heap[root]  = heap[child];
+        heap[child] = tmp;
+        root        = child;
+    }
+}
+
+static void bench_sort(uint64_t* samples, const uint32_t count)
+{
+    uint64_t tmp;
+    uint32_t i;
+
+    /* Heap sort, no allocation and bounded time */
+    for(i = count / 2; i > 0; --i)
+    {
+        bench_sift_down(samples, i - 1, count);
+    }
+    for(i = count; i > 1; --i)
+    {
+        tmp            = samples[0];
+        samples[0]     = samples[i - 1];
+        samples[i - 1] = tmp;
+        bench_sift_down(samples, 0, i - 1);
+    }
+}
+
+static uint64_t bench_percentile(const uint64_t* samples,
+                                 const uint32_t count,
+                                 const uint32_t percent)
+{
+    uint32_t rank;
+
+    rank = (count * percent + 99) / 100;
+    if(rank == 0)
+    {
+        rank = 1;
+    }
+
+    return samples[rank - 1];
+}
+
+void bench_suite_start(const char* suite)
+{
+    uint64_t start;
+    uint64_t delta;
+    uint32_t i;
+
+    bench_suite        = suite;
+    bench_failures     = 0;
+    bench_sample_count = 0;
+
+    kernel_printf("[TESTMODE] %s bench start\n", suite);
+
+    bench_timer_overhead = (uint64_t)-1;
+    for(i = 0; i < BENCH_OVERHEAD_ROUNDS; ++i)
+    {
+        start = cpu_get_timestamp();
+        delta = cpu_get_timestamp() - start;
+        if(delta < bench_timer_overhead)
+        {
+            bench_timer_overhead = delta;
+        }
+    }
+}
+
+void bench_suite_end(void)
+{
+    if(bench_failures != 0)
+    {
+        kernel_error("%s bench failed %d\n", bench_suite, bench_failures);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] %s bench passed\n", bench_suite);
+    }
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+
+void bench_fail(const char* reason)
+{
+    kernel_error("%s bench: %s\n", bench_suite, reason);
+    ++bench_failures;
+}
+
+void bench_run(const char* name,
+               void (*routine)(void* args),
+               void* args,
+               const uint32_t warmup,
+               const uint32_t iterations)
+{
+    uint64_t start;
+    uint32_t i;
+
+    for(i = 0; i < warmup; ++i)
+    {
+        routine(args);
+    }
+
+    for(i = 0; i < iterations; ++i)
+    {
+        start = cpu_get_timestamp();
+        routine(args);
+        bench_record_elapsed(start, 1);
+    }
+
+    bench_report(name, NULL);
+}
+
+void bench_record(const uint64_t cycles)
+{
+    if(bench_sample_count < BENCH_MAX_SAMPLES)
+    {
+        bench_samples[bench_sample_count++] = cycles;
+    }
+}
+
+uint64_t bench_record_elapsed(const uint64_t start, const uint32_t divider)
+{
+    uint64_t delta;
+
+    delta = cpu_get_timestamp() - start;
+    delta = (delta > bench_timer_overhead) ? delta - bench_timer_overhead : 0;
+    if(divider > 1)
+    {
+        delta /= divider;
+    }
+
+    bench_record(delta);
+
+    return delta;
+}
+
+void bench_report(const char* name, bench_stats_t* stats)
+{
+    bench_stats_t result;
+    uint64_t      sum;
+    uint32_t      i;
+
+    result.samples = bench_sample_count;
+    result.min     = 0;
+    result.median  = 0;
+    result.p99     = 0;
+    result.max     = 0;
+    result.mean    = 0;
+
+    if(bench_sample_count != 0)
+    {
+        bench_sort(bench_samples, bench_sample_count);
+
+        sum = 0;
+        for(i = 0; i < bench_sample_count; ++i)
+        {
+            sum += bench_samples[i];
+        }
+
+        result.min    = bench_samples[0];
+        result.median = bench_percentile(bench_samples, bench_sample_count, 50);
+        result.p99    = bench_percentile(bench_samples, bench_sample_count, 99);
+        result.max    = bench_samples[bench_sample_count - 1];
+        result.mean   = sum / bench_sample_count;
+    }
+    else
+    {
+        bench_fail("no sample recorded");
+    }
+
+    kernel_printf(BENCH_RESULT_TAG ",%s,%s,%u,%llu,%llu,%llu,%llu,%llu\n",
+                  bench_suite, name, result.samples, result.min,
+                  result.median, result.p99, result.max, result.mean);
+
+    if(stats != NULL)
+    {
+        *stats = result;
+    }
+
+    bench_sample_count = 0;
+}
+
+void bench_metric(const char* name, const int64_t value)
+{
+    kernel_printf(BENCH_METRIC_TAG ",%s,%s,%lld\n", bench_suite, name, value);
+}
+
+uint64_t bench_get_timer_overhead(void)
+{
+    return bench_timer_overhead;
+}
+
+#endif /* #ifdef TEST_MODE_ENABLED */
+
+/************************************ EOF *************************************/
\ No newline at end of file
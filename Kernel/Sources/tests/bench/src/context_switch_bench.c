@@ -0,0 +1,286 @@
+
+
+#include <test_bank.h>
+
+#if CONTEXT_SWITCH_BENCH == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <futex.h>
+#include <cpu_api.h>
+#include <sys/process.h>
+#include <bench.h>
+
+#define CONTEXT_SWITCH_BENCH_WARMUP      100
+#define CONTEXT_SWITCH_BENCH_ROUNDS      2000
+#define CONTEXT_SWITCH_BENCH_PRIORITY    1
+#define CONTEXT_SWITCH_BENCH_STACK       0x1000
+#define CONTEXT_SWITCH_BENCH_MAX_THREADS 32
+
+static kernel_thread_t* bench_threads[CONTEXT_SWITCH_BENCH_MAX_THREADS];
+static kernel_thread_t* bench_fillers[CONTEXT_SWITCH_BENCH_MAX_THREADS];
+
+static volatile uint32_t bench_turn;
+static volatile uint32_t bench_done;
+static uint32_t          bench_divider;
+
+static void bench_futex(const SYSCALL_FUNCTION_E func, const uint32_t val)
+{
+    futex_t futex;
+
+    futex.addr = (uint32_t*)&bench_turn;
+    futex.val  = val;
+    if(func == SYSCALL_FUTEX_WAIT)
+    {
+        futex_wait(func, &futex);
+    }
+    else
+    {
+        futex_wake(func, &futex);
+    }
+}
+
+/* Gives the turn to the partner and waits for it to give it back */
+static void* bench_pingpong_main(void* args)
+{
+    uint64_t start;
+    uint32_t i;
+
+    (void)args;
+
+    for(i = 0; i < CONTEXT_SWITCH_BENCH_WARMUP + CONTEXT_SWITCH_BENCH_ROUNDS;
+        ++i)
+    {
+        start = cpu_get_timestamp();
+
+        bench_turn = 1;
+        bench_futex(SYSCALL_FUTEX_WAKE, 1);
+        while(bench_turn == 1)
+        {
+            bench_futex(SYSCALL_FUTEX_WAIT, 1);
+        }
+
+        /* A round trip is two switches */
+        if(i >= CONTEXT_SWITCH_BENCH_WARMUP)
+        {
+            bench_record_elapsed(start, 2);
+        }
+    }
+
+    return NULL;
+}
+
+static void* bench_pingpong_partner(void* args)
+{
+    uint32_t i;
+
+    (void)args;
+
+    for(i = 0; i < CONTEXT_SWITCH_BENCH_WARMUP + CONTEXT_SWITCH_BENCH_ROUNDS;
+        ++i)
+    {
+        while(bench_turn == 0)
+        {
+            bench_futex(SYSCALL_FUTEX_WAIT, 0);
+        }
+        bench_turn = 0;
+        bench_futex(SYSCALL_FUTEX_WAKE, 1);
+    }
+
+    return NULL;
+}
+
+/* Yields and measures until the other threads of its priority ran once */
+static void* bench_yield_main(void* args)
+{
+    uint64_t start;
+    uint32_t i;
+
+    (void)args;
+
+    for(i = 0; i < CONTEXT_SWITCH_BENCH_WARMUP + CONTEXT_SWITCH_BENCH_ROUNDS;
+        ++i)
+    {
+        start = cpu_get_timestamp();
+        sched_schedule();
+        if(i >= CONTEXT_SWITCH_BENCH_WARMUP)
+        {
+            bench_record_elapsed(start, bench_divider);
+        }
+    }
+    bench_done = 1;
+
+    return NULL;
+}
+
+static void* bench_yield_partner(void* args)
+{
+    (void)args;
+
+    while(bench_done == 0)
+    {
+        sched_schedule();
+    }
+
+    return NULL;
+}
+
+static void* bench_filler(void* args)
+{
+    (void)args;
+
+    return NULL;
+}
+
+static void bench_join(kernel_thread_t** threads, const uint32_t count)
+{
+    uint32_t i;
+
+    for(i = 0; i < count; ++i)
+    {
+        if(threads[i] != NULL &&
+           sched_join_thread(threads[i], NULL, NULL) != OS_NO_ERR)
+        {
+            bench_fail("could not join a bench thread");
+        }
+        threads[i] = NULL;
+    }
+}
+
+static void bench_spawn(kernel_thread_t** thread,
+                        const uint32_t priority,
+                        void* (*routine)(void*))
+{
+    if(sched_create_kernel_thread(thread, priority, "cs_bench",
+                                  THREAD_TYPE_KERNEL,
+                                  CONTEXT_SWITCH_BENCH_STACK,
+                                  routine, NULL) != OS_NO_ERR)
+    {
+        *thread = NULL;
+        bench_fail("could not create a bench thread");
+    }
+}
+
+static void bench_futex_pingpong(void)
+{
+    bench_turn = 0;
+
+    bench_spawn(&bench_threads[0], CONTEXT_SWITCH_BENCH_PRIORITY,
+                bench_pingpong_main);
+    bench_spawn(&bench_threads[1], CONTEXT_SWITCH_BENCH_PRIORITY,
+                bench_pingpong_partner);
+    bench_join(bench_threads, 2);
+
+    bench_report("futex_pingpong", NULL);
+}
+
+/* Yields with the given number of threads at the bench priority and fillers
+ * ready at lower, varied priorities.
+ */
+static void bench_yield(const char* name,
+                        const uint32_t threads,
+                        const uint32_t fillers)
+{
+    uint32_t i;
+
+    bench_done    = 0;
+    bench_divider = (threads > 1) ? threads : 1;
+
+    /* The fillers never run before the bench threads are done */
+    for(i = 0; i < fillers; ++i)
+    {
+        bench_spawn(&bench_fillers[i],
+                    CONTEXT_SWITCH_BENCH_PRIORITY + 1 +
+                    (i * 7) % (KERNEL_LOWEST_PRIORITY - 3),
+                    bench_filler);
+    }
+
+    bench_spawn(&bench_threads[0], CONTEXT_SWITCH_BENCH_PRIORITY,
+                bench_yield_main);
+    for(i = 1; i < threads; ++i)
+    {
+        bench_spawn(&bench_threads[i], CONTEXT_SWITCH_BENCH_PRIORITY,
+                    bench_yield_partner);
+    }
+
+    bench_join(bench_threads, threads);
+    bench_join(bench_fillers, fillers);
+
+    bench_report(name, NULL);
+}
+
+/* The parent and the child yield to each other, each switch changes the
+ * address space.
+ */
+static void bench_yield_cross_process(void)
+{
+    int32_t     pid;
+    int32_t     status;
+    int32_t     term_cause;
+    OS_RETURN_E err;
+    uint64_t    start;
+    uint32_t    i;
+
+    /* The forked thread inherits the INIT priority, both processes run alone
+     * at this priority.
+     */
+    pid = fork();
+    if(pid < 0)
+    {
+        bench_fail("could not fork");
+        return;
+    }
+
+    if(pid == 0)
+    {
+        /* Keep yielding until the parent measured all its rounds */
+        for(i = 0; i < CONTEXT_SWITCH_BENCH_WARMUP +
+                       CONTEXT_SWITCH_BENCH_ROUNDS + 2; ++i)
+        {
+            sched_schedule();
+        }
+        exit(0);
+    }
+
+    for(i = 0; i < CONTEXT_SWITCH_BENCH_WARMUP + CONTEXT_SWITCH_BENCH_ROUNDS;
+        ++i)
+    {
+        start = cpu_get_timestamp();
+        sched_schedule();
+        if(i >= CONTEXT_SWITCH_BENCH_WARMUP)
+        {
+            bench_record_elapsed(start, 2);
+        }
+    }
+
+    pid = waitpid(pid, &status, &term_cause, &err);
+    if(err != OS_NO_ERR || status != 0)
+    {
+        bench_fail("could not wait the child process");
+    }
+
+    bench_report("yield_cross_process", NULL);
+}
+
+void context_switch_bench(void)
+{
+    bench_suite_start("Context switch");
+
+    bench_futex_pingpong();
+
+    bench_yield("yield_alone", 1, 0);
+    bench_yield("yield_pair", 2, 0);
+    bench_yield_cross_process();
+    bench_yield("yield_pair_8_ready", 2, 8);
+    bench_yield("yield_pair_32_ready", 2, 32);
+    bench_yield("yield_rr_4", 4, 0);
+    bench_yield("yield_rr_16", 16, 0);
+
+    bench_suite_end();
+}
+#else
+void context_switch_bench(void)
+{
+
+}
+#endif
\ No newline at end of file
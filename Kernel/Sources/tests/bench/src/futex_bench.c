@@ -0,0 +1,66 @@
+
+
+#include <test_bank.h>
+
+#if FUTEX_BENCH == 1
+
+#include <futex.h>
+#include <bench.h>
+
+#define FUTEX_BENCH_WARMUP     100
+#define FUTEX_BENCH_ITERATIONS 2000
+
+static uint32_t bench_word;
+
+static void futex_bench_wait_mismatch(void* args)
+{
+    futex_t* futex;
+
+    futex = args;
+    futex_wait(SYSCALL_FUTEX_WAIT, futex);
+}
+
+static void futex_bench_wake_empty(void* args)
+{
+    futex_t* futex;
+
+    futex = args;
+    futex_wake(SYSCALL_FUTEX_WAKE, futex);
+}
+
+void futex_bench(void)
+{
+    futex_t futex;
+
+    bench_suite_start("Futex");
+
+    bench_word = 0;
+
+    /* The value differs, the wait must return immediately */
+    futex.addr = &bench_word;
+    futex.val  = 1;
+    bench_run("wait_mismatch", futex_bench_wait_mismatch, &futex,
+              FUTEX_BENCH_WARMUP, FUTEX_BENCH_ITERATIONS);
+    if(futex.error != OS_NO_ERR)
+    {
+        bench_fail("wait on a changed value returned an error");
+    }
+
+    /* Nobody waits on the word, the wake must find no queue */
+    futex.addr = &bench_word;
+    futex.val  = 1;
+    bench_run("wake_empty", futex_bench_wake_empty, &futex,
+              FUTEX_BENCH_WARMUP, FUTEX_BENCH_ITERATIONS);
+    if(futex.error != OS_ERR_NO_SUCH_ID)
+    {
+        bench_fail("wake without waiter found a queue");
+    }
+
+    bench_suite_end();
+}
+#else
+void futex_bench(void)
+{
+
+}
+#endif
\ No newline at end of file
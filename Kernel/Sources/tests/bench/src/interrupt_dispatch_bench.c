@@ -0,0 +1,143 @@
+#include <test_bank.h>
+
+#if INTERRUPT_DISPATCH_BENCH == 1
+
+#include <scheduler.h>
+#include <interrupts.h>
+#include <interrupt_settings.h>
+#include <cpu_api.h>
+#include <bench.h>
+#include <sys/syscall_api.h>
+
+#define INTERRUPT_DISPATCH_BENCH_ROUNDS 1000
+#define INTERRUPT_DISPATCH_BENCH_SLEEPS 100
+
+/** @brief Dispatch counters snapshot of one interrupt line. */
+typedef struct
+{
+    /** @brief The interrupt line. */
+    uint32_t line;
+
+    /** @brief Dispatch count at the last snapshot. */
+    uint64_t count;
+
+    /** @brief Dispatch cycles at the last snapshot. */
+    uint64_t cycles;
+
+    /** @brief Dispatch count since the first snapshot. */
+    uint64_t total;
+} dispatch_snapshot_t;
+
+static void interrupt_dispatch_bench_init(dispatch_snapshot_t* snapshot,
+                                          const uint32_t line)
+{
+    snapshot->line  = line;
+    snapshot->total = 0;
+    if(kernel_interrupt_get_dispatch_cost(line, &snapshot->count,
+                                          &snapshot->cycles) != OS_NO_ERR)
+    {
+        bench_fail("could not get the dispatch cost");
+    }
+}
+
+static void interrupt_dispatch_bench_sample(dispatch_snapshot_t* snapshot)
+{
+    uint64_t count;
+    uint64_t cycles;
+
+    if(kernel_interrupt_get_dispatch_cost(snapshot->line, &count,
+                                          &cycles) != OS_NO_ERR)
+    {
+        bench_fail("could not get the dispatch cost");
+        return;
+    }
+
+    /* One sample is the mean dispatch cost since the last snapshot */
+    if(count != snapshot->count)
+    {
+        bench_record((cycles - snapshot->cycles) / (count - snapshot->count));
+        snapshot->total += count - snapshot->count;
+    }
+
+    snapshot->count  = count;
+    snapshot->cycles = cycles;
+}
+
+static void interrupt_dispatch_bench_syscall(void)
+{
+    dispatch_snapshot_t snapshot;
+    sched_param_t       params;
+    int                 i;
+
+    interrupt_dispatch_bench_init(&snapshot, SYSCALL_INT_LINE);
+
+    /* System calls go through the direct path */
+    for(i = 0; i < INTERRUPT_DISPATCH_BENCH_ROUNDS; ++i)
+    {
+        cpu_syscall(SYSCALL_SCHED_GET_PARAMS, &params);
+        interrupt_dispatch_bench_sample(&snapshot);
+    }
+
+    if(snapshot.total < INTERRUPT_DISPATCH_BENCH_ROUNDS)
+    {
+        bench_fail("dispatch count mismatch");
+    }
+
+    bench_report("syscall", NULL);
+    bench_metric("syscall_dispatches", snapshot.total);
+}
+
+static void interrupt_dispatch_bench_sleep(void)
+{
+    dispatch_snapshot_t timer;
+    dispatch_snapshot_t sched;
+    int                 i;
+
+    interrupt_dispatch_bench_init(&timer, LAPIC_TIMER_INTERRUPT_LINE);
+    interrupt_dispatch_bench_init(&sched, SCHEDULER_SW_INT_LINE);
+
+    /* Sleeping raises the scheduler and the timer interrupts */
+    for(i = 0; i < INTERRUPT_DISPATCH_BENCH_SLEEPS; ++i)
+    {
+        sched_sleep(1);
+        interrupt_dispatch_bench_sample(&timer);
+    }
+    bench_report("timer", NULL);
+    bench_metric("timer_dispatches", timer.total);
+
+    for(i = 0; i < INTERRUPT_DISPATCH_BENCH_SLEEPS; ++i)
+    {
+        sched_sleep(1);
+        interrupt_dispatch_bench_sample(&sched);
+    }
+    bench_report("scheduler", NULL);
+    bench_metric("scheduler_dispatches", sched.total);
+}
+
+void interrupt_dispatch_bench(void)
+{
+    uint64_t count;
+    uint64_t cycles;
+
+    bench_suite_start("Interrupt dispatch");
+
+    if(kernel_interrupt_get_dispatch_cost(MAX_INTERRUPT_LINE + 1, &count,
+                                          &cycles) !=
+       OR_ERR_UNAUTHORIZED_INTERRUPT_LINE ||
+       kernel_interrupt_get_dispatch_cost(SYSCALL_INT_LINE, NULL, &cycles) !=
+       OS_ERR_NULL_POINTER)
+    {
+        bench_fail("dispatch cost parameters check failed");
+    }
+
+    interrupt_dispatch_bench_syscall();
+    interrupt_dispatch_bench_sleep();
+
+    bench_suite_end();
+}
+#else
+void interrupt_dispatch_bench(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+
+
+#include <test_bank.h>
+
+#if KHEAP_BENCH == 1
+
+#include <kheap.h>
+#include <bench.h>
+
+#define KHEAP_BENCH_WARMUP     100
+#define KHEAP_BENCH_ITERATIONS 2000
+#define KHEAP_BENCH_BATCH      64
+
+static void*    bench_blocks[KHEAP_BENCH_BATCH];
+static uint32_t bench_errors;
+
+static void kheap_bench_pair(void* args)
+{
+    void* block;
+
+    block = kmalloc((size_t)args);
+    if(block == NULL)
+    {
+        ++bench_errors;
+        return;
+    }
+    kfree(block);
+}
+
+static void kheap_bench_batch(void* args)
+{
+    uint32_t i;
+
+    for(i = 0; i < KHEAP_BENCH_BATCH; ++i)
+    {
+        bench_blocks[i] = kmalloc((size_t)args);
+        if(bench_blocks[i] == NULL)
+        {
+            ++bench_errors;
+        }
+    }
+    for(i = 0; i < KHEAP_BENCH_BATCH; ++i)
+    {
+        if(bench_blocks[i] != NULL)
+        {
+            kfree(bench_blocks[i]);
+        }
+    }
+}
+
+void kheap_bench(void)
+{
+    uint32_t free_before;
+
+    bench_suite_start("Kheap");
+
+    bench_errors = 0;
+    free_before  = kheap_get_free();
+
+    bench_run("pair_16", kheap_bench_pair, (void*)16,
+              KHEAP_BENCH_WARMUP, KHEAP_BENCH_ITERATIONS);
+    bench_run("pair_256", kheap_bench_pair, (void*)256,
+              KHEAP_BENCH_WARMUP, KHEAP_BENCH_ITERATIONS);
+    bench_run("pair_4096", kheap_bench_pair, (void*)4096,
+              KHEAP_BENCH_WARMUP, KHEAP_BENCH_ITERATIONS);
+    bench_run("batch_64x64", kheap_bench_batch, (void*)64,
+              KHEAP_BENCH_WARMUP / 10, KHEAP_BENCH_ITERATIONS / 10);
+
+    if(bench_errors != 0)
+    {
+        bench_fail("allocation failed");
+    }
+    if(kheap_get_free() != free_before)
+    {
+        bench_fail("free memory changed");
+    }
+
+    bench_suite_end();
+}
+#else
+void kheap_bench(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <test_bank.h>
+
+#if PRINTF_BENCH == 1
+
+#include <kernel_output.h>
+#include <string.h>
+#include <bench.h>
+
+#define PRINTF_BENCH_WARMUP     10
+#define PRINTF_BENCH_ITERATIONS 1000
+#define PRINTF_BENCH_BUFFER     128
+
+static char bench_buffer[PRINTF_BENCH_BUFFER];
+
+static void printf_bench_check(const char* expected,
+                               const int32_t length,
+                               const int32_t expected_length)
+{
+    if(strcmp(bench_buffer, expected) != 0 || length != expected_length)
+    {
+        kernel_error("Printf bench output \"%s\" (%d), expected \"%s\"\n",
+                     bench_buffer, length, expected);
+        bench_fail("wrong format output");
+    }
+}
+
+static void printf_bench_format(void)
+{
+    int32_t length;
+
+    length = kernel_snprintf(bench_buffer, sizeof(bench_buffer),
+                             "Literal only string");
+    printf_bench_check("Literal only string", length, 19);
+
+    length = kernel_snprintf(bench_buffer, sizeof(bench_buffer),
+                             "%d %i %u %d", -3, 0, 4294967295U,
+                             -2147483647 - 1);
+    printf_bench_check("-3 0 4294967295 -2147483648", length, 27);
+
+    length = kernel_snprintf(bench_buffer, sizeof(bench_buffer),
+                             "%x %X %08x|%4d|%04d|%c%s", 0xFFFFFFFF,
+                             0xABCDEF, 0x1F, 42, -7, 'a', "bc");
+    printf_bench_check("ffffffff ABCDEF 0000001f|  42|-007|abc", length, 38);
+
+    length = kernel_snprintf(bench_buffer, sizeof(bench_buffer),
+                             "%llu %lld %llx", 18446744073709551615ULL,
+                             -9000000000LL, 0x123456789ULL);
+    printf_bench_check("18446744073709551615 -9000000000 123456789",
+                       length, 42);
+
+    length = kernel_snprintf(bench_buffer, sizeof(bench_buffer),
+                             "%llu %llu %hhu %%", 10000000000ULL,
+                             4294967296ULL, 0x1FF);
+    printf_bench_check("10000000000 4294967296 255 %", length, 28);
+
+    length = kernel_snprintf(bench_buffer, 8, "Truncated %d", 12345);
+    printf_bench_check("Truncat", length, 15);
+
+    length = kernel_snprintf(NULL, 0, "%d", 123);
+    if(length != 3)
+    {
+        bench_fail("wrong length without buffer");
+    }
+}
+
+static void printf_bench_literal(void* args)
+{
+    (void)args;
+    kernel_snprintf(bench_buffer, sizeof(bench_buffer),
+                    "A literal string without any format sequence\n");
+}
+
+static void printf_bench_decimal(void* args)
+{
+    (void)args;
+    kernel_snprintf(bench_buffer, sizeof(bench_buffer), "%d %d %u %u\n",
+                    123456, -987654, 4000000000U, 7U);
+}
+
+static void printf_bench_hex(void* args)
+{
+    (void)args;
+    kernel_snprintf(bench_buffer, sizeof(bench_buffer), "0x%08x 0x%X 0x%p\n",
+                    0xDEADBEEF, 0x1234, bench_buffer);
+}
+
+static void printf_bench_64_bits(void* args)
+{
+    (void)args;
+    kernel_snprintf(bench_buffer, sizeof(bench_buffer), "%llu %llx\n",
+                    18446744073709551615ULL, 0x0123456789ABCDEFULL);
+}
+
+static void printf_bench_mixed(void* args)
+{
+    (void)args;
+    kernel_snprintf(bench_buffer, sizeof(bench_buffer),
+                    "[%s] Value %d at 0x%p, %c%c\n",
+                    "BENCH", 42, bench_buffer, 'o', 'k');
+}
+
+void printf_bench(void)
+{
+    bench_suite_start("Printf");
+
+    printf_bench_format();
+
+    bench_run("literal", printf_bench_literal, NULL,
+              PRINTF_BENCH_WARMUP, PRINTF_BENCH_ITERATIONS);
+    bench_run("decimal", printf_bench_decimal, NULL,
+              PRINTF_BENCH_WARMUP, PRINTF_BENCH_ITERATIONS);
+    bench_run("hex", printf_bench_hex, NULL,
+              PRINTF_BENCH_WARMUP, PRINTF_BENCH_ITERATIONS);
+    bench_run("64_bits", printf_bench_64_bits, NULL,
+              PRINTF_BENCH_WARMUP, PRINTF_BENCH_ITERATIONS);
+    bench_run("mixed", printf_bench_mixed, NULL,
+              PRINTF_BENCH_WARMUP, PRINTF_BENCH_ITERATIONS);
+
+    bench_suite_end();
+}
+#else
+void printf_bench(void)
+{
+
+}
+#endif
\ No newline at end of file
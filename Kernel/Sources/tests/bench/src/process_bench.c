@@ -0,0 +1,198 @@
+
+
+#include <test_bank.h>
+
+#if PROCESS_BENCH == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <workqueue.h>
+#include <kstats.h>
+#include <memmgt.h>
+#include <cpu_api.h>
+#include <time_management.h>
+#include <sys/process.h>
+#include <sys/syscall_api.h>
+#include <bench.h>
+
+#define PROCESS_BENCH_WARMUP    10
+#define PROCESS_BENCH_ROUNDS    200
+#define PROCESS_BENCH_NAME_SIZE 64
+
+/* Mapped pages added to the parent before each set of rounds */
+static const uint32_t bench_mapped_pages[] = {0, 256, 1024, 4096};
+
+static const char* bench_phase_names[KSTATS_PHASE_COUNT] = {
+    "fork",
+    "copy_mapping",
+    "copy_stack",
+    "exit",
+    "clean_memory",
+    "waitpid"
+};
+
+static bool_t bench_map_pages(const uint32_t page_count)
+{
+    memmgt_page_alloc_param_t alloc_param;
+
+    if(page_count == 0)
+    {
+        return TRUE;
+    }
+
+    /* The pages are never touched, the parent must not fault on the copy on
+     * write mappings shared with its children.
+     */
+    alloc_param.page_count = page_count;
+    syscall_do(SYSCALL_PAGE_ALLOC, &alloc_param);
+
+    return alloc_param.error == OS_NO_ERR;
+}
+
+/* Forks a child that exits right away, lets it run and reaps it. The process
+ * memory is released by the workqueue, flushing it accounts the release.
+ */
+static bool_t bench_fork_exit_wait(void)
+{
+    int32_t     pid;
+    int32_t     status;
+    int32_t     term_cause;
+    OS_RETURN_E err;
+
+    pid = fork();
+    if(pid < 0)
+    {
+        return FALSE;
+    }
+    if(pid == 0)
+    {
+        exit(0);
+    }
+
+    /* The child inherits the INIT priority, yielding lets it exit */
+    sched_schedule();
+
+    pid = waitpid(pid, &status, &term_cause, &err);
+    if(pid < 0 || err != OS_NO_ERR || status != 0)
+    {
+        return FALSE;
+    }
+
+    return workqueue_flush() == OS_NO_ERR;
+}
+
+static void bench_process_phases(const char* prefix)
+{
+    kstats_phase_t stats;
+    char           name[PROCESS_BENCH_NAME_SIZE];
+    uint32_t       i;
+
+    for(i = 0; i < KSTATS_PHASE_COUNT; ++i)
+    {
+        if(kstats_get_phase(i, &stats) != OS_NO_ERR)
+        {
+            return;
+        }
+
+        kernel_snprintf(name, sizeof(name), "%s_%s_count",
+                        prefix, bench_phase_names[i]);
+        bench_metric(name, stats.count);
+        kernel_snprintf(name, sizeof(name), "%s_%s_mean_cycles",
+                        prefix, bench_phase_names[i]);
+        bench_metric(name, stats.count != 0 ? stats.cycles / stats.count : 0);
+        kernel_snprintf(name, sizeof(name), "%s_%s_max_cycles",
+                        prefix, bench_phase_names[i]);
+        bench_metric(name, stats.max);
+    }
+}
+
+static void bench_process(const uint32_t mapped_pages)
+{
+    char     name[PROCESS_BENCH_NAME_SIZE];
+    uint64_t start;
+    uint64_t uptime;
+    uint32_t free_frames;
+    int64_t  leaked;
+    uint32_t i;
+
+    kernel_snprintf(name, sizeof(name), "fork_exit_wait_%up", mapped_pages);
+
+    for(i = 0; i < PROCESS_BENCH_WARMUP; ++i)
+    {
+        if(bench_fork_exit_wait() == FALSE)
+        {
+            bench_fail("could not fork, exit and wait");
+            return;
+        }
+    }
+
+    kstats_clear();
+    free_frames = memory_get_free_frames();
+    uptime      = time_get_current_uptime();
+
+    for(i = 0; i < PROCESS_BENCH_ROUNDS; ++i)
+    {
+        start = cpu_get_timestamp();
+        if(bench_fork_exit_wait() == FALSE)
+        {
+            bench_fail("could not fork, exit and wait");
+            return;
+        }
+        bench_record_elapsed(start, 1);
+    }
+
+    uptime = time_get_current_uptime() - uptime;
+    /* Negative when the rounds gave back frames held before the bench */
+    leaked = (int64_t)free_frames - (int64_t)memory_get_free_frames();
+
+    bench_report(name, NULL);
+
+    /* The uptime has the main timer resolution, enough over all the rounds */
+    kernel_snprintf(name, sizeof(name), "fork_exit_wait_%up_per_second",
+                    mapped_pages);
+    bench_metric(name, uptime != 0 ?
+                       (uint64_t)PROCESS_BENCH_ROUNDS * 1000000000ULL / uptime :
+                       0);
+    kernel_snprintf(name, sizeof(name), "fork_exit_wait_%up_leaked_frames",
+                    mapped_pages);
+    bench_metric(name, leaked);
+
+    kernel_snprintf(name, sizeof(name), "fork_exit_wait_%up", mapped_pages);
+    bench_process_phases(name);
+}
+
+void process_bench(void)
+{
+    uint32_t mapped;
+    uint32_t i;
+
+    bench_suite_start("Process");
+
+    if(kstats_clear() != OS_NO_ERR)
+    {
+        kernel_printf("[TESTMODE] Kernel built without STATS=TRUE, "
+                      "phases not reported\n");
+    }
+
+    mapped = 0;
+    for(i = 0; i < sizeof(bench_mapped_pages) / sizeof(bench_mapped_pages[0]);
+        ++i)
+    {
+        if(bench_map_pages(bench_mapped_pages[i] - mapped) == FALSE)
+        {
+            bench_fail("could not map the parent pages");
+            break;
+        }
+        mapped = bench_mapped_pages[i];
+
+        bench_process(mapped);
+    }
+
+    bench_suite_end();
+}
+#else
+void process_bench(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include <test_bank.h>
+
+#if SYSCALL_BENCH == 1
+
+#include <futex.h>
+#include <cpu_api.h>
+#include <bench.h>
+#include <sys/syscall_api.h>
+
+#define SYSCALL_BENCH_WARMUP     100
+#define SYSCALL_BENCH_ITERATIONS 4000
+
+/** @brief System call round trip benchmark parameters. */
+typedef struct
+{
+    /** @brief The system call entry path. */
+    void (*raise)(uint32_t, void*);
+
+    /** @brief The system call ID. */
+    SYSCALL_FUNCTION_E func;
+
+    /** @brief The system call parameters. */
+    void* params;
+} syscall_bench_args_t;
+
+static volatile uint32_t bench_word;
+
+static void syscall_bench_raise(void* args)
+{
+    syscall_bench_args_t* bench_args;
+
+    bench_args = args;
+    bench_args->raise(bench_args->func, bench_args->params);
+}
+
+static void syscall_bench_compare(const char* int_name,
+                                  const char* fast_name,
+                                  const SYSCALL_FUNCTION_E func)
+{
+    syscall_bench_args_t args;
+    sched_param_t        params;
+    futex_t              futex;
+
+    futex.addr = (uint32_t*)&bench_word;
+    futex.val  = 1;
+
+    args.func   = func;
+    args.params = (func == SYSCALL_FUTEX_WAKE) ? (void*)&futex :
+                                                 (void*)&params;
+
+    args.raise = cpu_syscall;
+    bench_run(int_name, syscall_bench_raise, &args,
+              SYSCALL_BENCH_WARMUP, SYSCALL_BENCH_ITERATIONS);
+
+    args.raise = cpu_syscall_fast;
+    bench_run(fast_name, syscall_bench_raise, &args,
+              SYSCALL_BENCH_WARMUP, SYSCALL_BENCH_ITERATIONS);
+
+    /* Nobody waits on the word, the wake must find no queue */
+    if((func == SYSCALL_FUTEX_WAKE && futex.error != OS_ERR_NO_SUCH_ID) ||
+       (func != SYSCALL_FUTEX_WAKE && params.error != OS_NO_ERR))
+    {
+        bench_fail("system call failed");
+    }
+}
+
+void syscall_bench(void)
+{
+    sched_param_t int_params;
+    sched_param_t fast_params;
+
+    bench_suite_start("Syscall");
+
+    /* Both paths must reach the same handler */
+    cpu_syscall(SYSCALL_SCHED_GET_PARAMS, &int_params);
+    cpu_syscall_fast(SYSCALL_SCHED_GET_PARAMS, &fast_params);
+    if(int_params.error != OS_NO_ERR || fast_params.error != OS_NO_ERR ||
+       int_params.tid != fast_params.tid ||
+       int_params.pid != fast_params.pid ||
+       int_params.priority != fast_params.priority)
+    {
+        bench_fail("fast system call returned different parameters");
+    }
+
+    if(syscall_fast_allowed(SYSCALL_FORK) != FALSE ||
+       syscall_fast_allowed(SYSCALL_MAX_ID) != FALSE ||
+       syscall_fast_allowed(SYSCALL_FUTEX_WAIT) != TRUE)
+    {
+        bench_fail("wrong fast system call eligibility");
+    }
+
+    syscall_bench_compare("sched_get_params_interrupt",
+                          "sched_get_params_fast",
+                          SYSCALL_SCHED_GET_PARAMS);
+    syscall_bench_compare("futex_wake_interrupt",
+                          "futex_wake_fast",
+                          SYSCALL_FUTEX_WAKE);
+
+    bench_suite_end();
+}
+#else
+void syscall_bench(void)
+{
+
+}
+#endif
\ No newline at end of file
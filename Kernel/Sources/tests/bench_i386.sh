@@ -0,0 +1,110 @@
+#!/bin/bash
+################################################################################
+# UTK benchmark runner
+#
+# Created: 05/04/2022
+#
+# Author: Alexy Torres Aurora Dugo
+#
+# Boots QEMU once per benchmark suite of the bench module and collects the
+# results in a CSV file, one line per benchmark. All values are CPU cycles.
+# The other metrics reported by the suites are collected in a second CSV file
+# named after the first one. The kernel is built with the phase statistics.
+#
+# Usage: bench_i386.sh [output CSV file] [suite name...]
+################################################################################
+
+output=${1:-bench_results.csv}
+metrics="${output%.csv}_metrics.csv"
+shift
+
+revision=$(git rev-parse --short HEAD 2>/dev/null || echo "unknown")
+
+function benchcase() {
+    entry=$1
+
+    filename=$(basename -- "$entry")
+    filename="${filename%.*}"
+    filename_up=${filename^^}
+
+    echo -e "\e[94m################### Bench $i/$total : $filename_up \e[39m"
+    # Select the benchmark
+    sed -i "s/ $filename_up 0/ $filename_up 1/g" includes/test_bank.h
+    # Execute the benchmark
+    {
+    rm -f *.out
+    cd ../../
+    make target=x86_i386 TESTS=TRUE STATS=TRUE && (make target=x86_i386 qemu-test-mode | tee bench.out)
+    mv bench.out Sources/tests/bench.out
+    cd Sources/tests
+    } &> /dev/null
+    # Collect the results
+    grep -a "\[BENCH\] RESULT," bench.out | tr -d '\r' | \
+        sed "s/.*\[BENCH\] RESULT,/$revision,/" > results.out
+    grep -a "\[BENCH\] METRIC," bench.out | tr -d '\r' | \
+        sed "s/.*\[BENCH\] METRIC,/$revision,/" > metrics.out
+    if grep -aq "\[TESTMODE\] .* bench passed" bench.out && [ -s results.out ]
+    then
+        cat results.out >> $output
+        cat metrics.out >> $metrics
+        echo -e "\e[92mPASSED\e[39m ($(wc -l < results.out) results)"
+        success=$((success + 1))
+    else
+        echo -e "\e[31mERROR \e[39m"
+        error=$((error + 1))
+        grep -a "\[TESTMODE\]\|ERROR" bench.out
+        mv bench.out errors/$filename.bench.error
+    fi
+    #Clean data
+    rm -f *.out
+    #Restore non benchmark mode
+    sed -i "s/ $filename_up 1/ $filename_up 0/g" includes/test_bank.h
+}
+
+error=0
+success=0
+total=0
+i=1
+
+benches=()
+for entry in "./bench/src/"*_bench.c
+do
+    filename=$(basename -- "$entry")
+    filename="${filename%.*}"
+    filename_up=${filename^^}
+    sed -i "s/ $filename_up 1/ $filename_up 0/g" includes/test_bank.h
+
+    # Only keep the requested suites
+    if (( $# != 0 )) && [[ ! " $* " =~ " $filename " ]]; then
+        continue
+    fi
+    benches+=("$entry")
+    total=$((total + 1))
+done
+
+make -C ../../ clean
+mkdir -p errors
+
+echo "revision,suite,name,samples,min,median,p99,max,mean" > $output
+echo "revision,suite,name,value" > $metrics
+
+for entry in "${benches[@]}"
+do
+    benchcase $entry
+
+    i=$((i + 1))
+done
+
+echo ""
+echo -e "\e[94m################################### RESULTS ###################################\e[39m"
+echo ""
+echo -e "\e[94m Results written to $output and $metrics \e[39m"
+if (( error != 0 ))
+then
+    echo -e "\e[31m $error ERRORS \e[39m"
+    echo -e "\e[92m $success SUCCESS \e[39m"
+    exit -1
+else
+    echo -e "\e[92m 0 ERROR \e[39m"
+    echo -e "\e[92m $success SUCCESS \e[39m"
+fi
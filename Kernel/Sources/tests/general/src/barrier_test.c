@@ -0,0 +1,296 @@
+
+
+#include <test_bank.h>
+
+#if BARRIER_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <barrier.h>
+#include <latch.h>
+#include <atomic.h>
+
+#define BARRIER_TEST_THREADS 4
+#define BARRIER_TEST_ROUNDS  10
+
+static kernel_thread_t* thread_workers[BARRIER_TEST_THREADS];
+
+static barrier_t barrier1;
+static latch_t   latch1;
+
+static volatile int32_t  round_counter[BARRIER_TEST_ROUNDS];
+static volatile int32_t  serial_count;
+static volatile uint32_t round_errors;
+static volatile int32_t  released;
+
+void *barrier_worker(void *args);
+void *barrier_destroy_waiter(void *args);
+void *latch_waiter(void *args);
+
+void *barrier_worker(void *args)
+{
+    bool_t serial;
+    int    i;
+
+    (void)args;
+
+    for(i = 0; i < BARRIER_TEST_ROUNDS; ++i)
+    {
+        ATOMIC_FETCH_ADD(&round_counter[i], 1);
+
+        if(barrier_wait(&barrier1, &serial) != OS_NO_ERR)
+        {
+            kernel_error("Failed to wait barrier1\n");
+            return NULL;
+        }
+
+        /* Everybody must have reached this round */
+        if(round_counter[i] != BARRIER_TEST_THREADS)
+        {
+            ++round_errors;
+        }
+        if(serial == TRUE)
+        {
+            ATOMIC_FETCH_ADD(&serial_count, 1);
+        }
+    }
+
+    return NULL;
+}
+
+void *barrier_destroy_waiter(void *args)
+{
+    (void)args;
+
+    if(barrier_wait(&barrier1, NULL) == OS_ERR_NOT_INITIALIZED)
+    {
+        ATOMIC_FETCH_ADD(&released, 1);
+    }
+
+    return NULL;
+}
+
+void *latch_waiter(void *args)
+{
+    OS_RETURN_E err;
+
+    err = latch_wait(&latch1);
+    if(err == (OS_RETURN_E)(uintptr_t)args)
+    {
+        ATOMIC_FETCH_ADD(&released, 1);
+    }
+
+    return NULL;
+}
+
+static void barrier_test_create(void* (*routine)(void*), void* args)
+{
+    int i;
+
+    for(i = 0; i < BARRIER_TEST_THREADS; ++i)
+    {
+        if(sched_create_kernel_thread(&thread_workers[i], 5, "barrier_worker",
+                                      THREAD_TYPE_KERNEL, 0x1000,
+                                      routine, args) != OS_NO_ERR)
+        {
+            kernel_error("Error while creating the worker thread!\n");
+        }
+    }
+}
+
+static void barrier_test_join(void)
+{
+    int i;
+
+    for(i = 0; i < BARRIER_TEST_THREADS; ++i)
+    {
+        if(sched_join_thread(thread_workers[i], NULL, NULL) != OS_NO_ERR)
+        {
+            kernel_error("Error while waiting worker thread!\n");
+        }
+    }
+}
+
+static void barrier_test_rounds(void)
+{
+    int i;
+
+    for(i = 0; i < BARRIER_TEST_ROUNDS; ++i)
+    {
+        round_counter[i] = 0;
+    }
+    serial_count = 0;
+    round_errors = 0;
+
+    if(barrier_init(&barrier1, BARRIER_TEST_THREADS) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init barrier1\n");
+    }
+
+    barrier_test_create(barrier_worker, NULL);
+    barrier_test_join();
+
+    if(round_errors != 0 || serial_count != BARRIER_TEST_ROUNDS ||
+       barrier1.arrived != 0 || barrier1.generation != BARRIER_TEST_ROUNDS)
+    {
+        kernel_error("Barrier rounds failed %d %d %d\n",
+                     round_errors, serial_count, barrier1.generation);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Barrier rounds test passed\n");
+    }
+
+    if(barrier_destroy(&barrier1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to destroy barrier1\n");
+    }
+}
+
+static void barrier_test_destroy(void)
+{
+    released = 0;
+
+    if(barrier_init(&barrier1, 0) != OS_ERR_OUT_OF_BOUND)
+    {
+        kernel_error("Barrier init with 0 threads did not fail\n");
+    }
+
+    /* One more thread than waiters, the barrier never opens */
+    if(barrier_init(&barrier1, BARRIER_TEST_THREADS + 1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init barrier1\n");
+    }
+
+    barrier_test_create(barrier_destroy_waiter, NULL);
+    sched_sleep(50);
+
+    if(released != 0 || barrier1.arrived != BARRIER_TEST_THREADS)
+    {
+        kernel_error("Barrier opened early %d\n", released);
+    }
+
+    if(barrier_destroy(&barrier1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to destroy barrier1\n");
+    }
+    barrier_test_join();
+
+    if(barrier_wait(&barrier1, NULL) != OS_ERR_NOT_INITIALIZED)
+    {
+        kernel_error("Wait on destroyed barrier1 did not fail\n");
+    }
+
+    if(released != BARRIER_TEST_THREADS)
+    {
+        kernel_error("Destroy released %d threads\n", released);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Barrier destroy test passed\n");
+    }
+}
+
+static void barrier_test_latch(void)
+{
+    int32_t value;
+    int     i;
+
+    released = 0;
+
+    if(latch_init(&latch1, 3) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init latch1\n");
+    }
+
+    barrier_test_create(latch_waiter, (void*)OS_NO_ERR);
+    sched_sleep(50);
+
+    for(i = 0; i < 3; ++i)
+    {
+        if(released != 0)
+        {
+            kernel_error("Latch opened early %d\n", i);
+        }
+        if(latch_try_wait(&latch1, &value) != OS_ERR_UNAUTHORIZED_ACTION ||
+           value != 3 - i)
+        {
+            kernel_error("Latch try wait failed %d\n", value);
+        }
+        if(latch_count_down(&latch1) != OS_NO_ERR)
+        {
+            kernel_error("Failed to count down latch1\n");
+        }
+        sched_sleep(10);
+    }
+
+    barrier_test_join();
+
+    if(latch_try_wait(&latch1, &value) != OS_NO_ERR || value != 0)
+    {
+        kernel_error("Latch try wait on open latch failed %d\n", value);
+    }
+    if(latch_count_down(&latch1) != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("Count down on open latch did not fail\n");
+    }
+    if(latch_wait(&latch1) != OS_NO_ERR)
+    {
+        kernel_error("Wait on open latch failed\n");
+    }
+
+    if(released != BARRIER_TEST_THREADS)
+    {
+        kernel_error("Latch released %d threads\n", released);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Latch test passed\n");
+    }
+
+    /* Destroy with waiters */
+    released = 0;
+    if(latch_destroy(&latch1) != OS_NO_ERR ||
+       latch_init(&latch1, 1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to reinit latch1\n");
+    }
+
+    barrier_test_create(latch_waiter, (void*)OS_ERR_NOT_INITIALIZED);
+    sched_sleep(50);
+
+    if(latch_destroy(&latch1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to destroy latch1\n");
+    }
+    barrier_test_join();
+
+    if(released != BARRIER_TEST_THREADS)
+    {
+        kernel_error("Latch destroy released %d threads\n", released);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Latch destroy test passed\n");
+    }
+}
+
+void barrier_test(void)
+{
+    kernel_printf("[TESTMODE] Barrier test start\n");
+
+    barrier_test_rounds();
+    barrier_test_destroy();
+    barrier_test_latch();
+
+    kernel_printf("[TESTMODE] Barrier test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void barrier_test(void)
+{
+
+}
+#endif
\ No newline at end of file
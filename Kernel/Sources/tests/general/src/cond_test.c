@@ -0,0 +1,245 @@
+
+
+#include <test_bank.h>
+
+#if COND_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <mutex.h>
+#include <cond.h>
+
+#define COND_TEST_WAITERS 4
+
+static kernel_thread_t* thread_waiters[COND_TEST_WAITERS];
+
+static mutex_t cond_mutex;
+static cond_t  cond1;
+
+static volatile uint32_t tokens;
+static volatile uint32_t woken;
+static volatile uint32_t destroyed;
+
+void *cond_waiter(void *args);
+void *cond_destroy_waiter(void *args);
+
+void *cond_waiter(void *args)
+{
+    OS_RETURN_E err;
+
+    (void)args;
+
+    if(mutex_lock(&cond_mutex) != OS_NO_ERR)
+    {
+        kernel_error("Failed to lock cond_mutex\n");
+        return NULL;
+    }
+
+    while(tokens == 0)
+    {
+        err = cond_wait(&cond1, &cond_mutex);
+        if(err != OS_NO_ERR)
+        {
+            kernel_error("Failed to wait cond1 %d\n", err);
+            mutex_unlock(&cond_mutex);
+            return NULL;
+        }
+    }
+    --tokens;
+    ++woken;
+
+    if(mutex_unlock(&cond_mutex) != OS_NO_ERR)
+    {
+        kernel_error("Failed to unlock cond_mutex\n");
+    }
+
+    return NULL;
+}
+
+void *cond_destroy_waiter(void *args)
+{
+    (void)args;
+
+    if(mutex_lock(&cond_mutex) != OS_NO_ERR)
+    {
+        kernel_error("Failed to lock cond_mutex\n");
+        return NULL;
+    }
+
+    if(cond_wait(&cond1, &cond_mutex) == OS_ERR_NOT_INITIALIZED)
+    {
+        ++destroyed;
+    }
+
+    if(mutex_unlock(&cond_mutex) != OS_NO_ERR)
+    {
+        kernel_error("Failed to unlock cond_mutex\n");
+    }
+
+    return NULL;
+}
+
+static void cond_test_create_waiters(void* (*routine)(void*))
+{
+    int i;
+
+    for(i = 0; i < COND_TEST_WAITERS; ++i)
+    {
+        if(sched_create_kernel_thread(&thread_waiters[i], 5, "cond_waiter",
+                                      THREAD_TYPE_KERNEL, 0x1000,
+                                      routine, NULL) != OS_NO_ERR)
+        {
+            kernel_error("Error while creating the waiter thread!\n");
+        }
+    }
+
+    /* Let the waiters block on the condition */
+    sched_sleep(50);
+}
+
+static void cond_test_join_waiters(void)
+{
+    int i;
+
+    for(i = 0; i < COND_TEST_WAITERS; ++i)
+    {
+        if(sched_join_thread(thread_waiters[i], NULL, NULL) != OS_NO_ERR)
+        {
+            kernel_error("Error while waiting waiter thread!\n");
+        }
+    }
+}
+
+static void cond_test_signal(const bool_t hold_mutex)
+{
+    tokens = 0;
+    woken  = 0;
+
+    cond_test_create_waiters(cond_waiter);
+
+    if(woken != 0 || cond1.waiters != COND_TEST_WAITERS)
+    {
+        kernel_error("Waiters did not block %d %d\n", woken, cond1.waiters);
+    }
+
+    /* Signal a single waiter */
+    mutex_lock(&cond_mutex);
+    ++tokens;
+    if(cond_signal(&cond1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to signal cond1\n");
+    }
+    mutex_unlock(&cond_mutex);
+    sched_sleep(50);
+
+    if(woken != 1)
+    {
+        kernel_error("Signal woke %d threads\n", woken);
+    }
+
+    /* Broadcast the remaining waiters, with or without holding the mutex */
+    if(hold_mutex == TRUE)
+    {
+        mutex_lock(&cond_mutex);
+        tokens += COND_TEST_WAITERS - 1;
+        if(cond_broadcast(&cond1) != OS_NO_ERR)
+        {
+            kernel_error("Failed to broadcast cond1\n");
+        }
+        mutex_unlock(&cond_mutex);
+    }
+    else
+    {
+        mutex_lock(&cond_mutex);
+        tokens += COND_TEST_WAITERS - 1;
+        mutex_unlock(&cond_mutex);
+        if(cond_broadcast(&cond1) != OS_NO_ERR)
+        {
+            kernel_error("Failed to broadcast cond1\n");
+        }
+    }
+
+    cond_test_join_waiters();
+
+    if(woken != COND_TEST_WAITERS || tokens != 0 || cond1.waiters != 0)
+    {
+        kernel_error("Broadcast woke %d threads\n", woken);
+    }
+    else if(cond_mutex.state != MUTEX_STATE_UNLOCKED)
+    {
+        kernel_error("Wrong mutex state %d\n", cond_mutex.state);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Cond signal test %d passed\n", hold_mutex);
+    }
+}
+
+static void cond_test_destroy(void)
+{
+    destroyed = 0;
+
+    cond_test_create_waiters(cond_destroy_waiter);
+
+    if(cond_destroy(&cond1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to destroy cond1\n");
+    }
+
+    cond_test_join_waiters();
+
+    if(cond_signal(&cond1) != OS_ERR_NOT_INITIALIZED)
+    {
+        kernel_error("Signal on destroyed cond1 did not fail\n");
+    }
+
+    if(destroyed != COND_TEST_WAITERS)
+    {
+        kernel_error("Destroy released %d threads\n", destroyed);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Cond destroy test passed\n");
+    }
+}
+
+void cond_test(void)
+{
+    kernel_printf("[TESTMODE] Cond test start\n");
+
+    if(mutex_init(&cond_mutex, MUTEX_FLAG_NONE,
+                  MUTEX_PRIORITY_ELEVATION_NONE) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init cond_mutex\n");
+    }
+    if(cond_init(&cond1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init cond1\n");
+    }
+
+    /* No waiters */
+    if(cond_signal(&cond1) != OS_NO_ERR || cond_broadcast(&cond1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to signal cond1 without waiters\n");
+    }
+
+    cond_test_signal(FALSE);
+    cond_test_signal(TRUE);
+    cond_test_destroy();
+
+    if(mutex_destroy(&cond_mutex) != OS_NO_ERR)
+    {
+        kernel_error("Failed to destroy cond_mutex\n");
+    }
+
+    kernel_printf("[TESTMODE] Cond test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void cond_test(void)
+{
+
+}
+#endif
\ No newline at end of file
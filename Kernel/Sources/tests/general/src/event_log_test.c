@@ -0,0 +1,117 @@
+
+
+#include <test_bank.h>
+
+#if EVENT_LOG_TEST == 1
+
+#include <kernel_output.h>
+#include <event_log.h>
+#include <cpu_api.h>
+#include <critical.h>
+
+#define EVENT_LOG_TEST_COUNT 256
+
+static void event_log_test_record(void)
+{
+    static const char test_str[] = "test";
+    uint32_t          words[EVENT_LOG_HEADER_SIZE + 8];
+    uint32_t          count;
+    uint32_t          int_state;
+    int32_t           cpu_id;
+
+    /* No other event can be recorded on this CPU in between */
+    ENTER_CRITICAL(int_state);
+
+    cpu_id = cpu_get_id();
+    EVENT_LOG("TEST", "Record %d %llx %s",
+              42, 0x1122334455667788ULL, test_str);
+    count = event_log_get_last(words, EVENT_LOG_HEADER_SIZE + 8);
+
+    EXIT_CRITICAL(int_state);
+
+    if(count != EVENT_LOG_HEADER_SIZE + 4 ||
+       words[1] != (((uint32_t)cpu_id << 16) | 4) ||
+       (words[2] == 0 && words[3] == 0) ||
+       words[4] != 42 ||
+       words[5] != 0x55667788 ||
+       words[6] != 0x11223344 ||
+       words[7] != (uint32_t)(uintptr_t)test_str)
+    {
+        kernel_error("Event log record mismatch %d 0x%x\n", count, words[1]);
+        return;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    EVENT_LOG("TEST", "Record without arguments");
+    count = event_log_get_last(words, EVENT_LOG_HEADER_SIZE + 8);
+
+    EXIT_CRITICAL(int_state);
+
+    if(count != EVENT_LOG_HEADER_SIZE ||
+       words[1] != ((uint32_t)cpu_id << 16))
+    {
+        kernel_error("Event log empty record mismatch %d 0x%x\n",
+                     count, words[1]);
+        return;
+    }
+
+    kernel_printf("[TESTMODE] Event log record passed\n");
+}
+
+void event_log_test(void)
+{
+    uint64_t start;
+    uint64_t cycles;
+    uint32_t dropped;
+    int      i;
+
+    kernel_printf("[TESTMODE] Event log test start\n");
+
+#ifndef KERNEL_EVENT_LOG_ENABLED
+    kernel_error("Event log test requires EVENT_LOG=TRUE\n");
+#endif
+
+    if(EVENT_LOG_ARGS_SIZE(0) != 0 ||
+       EVENT_LOG_ARGS_SIZE(0, (char)1) != 4 ||
+       EVENT_LOG_ARGS_SIZE(0, 1, 2ULL, (void*)0) != 16)
+    {
+        kernel_error("Event log arguments size mismatch\n");
+    }
+
+    dropped = event_log_get_dropped();
+
+    start = cpu_get_timestamp();
+    for(i = 0; i < EVENT_LOG_TEST_COUNT; ++i)
+    {
+        EVENT_LOG("TEST", "Event %d %llu %s", i, start, "test");
+    }
+    cycles = cpu_get_timestamp() - start;
+
+    kernel_log_flush();
+
+    event_log_test_record();
+
+    if(event_log_get_dropped() != dropped)
+    {
+        kernel_error("Event log dropped events\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Event log write passed\n");
+    }
+
+    kernel_printf("Event log cost: %llu cycles per event\n",
+                  cycles / EVENT_LOG_TEST_COUNT);
+
+    kernel_printf("[TESTMODE] Event log test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void event_log_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+
+
+#include <test_bank.h>
+
+#if INTERRUPT_STATS_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <interrupts.h>
+#include <interrupt_settings.h>
+#include <cpu_api.h>
+#include <sys/syscall_api.h>
+
+#define INTERRUPT_STATS_TEST_ROUNDS 100
+
+void interrupt_stats_test(void)
+{
+    interrupt_stats_t stats_begin;
+    interrupt_stats_t stats_end;
+    sched_param_t     params;
+    uint32_t          cpu_id;
+    uint32_t          generation;
+    int32_t           id;
+    int               i;
+
+    kernel_printf("[TESTMODE] Interrupt statistics test start\n");
+
+    id = cpu_get_id();
+    cpu_id = (id < 0 || id >= MAX_CPU_COUNT) ? 0 : (uint32_t)id;
+
+    if(kernel_interrupt_get_stats(MAX_CPU_COUNT, SYSCALL_INT_LINE,
+                                  &stats_begin) != OS_ERR_OUT_OF_BOUND ||
+       kernel_interrupt_get_stats(cpu_id, MAX_INTERRUPT_LINE + 1,
+                                  &stats_begin) !=
+       OR_ERR_UNAUTHORIZED_INTERRUPT_LINE ||
+       kernel_interrupt_get_stats(cpu_id, SYSCALL_INT_LINE, NULL) !=
+       OS_ERR_NULL_POINTER)
+    {
+        kernel_error("Interrupt statistics parameters check failed\n");
+        return;
+    }
+    kernel_printf("[TESTMODE] Interrupt statistics parameters test passed\n");
+
+    if(kernel_interrupt_get_stats(cpu_id, SYSCALL_INT_LINE,
+                                  &stats_begin) != OS_NO_ERR)
+    {
+        kernel_error("Failed to get the interrupt statistics\n");
+        return;
+    }
+
+    for(i = 0; i < INTERRUPT_STATS_TEST_ROUNDS; ++i)
+    {
+        cpu_syscall(SYSCALL_SCHED_GET_PARAMS, &params);
+    }
+
+    if(kernel_interrupt_get_stats(cpu_id, SYSCALL_INT_LINE,
+                                  &stats_end) != OS_NO_ERR)
+    {
+        kernel_error("Failed to get the interrupt statistics\n");
+        return;
+    }
+
+    if(stats_end.count - stats_begin.count < INTERRUPT_STATS_TEST_ROUNDS ||
+       stats_end.handler_count - stats_begin.handler_count <
+       INTERRUPT_STATS_TEST_ROUNDS ||
+       stats_end.handler_cycles <= stats_begin.handler_cycles ||
+       stats_end.handler_max_cycles == 0 ||
+       stats_end.handler_max_cycles <
+       stats_end.handler_cycles / stats_end.handler_count)
+    {
+        kernel_error("Interrupt statistics count mismatch\n");
+        return;
+    }
+    kernel_printf("[TESTMODE] Interrupt statistics count test passed\n");
+
+    kernel_interrupt_dump_stats();
+
+    generation = kernel_interrupt_get_stats_generation();
+    kernel_interrupt_reset_stats();
+    if(kernel_interrupt_get_stats(cpu_id, SYSCALL_INT_LINE,
+                                  &stats_end) != OS_NO_ERR ||
+       kernel_interrupt_get_stats_generation() != generation + 1 ||
+       stats_end.count != 0 ||
+       stats_end.handler_max_cycles != 0 ||
+       kernel_interrupt_get_spurious_count() != 0)
+    {
+        kernel_error("Interrupt statistics reset failed\n");
+        return;
+    }
+    kernel_printf("[TESTMODE] Interrupt statistics reset test passed\n");
+
+    kernel_printf("[TESTMODE] Interrupt statistics test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void interrupt_stats_test(void)
+{
+
+}
+#endif
\ No newline at end of file
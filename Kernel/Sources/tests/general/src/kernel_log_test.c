@@ -0,0 +1,83 @@
+
+
+#include <test_bank.h>
+
+#if KERNEL_LOG_TEST == 1
+
+#include <kernel_output.h>
+#include <critical.h>
+#include <cpu_api.h>
+#include <string.h>
+
+#define KERNEL_LOG_TEST_BURST 1024
+#define KERNEL_LOG_TEST_LONG  600
+
+static char long_message[KERNEL_LOG_TEST_LONG + 1];
+
+void kernel_log_test(void)
+{
+    uint64_t start;
+    uint64_t cycles;
+    uint32_t dropped;
+    uint32_t int_state;
+    int      i;
+
+    kernel_printf("[TESTMODE] Kernel log test start\n");
+
+    dropped = kernel_log_get_dropped();
+
+    /* Messages logged with interrupts disabled never wait for the output */
+    ENTER_CRITICAL(int_state);
+    start = cpu_get_timestamp();
+    for(i = 0; i < 64; ++i)
+    {
+        kernel_printf("Log burst %d\n", i);
+    }
+    cycles = cpu_get_timestamp() - start;
+    EXIT_CRITICAL(int_state);
+
+    if(kernel_log_get_dropped() != dropped)
+    {
+        kernel_error("Kernel log dropped messages in critical section\n");
+    }
+    kernel_printf("Log cost: %llu cycles per message\n", cycles / 64);
+
+    /* The burst is bigger than the ring, the thread drains it itself */
+    for(i = 0; i < KERNEL_LOG_TEST_BURST; ++i)
+    {
+        kernel_printf("Log burst %d\n", i);
+    }
+    if(kernel_log_get_dropped() != dropped)
+    {
+        kernel_error("Kernel log dropped messages in burst\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Kernel log burst passed\n");
+    }
+
+    /* Messages longer than a record are split */
+    memset(long_message, 'L', KERNEL_LOG_TEST_LONG);
+    long_message[KERNEL_LOG_TEST_LONG] = 0;
+    kernel_info("%s\n", long_message);
+    kernel_log_flush();
+    if(kernel_log_get_dropped() != dropped)
+    {
+        kernel_error("Kernel log dropped long message\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Kernel log long message passed\n");
+    }
+
+    kernel_printf("[TESTMODE] Kernel log test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void kernel_log_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+
+
+#include <test_bank.h>
+
+#if PROFILER_TEST == 1
+
+#include <kernel_output.h>
+#include <time_management.h>
+#include <profiler.h>
+
+#define PROFILER_TEST_FREQ 1000
+
+static volatile uint32_t profiler_test_sink;
+
+static void profiler_test_spin(const uint64_t duration_ns)
+{
+    uint64_t end;
+
+    end = time_get_current_uptime() + duration_ns;
+    while(time_get_current_uptime() < end)
+    {
+        ++profiler_test_sink;
+    }
+}
+
+void profiler_test(void)
+{
+    uint64_t count;
+
+    kernel_printf("[TESTMODE] Profiler test start\n");
+
+    if(profiler_stop() != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("Stopped a stopped profiler\n");
+        return;
+    }
+
+    /* Sample on the main timer */
+    if(profiler_start(0, TRUE) != OS_NO_ERR)
+    {
+        kernel_error("Could not start the profiler\n");
+        return;
+    }
+    if(profiler_start(0, TRUE) != OS_ERR_UNAUTHORIZED_ACTION ||
+       profiler_dump() != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("Profiler state check failed\n");
+        profiler_stop();
+        return;
+    }
+
+    profiler_test_spin(200000000ULL);
+
+    if(profiler_stop() != OS_NO_ERR)
+    {
+        kernel_error("Could not stop the profiler\n");
+        return;
+    }
+    count = profiler_get_sample_count();
+    if(count == 0 || profiler_dump() != OS_NO_ERR)
+    {
+        kernel_error("Main timer profile failed %llu\n", count);
+        return;
+    }
+    kernel_printf("[TESTMODE] Profiler main timer test passed\n");
+
+    /* Sample on the dedicated timer */
+    if(profiler_start(PROFILER_TEST_FREQ, TRUE) != OS_NO_ERR)
+    {
+        kernel_error("Could not start the profiler\n");
+        return;
+    }
+
+    profiler_test_spin(100000000ULL);
+
+    if(profiler_stop() != OS_NO_ERR)
+    {
+        kernel_error("Could not stop the profiler\n");
+        return;
+    }
+    count = profiler_get_sample_count();
+    if(count < PROFILER_TEST_FREQ / 20 || profiler_dump() != OS_NO_ERR)
+    {
+        kernel_error("Sampling timer profile failed %llu\n", count);
+        return;
+    }
+    kernel_printf("[TESTMODE] Profiler sampling timer test passed\n");
+
+    kernel_printf("[TESTMODE] Profiler test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void profiler_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,380 @@
+
+
+#include <test_bank.h>
+
+#if RWLOCK_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <rwlock.h>
+#include <atomic.h>
+
+#define RWLOCK_TEST_WRITERS 2
+#define RWLOCK_TEST_READERS 3
+#define RWLOCK_TEST_LOOPS   3
+
+static kernel_thread_t* thread_writers[RWLOCK_TEST_WRITERS];
+static kernel_thread_t* thread_readers[RWLOCK_TEST_READERS];
+static kernel_thread_t* thread_pref;
+
+static rwlock_t rwlock1;
+static rwlock_t rwlock2;
+
+static volatile uint32_t shared_value;
+static volatile uint32_t odd_seen;
+static volatile uint32_t reader_max;
+static volatile int32_t  readers_in;
+static volatile uint32_t pref_res;
+
+void *rwlock_writer(void *args);
+void *rwlock_reader(void *args);
+void *rwlock_pref_writer(void *args);
+void *rwlock_destroy_waiter(void *args);
+
+void *rwlock_writer(void *args)
+{
+    uint32_t value;
+
+    (void)args;
+
+    for(int i = 0; i < RWLOCK_TEST_LOOPS; ++i)
+    {
+        if(rwlock_write_lock(&rwlock1) != OS_NO_ERR)
+        {
+            kernel_error("Failed to write lock rwlock1\n");
+            return NULL;
+        }
+
+        /* Non atomic update with a sleep to expose readers */
+        value = shared_value;
+        shared_value = value + 1;
+        sched_sleep(20);
+        shared_value = value + 2;
+
+        if(rwlock_write_unlock(&rwlock1) != OS_NO_ERR)
+        {
+            kernel_error("Failed to write unlock rwlock1\n");
+            return NULL;
+        }
+        sched_sleep(10);
+    }
+
+    return NULL;
+}
+
+void *rwlock_reader(void *args)
+{
+    int32_t in;
+
+    (void)args;
+
+    for(int i = 0; i < RWLOCK_TEST_LOOPS; ++i)
+    {
+        if(rwlock_read_lock(&rwlock1) != OS_NO_ERR)
+        {
+            kernel_error("Failed to read lock rwlock1\n");
+            return NULL;
+        }
+
+        in = ATOMIC_FETCH_ADD(&readers_in, 1) + 1;
+        if((uint32_t)in > reader_max)
+        {
+            reader_max = in;
+        }
+        if((shared_value & 1) != 0)
+        {
+            ++odd_seen;
+        }
+        sched_sleep(15);
+        if((shared_value & 1) != 0)
+        {
+            ++odd_seen;
+        }
+        ATOMIC_FETCH_ADD(&readers_in, -1);
+
+        if(rwlock_read_unlock(&rwlock1) != OS_NO_ERR)
+        {
+            kernel_error("Failed to read unlock rwlock1\n");
+            return NULL;
+        }
+        sched_sleep(5);
+    }
+
+    return NULL;
+}
+
+void *rwlock_pref_writer(void *args)
+{
+    (void)args;
+
+    if(rwlock_write_lock(&rwlock2) != OS_NO_ERR)
+    {
+        kernel_error("Failed to write lock rwlock2\n");
+        return NULL;
+    }
+    ++pref_res;
+    if(rwlock_write_unlock(&rwlock2) != OS_NO_ERR)
+    {
+        kernel_error("Failed to write unlock rwlock2\n");
+        return NULL;
+    }
+
+    return NULL;
+}
+
+void *rwlock_destroy_waiter(void *args)
+{
+    (void)args;
+
+    if(rwlock_read_lock(&rwlock2) != OS_ERR_NOT_INITIALIZED)
+    {
+        kernel_error("Read lock on destroyed rwlock2 did not fail\n");
+        return NULL;
+    }
+    ++pref_res;
+
+    return NULL;
+}
+
+static void rwlock_test_basic(void)
+{
+    if(rwlock_init(&rwlock1, RWLOCK_FLAG_NONE) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init rwlock1\n");
+    }
+
+    if(rwlock_read_lock(&rwlock1) != OS_NO_ERR ||
+       rwlock_read_lock(&rwlock1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to read lock rwlock1\n");
+    }
+    if(rwlock_try_write_lock(&rwlock1) != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("Write lock acquired while readers hold rwlock1\n");
+    }
+    if(rwlock_write_unlock(&rwlock1) != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("Write unlock succeeded on read locked rwlock1\n");
+    }
+    if(rwlock_read_unlock(&rwlock1) != OS_NO_ERR ||
+       rwlock_read_unlock(&rwlock1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to read unlock rwlock1\n");
+    }
+    if(rwlock_read_unlock(&rwlock1) != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("Read unlock succeeded on unlocked rwlock1\n");
+    }
+    if(rwlock_try_write_lock(&rwlock1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to try write lock rwlock1\n");
+    }
+    if(rwlock_try_read_lock(&rwlock1) != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("Read lock acquired while writer holds rwlock1\n");
+    }
+    if(rwlock_write_unlock(&rwlock1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to write unlock rwlock1\n");
+    }
+    if(rwlock1.state != 0)
+    {
+        kernel_error("Wrong rwlock1 state %d\n", rwlock1.state);
+    }
+
+    kernel_printf("[TESTMODE] RWLock basic test passed\n");
+}
+
+static void rwlock_test_concurrent(void)
+{
+    int i;
+
+    shared_value = 0;
+    odd_seen     = 0;
+    reader_max   = 0;
+    readers_in   = 0;
+
+    for(i = 0; i < RWLOCK_TEST_WRITERS; ++i)
+    {
+        if(sched_create_kernel_thread(&thread_writers[i], 5, "rw_writer",
+                                      THREAD_TYPE_KERNEL, 0x1000,
+                                      rwlock_writer, NULL) != OS_NO_ERR)
+        {
+            kernel_error("Error while creating the writer thread!\n");
+        }
+    }
+    for(i = 0; i < RWLOCK_TEST_READERS; ++i)
+    {
+        if(sched_create_kernel_thread(&thread_readers[i], 5, "rw_reader",
+                                      THREAD_TYPE_KERNEL, 0x1000,
+                                      rwlock_reader, NULL) != OS_NO_ERR)
+        {
+            kernel_error("Error while creating the reader thread!\n");
+        }
+    }
+
+    for(i = 0; i < RWLOCK_TEST_WRITERS; ++i)
+    {
+        if(sched_join_thread(thread_writers[i], NULL, NULL) != OS_NO_ERR)
+        {
+            kernel_error("Error while waiting writer thread!\n");
+        }
+    }
+    for(i = 0; i < RWLOCK_TEST_READERS; ++i)
+    {
+        if(sched_join_thread(thread_readers[i], NULL, NULL) != OS_NO_ERR)
+        {
+            kernel_error("Error while waiting reader thread!\n");
+        }
+    }
+
+    if(shared_value != RWLOCK_TEST_WRITERS * RWLOCK_TEST_LOOPS * 2 ||
+       odd_seen != 0)
+    {
+        kernel_error("RWLock concurrent test failed %d %d\n",
+                     shared_value, odd_seen);
+    }
+    else if(reader_max < 2)
+    {
+        kernel_error("RWLock readers did not share the lock\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] RWLock concurrent test passed\n");
+    }
+
+    if(rwlock_destroy(&rwlock1) != OS_NO_ERR)
+    {
+        kernel_error("Failed to destroy rwlock1\n");
+    }
+}
+
+static void rwlock_test_preference(const uint32_t flags,
+                                   const OS_RETURN_E expected)
+{
+    OS_RETURN_E err;
+
+    pref_res = 0;
+
+    if(rwlock_init(&rwlock2, flags) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init rwlock2\n");
+    }
+    if(rwlock_read_lock(&rwlock2) != OS_NO_ERR)
+    {
+        kernel_error("Failed to read lock rwlock2\n");
+    }
+
+    /* Let the writer block on the lock */
+    if(sched_create_kernel_thread(&thread_pref, 5, "rw_pref",
+                                  THREAD_TYPE_KERNEL, 0x1000,
+                                  rwlock_pref_writer, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while creating the writer thread!\n");
+    }
+    sched_sleep(50);
+
+    err = rwlock_try_read_lock(&rwlock2);
+    if(err != expected)
+    {
+        kernel_error("Wrong try read lock result %d\n", err);
+    }
+    if(err == OS_NO_ERR && rwlock_read_unlock(&rwlock2) != OS_NO_ERR)
+    {
+        kernel_error("Failed to read unlock rwlock2\n");
+    }
+    if(pref_res != 0)
+    {
+        kernel_error("Writer acquired read locked rwlock2\n");
+    }
+
+    if(rwlock_read_unlock(&rwlock2) != OS_NO_ERR)
+    {
+        kernel_error("Failed to read unlock rwlock2\n");
+    }
+    if(sched_join_thread(thread_pref, NULL, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while waiting writer thread!\n");
+    }
+
+    if(pref_res != 1)
+    {
+        kernel_error("Writer did not acquire rwlock2\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] RWLock preference %d test passed\n", flags);
+    }
+
+    if(rwlock_destroy(&rwlock2) != OS_NO_ERR)
+    {
+        kernel_error("Failed to destroy rwlock2\n");
+    }
+}
+
+static void rwlock_test_destroy(void)
+{
+    pref_res = 0;
+
+    if(rwlock_init(&rwlock2, RWLOCK_FLAG_NONE) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init rwlock2\n");
+    }
+    if(rwlock_write_lock(&rwlock2) != OS_NO_ERR)
+    {
+        kernel_error("Failed to write lock rwlock2\n");
+    }
+
+    if(sched_create_kernel_thread(&thread_pref, 5, "rw_destroy",
+                                  THREAD_TYPE_KERNEL, 0x1000,
+                                  rwlock_destroy_waiter, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while creating the waiter thread!\n");
+    }
+    sched_sleep(50);
+
+    if(rwlock_destroy(&rwlock2) != OS_NO_ERR)
+    {
+        kernel_error("Failed to destroy rwlock2\n");
+    }
+    if(sched_join_thread(thread_pref, NULL, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while waiting waiter thread!\n");
+    }
+    if(rwlock_read_lock(&rwlock2) != OS_ERR_NOT_INITIALIZED)
+    {
+        kernel_error("Read lock on destroyed rwlock2 did not fail\n");
+    }
+
+    if(pref_res != 1)
+    {
+        kernel_error("Waiter was not released by destroy\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] RWLock destroy test passed\n");
+    }
+}
+
+void rwlock_test(void)
+{
+    kernel_printf("[TESTMODE] RWLock test start\n");
+
+    rwlock_test_basic();
+    rwlock_test_concurrent();
+    rwlock_test_preference(RWLOCK_FLAG_NONE, OS_NO_ERR);
+    rwlock_test_preference(RWLOCK_FLAG_WRITER_PREFERENCE,
+                           OS_ERR_UNAUTHORIZED_ACTION);
+    rwlock_test_destroy();
+
+    kernel_printf("[TESTMODE] RWLock test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void rwlock_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include <test_bank.h>
+
+#if SCHED_STATS_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <sys/syscall_api.h>
+
+static volatile uint32_t peer_stop;
+
+void *stats_peer(void *args);
+
+void *stats_peer(void *args)
+{
+    (void)args;
+
+    while(peer_stop == 0)
+    {
+        sched_schedule();
+    }
+
+    return NULL;
+}
+
+static OS_RETURN_E stats_get(const int32_t tid, sched_stats_param_t* params)
+{
+    params->tid      = tid;
+    params->priority = KERNEL_HIGHEST_PRIORITY;
+    syscall_do(SYSCALL_SCHED_GET_STATS, params);
+
+    return params->error;
+}
+
+static uint32_t stats_latency_count(const sched_stats_param_t* params)
+{
+    uint32_t i;
+    uint32_t count;
+
+    count = 0;
+    for(i = 0; i < SCHED_LATENCY_BUCKETS; ++i)
+    {
+        count += params->latency[i];
+    }
+
+    return count;
+}
+
+void sched_stats_test(void)
+{
+    sched_stats_param_t before;
+    sched_stats_param_t after;
+    sched_stats_param_t peer_stats;
+    sched_param_t       sched_params;
+    kernel_thread_t*    peer;
+    uint32_t            i;
+
+    kernel_printf("[TESTMODE] Scheduler statistics tests starts\n");
+
+    /* Parameters checks */
+    before.tid      = -1;
+    before.priority = KERNEL_LOWEST_PRIORITY + 1;
+    syscall_do(SYSCALL_SCHED_GET_STATS, &before);
+    if(before.error != OS_ERR_FORBIDEN_PRIORITY)
+    {
+        kernel_error("Scheduler statistics priority check failed %d\n",
+                     before.error);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Scheduler statistics priority check "
+                      "passed\n");
+    }
+
+    if(stats_get(0x7FFFFFFF, &before) != OS_ERR_NO_SUCH_ID)
+    {
+        kernel_error("Scheduler statistics TID check failed %d\n",
+                     before.error);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Scheduler statistics TID check passed\n");
+    }
+
+    /* Sleeping switches voluntarily and is accounted as a wake up */
+    stats_get(-1, &before);
+    for(i = 0; i < 5; ++i)
+    {
+        sched_sleep(10);
+    }
+    stats_get(-1, &after);
+    if(after.error != OS_NO_ERR ||
+       after.thread_stats.voluntary_switches <
+       before.thread_stats.voluntary_switches + 5 ||
+       stats_latency_count(&after) < stats_latency_count(&before) + 5)
+    {
+        kernel_error("Scheduler statistics sleep test failed %d %d\n",
+                     after.thread_stats.voluntary_switches -
+                     before.thread_stats.voluntary_switches,
+                     stats_latency_count(&after) -
+                     stats_latency_count(&before));
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Scheduler statistics sleep test passed\n");
+    }
+
+    /* System calls are accounted as kernel time */
+    stats_get(-1, &before);
+    for(i = 0; i < 1000; ++i)
+    {
+        syscall_do(SYSCALL_SCHED_GET_PARAMS, &sched_params);
+    }
+    stats_get(-1, &after);
+    if(after.thread_stats.kernel_time <= before.thread_stats.kernel_time ||
+       after.thread_stats.user_time <= before.thread_stats.user_time)
+    {
+        kernel_error("Scheduler statistics time test failed\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Scheduler statistics time test passed\n");
+    }
+
+    /* Yielding to a thread of the same priority is voluntary */
+    peer_stop = 0;
+    if(sched_create_kernel_thread(&peer, KERNEL_HIGHEST_PRIORITY,
+                                  "stats_peer", THREAD_TYPE_KERNEL, 0x1000,
+                                  stats_peer, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while creating the peer thread!\n");
+        return;
+    }
+
+    stats_get(-1, &before);
+    for(i = 0; i < 5; ++i)
+    {
+        sched_schedule();
+    }
+    stats_get(-1, &after);
+
+    if(stats_get(peer->tid, &peer_stats) != OS_NO_ERR ||
+       after.thread_stats.voluntary_switches <
+       before.thread_stats.voluntary_switches + 5 ||
+       after.thread_stats.wait_time <= before.thread_stats.wait_time ||
+       peer_stats.thread_stats.voluntary_switches == 0 ||
+       peer_stats.thread_stats.wait_time == 0)
+    {
+        kernel_error("Scheduler statistics yield test failed %d %d\n",
+                     after.thread_stats.voluntary_switches -
+                     before.thread_stats.voluntary_switches,
+                     peer_stats.error);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Scheduler statistics yield test passed\n");
+    }
+
+    peer_stop = 1;
+    if(sched_join_thread(peer, NULL, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while waiting the peer thread!\n");
+    }
+
+    kernel_printf("[TESTMODE] Scheduler statistics tests passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void sched_stats_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include <test_bank.h>
+
+#if SCHEDULER_WAKEUP_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <futex.h>
+#include <sys/syscall_api.h>
+
+static volatile uint32_t wake_word;
+static volatile uint32_t waker_progress;
+static volatile uint32_t seen_progress;
+
+void *wakeup_waiter(void *args);
+void *wakeup_waker(void *args);
+void *wakeup_recorder(void *args);
+void *wakeup_creator(void *args);
+
+void *wakeup_waiter(void *args)
+{
+    futex_t futex;
+
+    (void)args;
+
+    futex.addr = (uint32_t*)&wake_word;
+    futex.val  = 0;
+    syscall_do(SYSCALL_FUTEX_WAIT, &futex);
+    if(futex.error != OS_NO_ERR)
+    {
+        kernel_error("Failed to wait futex %d\n", futex.error);
+    }
+
+    /* Record how far the waker went before we got the CPU */
+    seen_progress = waker_progress;
+
+    return NULL;
+}
+
+void *wakeup_waker(void *args)
+{
+    futex_t futex;
+
+    (void)args;
+
+    /* Let the waiter block whatever its priority */
+    sched_sleep(20);
+
+    wake_word = 1;
+
+    futex.addr = (uint32_t*)&wake_word;
+    futex.val  = 1;
+    syscall_do(SYSCALL_FUTEX_WAKE, &futex);
+    if(futex.error != OS_NO_ERR)
+    {
+        kernel_error("Failed to wake futex %d\n", futex.error);
+    }
+
+    waker_progress = 1;
+
+    return NULL;
+}
+
+void *wakeup_recorder(void *args)
+{
+    (void)args;
+
+    seen_progress = waker_progress;
+
+    return NULL;
+}
+
+void *wakeup_creator(void *args)
+{
+    kernel_thread_t* thread;
+    sched_param_t    params;
+
+    (void)args;
+
+    if(sched_create_kernel_thread(&thread, 2, "wake_created",
+                                  THREAD_TYPE_KERNEL, 0x1000,
+                                  wakeup_recorder, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while creating the created thread!\n");
+        return NULL;
+    }
+
+    /* The created thread must run at the latest on this system call exit */
+    syscall_do(SYSCALL_SCHED_GET_PARAMS, &params);
+
+    waker_progress = 1;
+
+    if(sched_join_thread(thread, NULL, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while waiting created thread!\n");
+    }
+
+    return NULL;
+}
+
+static void wakeup_test_run(const uint32_t waiter_prio,
+                            const uint32_t waker_prio,
+                            const uint32_t expected)
+{
+    kernel_thread_t* waiter;
+    kernel_thread_t* waker;
+
+    wake_word      = 0;
+    waker_progress = 0;
+    seen_progress  = 2;
+
+    if(sched_create_kernel_thread(&waiter, waiter_prio, "wake_waiter",
+                                  THREAD_TYPE_KERNEL, 0x1000,
+                                  wakeup_waiter, NULL) != OS_NO_ERR ||
+       sched_create_kernel_thread(&waker, waker_prio, "wake_waker",
+                                  THREAD_TYPE_KERNEL, 0x1000,
+                                  wakeup_waker, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while creating the wakeup threads!\n");
+        return;
+    }
+
+    sched_join_thread(waiter, NULL, NULL);
+    sched_join_thread(waker, NULL, NULL);
+
+    if(seen_progress != expected)
+    {
+        kernel_error("Wakeup test %d/%d failed %d\n",
+                     waiter_prio, waker_prio, seen_progress);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Wakeup test %d/%d passed\n",
+                      waiter_prio, waker_prio);
+    }
+}
+
+void scheduler_wakeup_test(void)
+{
+    kernel_thread_t* creator;
+
+    kernel_printf("[TESTMODE] Scheduler wakeup tests starts\n");
+
+    /* The woken thread outranks the waker, it runs before the waker resumes */
+    wakeup_test_run(2, 4, 0);
+
+    /* The woken thread has a lower priority, the waker keeps running */
+    wakeup_test_run(5, 4, 1);
+
+    /* A higher priority thread created by a running thread */
+    waker_progress = 0;
+    seen_progress  = 2;
+    if(sched_create_kernel_thread(&creator, 4, "wake_creator",
+                                  THREAD_TYPE_KERNEL, 0x1000,
+                                  wakeup_creator, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while creating the creator thread!\n");
+    }
+    sched_join_thread(creator, NULL, NULL);
+    if(seen_progress != 0)
+    {
+        kernel_error("Wakeup creation test failed %d\n", seen_progress);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Wakeup creation test passed\n");
+    }
+
+    kernel_printf("[TESTMODE] Scheduler wakeup tests passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void scheduler_wakeup_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,229 @@
+
+
+#include <test_bank.h>
+
+#if SOFTIRQ_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <softirq.h>
+#include <interrupts.h>
+#include <critical.h>
+#include <cpu_api.h>
+#include <sys/syscall_api.h>
+
+#define SOFTIRQ_TEST_IRQ 5
+
+static tasklet_t tasklet_a;
+static tasklet_t tasklet_b;
+static tasklet_t tasklet_c;
+
+static volatile char     tasklet_order[8];
+static volatile uint32_t tasklet_count;
+static volatile uint32_t tasklet_int_off;
+static volatile uint32_t irq_thread_count;
+static volatile uint32_t tasklet_running;
+static volatile uint32_t tasklet_overlap;
+static volatile uint32_t tasklet_runs;
+
+static void softirq_test_tasklet(void* args)
+{
+    if(cpu_get_interrupt_state() == 0)
+    {
+        ++tasklet_int_off;
+    }
+    if(tasklet_count < sizeof(tasklet_order))
+    {
+        tasklet_order[tasklet_count] = (char)(uintptr_t)args;
+    }
+    ++tasklet_count;
+}
+
+static void softirq_test_self_tasklet(void* args)
+{
+    (void)args;
+
+    if(++tasklet_running != 1)
+    {
+        ++tasklet_overlap;
+    }
+
+    /* Schedule again and let the other threads execute the tasklets */
+    if(++tasklet_runs == 1)
+    {
+        tasklet_schedule(&tasklet_c);
+        sched_sleep(10);
+    }
+
+    --tasklet_running;
+}
+
+static void softirq_test_irq_routine(void* args)
+{
+    (void)args;
+
+    ++irq_thread_count;
+}
+
+static void softirq_test_tasklets(void)
+{
+    sched_param_t params;
+    uint32_t      int_state;
+    tasklet_t     tasklet;
+
+    tasklet_count   = 0;
+    tasklet_int_off = 0;
+
+    tasklet.routine = NULL;
+    if(tasklet_init(NULL, softirq_test_tasklet, NULL) != OS_ERR_NULL_POINTER ||
+       tasklet_init(&tasklet_a, NULL, NULL) != OS_ERR_NULL_POINTER ||
+       tasklet_schedule(NULL) != OS_ERR_NULL_POINTER ||
+       tasklet_schedule(&tasklet) != OS_ERR_NOT_INITIALIZED)
+    {
+        kernel_error("Tasklet parameters check failed\n");
+    }
+
+    if(tasklet_init(&tasklet_a, softirq_test_tasklet, (void*)'A') !=
+       OS_NO_ERR ||
+       tasklet_init(&tasklet_b, softirq_test_tasklet, (void*)'B') !=
+       OS_NO_ERR)
+    {
+        kernel_error("Failed to init tasklets\n");
+    }
+
+    /* Scheduling twice a pending tasklet executes it once */
+    ENTER_CRITICAL(int_state);
+    tasklet_schedule(&tasklet_a);
+    tasklet_schedule(&tasklet_b);
+    tasklet_schedule(&tasklet_a);
+    if(tasklet_count != 0 || softirq_pending() == FALSE)
+    {
+        kernel_error("Tasklet executed in critical section\n");
+    }
+    EXIT_CRITICAL(int_state);
+
+    /* The tasklets are executed at the latest on this system call exit */
+    cpu_syscall(SYSCALL_SCHED_GET_PARAMS, &params);
+
+    if(tasklet_count != 2 || tasklet_order[0] != 'A' ||
+       tasklet_order[1] != 'B' || tasklet_int_off != 0 ||
+       softirq_pending() == TRUE)
+    {
+        kernel_error("Tasklet execution failed %d %d\n",
+                     tasklet_count, tasklet_int_off);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Tasklet test passed\n");
+    }
+}
+
+static void softirq_test_running(void)
+{
+    sched_param_t params;
+
+    tasklet_running = 0;
+    tasklet_overlap = 0;
+    tasklet_runs    = 0;
+
+    if(tasklet_init(&tasklet_c, softirq_test_self_tasklet, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init tasklet\n");
+        return;
+    }
+
+    /* A tasklet scheduled while running is executed once it returned */
+    tasklet_schedule(&tasklet_c);
+    cpu_syscall(SYSCALL_SCHED_GET_PARAMS, &params);
+    sched_sleep(20);
+
+    if(tasklet_runs != 2 || tasklet_overlap != 0 ||
+       softirq_pending() == TRUE)
+    {
+        kernel_error("Running tasklet execution failed %d %d\n",
+                     tasklet_runs, tasklet_overlap);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Running tasklet test passed\n");
+    }
+}
+
+static void softirq_test_irq_thread(void)
+{
+    int32_t int_line;
+
+    irq_thread_count = 0;
+
+    int_line = kernel_interrupt_get_irq_int_line(SOFTIRQ_TEST_IRQ);
+    if(int_line < 0)
+    {
+        kernel_error("Failed to get the test IRQ line\n");
+        return;
+    }
+
+    if(softirq_register_irq_thread(SOFTIRQ_TEST_IRQ, 1, NULL, NULL) !=
+       OS_ERR_NULL_POINTER)
+    {
+        kernel_error("IRQ thread parameters check failed\n");
+    }
+
+    if(softirq_register_irq_thread(SOFTIRQ_TEST_IRQ, 1,
+                                   softirq_test_irq_routine,
+                                   NULL) != OS_NO_ERR)
+    {
+        kernel_error("Failed to register IRQ thread\n");
+        return;
+    }
+    if(softirq_register_irq_thread(SOFTIRQ_TEST_IRQ, 1,
+                                   softirq_test_irq_routine,
+                                   NULL) != OS_ERR_INTERRUPT_ALREADY_REGISTERED)
+    {
+        kernel_error("IRQ thread registered twice\n");
+    }
+
+    /* The thread has a lower priority, the interrupts are coalesced */
+    cpu_raise_interrupt(int_line);
+    cpu_raise_interrupt(int_line);
+    cpu_raise_interrupt(int_line);
+    if(irq_thread_count != 0)
+    {
+        kernel_error("IRQ thread preempted the test\n");
+    }
+    sched_sleep(20);
+    if(irq_thread_count != 1)
+    {
+        kernel_error("IRQ thread coalescing failed %d\n", irq_thread_count);
+    }
+
+    cpu_raise_interrupt(int_line);
+    sched_sleep(20);
+    if(irq_thread_count != 2)
+    {
+        kernel_error("IRQ thread wake up failed %d\n", irq_thread_count);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] IRQ thread test passed\n");
+    }
+}
+
+void softirq_test(void)
+{
+    kernel_printf("[TESTMODE] Softirq test start\n");
+
+    softirq_test_tasklets();
+    softirq_test_running();
+    softirq_test_irq_thread();
+
+    kernel_printf("[TESTMODE] Softirq test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void softirq_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 #if SPINLOCK_TEST == 1
 
 #include <atomic.h>
+#include <mcs_lock.h>
 #include <kernel_output.h>
 #include <scheduler.h>
 #include <interrupts.h>
@@ -13,10 +14,12 @@ static kernel_thread_t* thread_mutex1;
 static kernel_thread_t* thread_mutex2;
 
 static spinlock_t lock = SPINLOCK_INIT_VALUE;
+static mcs_lock_t mcs = MCS_LOCK_INIT_VALUE;
 
 static volatile uint32_t lock_res;
 
 void* spin_thread_1(void *args);
+void* mcs_thread_1(void *args);
 
 void* spin_thread_1(void *args)
 {
@@ -36,9 +39,32 @@ void* spin_thread_1(void *args)
     return NULL;
 }
 
+void* mcs_thread_1(void *args)
+{
+    mcs_node_t node;
+
+    for(int i = 0; i < 2000000; ++i)
+    {
+        mcs_lock(&mcs, &node);
+
+        uint32_t tmp = lock_res;
+        for(volatile uint32_t k = 0; k < 200; ++k);
+
+        lock_res = tmp + 1;
+
+        mcs_unlock(&mcs, &node);
+    }
+
+    (void )args;
+    return NULL;
+}
+
 void spinlock_test(void)
 {
     OS_RETURN_E err;
+    uint32_t    acquired;
+    uint32_t    int_state;
+    mcs_node_t  node;
 
     lock_res = 0;
 
@@ -63,11 +89,58 @@ void spinlock_test(void)
     }
 
     kernel_printf("[TESTMODE]Lock res = %u\n", lock_res);
-    if(lock_res == 4000000)
+    if(lock_res == 4000000 && lock.acquisitions == 4000000)
     {
         kernel_printf("[TESTMODE] Spinlock test passed.\n");
     }
 
+    /* Try lock */
+    SPINLOCK_TRYLOCK(lock, acquired);
+    if(acquired == 0)
+    {
+        kernel_error("Failed to try lock the spinlock\n");
+    }
+    SPINLOCK_TRYLOCK(lock, acquired);
+    if(acquired != 0)
+    {
+        kernel_error("Try locked a locked spinlock\n");
+    }
+    SPINLOCK_UNLOCK(lock);
+
+    /* MCS lock */
+    lock_res = 0;
+    if(mcs_trylock(&mcs, &node) != TRUE)
+    {
+        kernel_error("Failed to try lock the MCS lock\n");
+    }
+    mcs_unlock(&mcs, &node);
+    int_state = mcs_lock_irqsave(&mcs, &node);
+    mcs_unlock_irqrestore(&mcs, &node, int_state);
+
+    if(sched_create_kernel_thread(&thread_mutex1, 1, "thread1", THREAD_TYPE_KERNEL, 0x1000, mcs_thread_1, NULL) != OS_NO_ERR)
+    {
+        kernel_error(" Error while creating the main 1 thread!\n");
+    }
+    if(sched_create_kernel_thread(&thread_mutex2, 1, "thread1", THREAD_TYPE_KERNEL, 0x1000, mcs_thread_1, NULL) != OS_NO_ERR)
+    {
+        kernel_error(" Error while creating the main 2 thread!\n");
+    }
+
+    if((err = sched_join_thread(thread_mutex1, NULL, NULL)) != OS_NO_ERR)
+    {
+        kernel_error("Error while waiting thread! [%d]\n", err);
+    }
+    if(sched_join_thread(thread_mutex2, NULL, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while waiting thread! [%d]\n", err);
+    }
+
+    kernel_printf("[TESTMODE]MCS lock res = %u\n", lock_res);
+    if(lock_res == 4000000 && mcs.acquisitions == 4000002 && mcs.tail == NULL)
+    {
+        kernel_printf("[TESTMODE] MCS lock test passed.\n");
+    }
+
     /* Kill QEMU */
     kill_qemu();
 }
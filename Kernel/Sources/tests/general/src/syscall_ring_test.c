@@ -0,0 +1,242 @@
+
+
+#include <test_bank.h>
+
+#if SYSCALL_RING_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <futex.h>
+#include <sys/syscall_api.h>
+
+static syscall_ring_t   ring_worker;
+static syscall_ring_t   ring_waiter;
+static volatile uint32_t ring_word;
+static volatile uint32_t ring_waiter_done;
+
+void *ring_batch_worker(void *args);
+void *ring_wait_worker(void *args);
+
+static void ring_check_cqe(syscall_ring_t* ring,
+                           const uint32_t user_data,
+                           const OS_RETURN_E status)
+{
+    syscall_ring_cqe_t cqe;
+
+    if(syscall_ring_poll(ring, &cqe) != OS_NO_ERR)
+    {
+        kernel_error("Missing completion %d\n", user_data);
+    }
+    else if(cqe.user_data != user_data || cqe.status != status)
+    {
+        kernel_error("Wrong completion %d %d\n", cqe.user_data, cqe.status);
+    }
+}
+
+void *ring_batch_worker(void *args)
+{
+    sched_param_t      get_params;
+    sched_param_t      set_params;
+    futex_t            futex;
+    syscall_ring_cqe_t cqe;
+    uint32_t           processed;
+    uint32_t           i;
+    int32_t            new_pid;
+
+    (void)args;
+
+    /* No ring registered yet */
+    if(syscall_ring_submit(&ring_worker, &processed) != OS_ERR_NOT_INITIALIZED)
+    {
+        kernel_error("Submit without ring did not fail\n");
+    }
+
+    if(syscall_ring_init(&ring_worker) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init ring\n");
+        return NULL;
+    }
+
+    /* Several system calls for a single entry in the kernel */
+    syscall_do(SYSCALL_SCHED_GET_PARAMS, &set_params);
+    futex.addr = (uint32_t*)&ring_word;
+    futex.val  = 1;
+    if(syscall_ring_push(&ring_worker, SYSCALL_SCHED_GET_PARAMS,
+                         &get_params, 0) != OS_NO_ERR ||
+       syscall_ring_push(&ring_worker, SYSCALL_SCHED_SET_PARAMS,
+                         &set_params, 1) != OS_NO_ERR ||
+       syscall_ring_push(&ring_worker, SYSCALL_FUTEX_WAKE,
+                         &futex, 2) != OS_NO_ERR ||
+       syscall_ring_push(&ring_worker, SYSCALL_FORK,
+                         &new_pid, 3) != OS_NO_ERR ||
+       syscall_ring_push(&ring_worker, SYSCALL_SCHED_GET_PARAMS,
+                         NULL, 4) != OS_NO_ERR)
+    {
+        kernel_error("Failed to push in ring\n");
+    }
+
+    if(syscall_ring_submit(&ring_worker, &processed) != OS_NO_ERR ||
+       processed != 5)
+    {
+        kernel_error("Wrong ring submit %d\n", processed);
+    }
+
+    ring_check_cqe(&ring_worker, 0, OS_NO_ERR);
+    ring_check_cqe(&ring_worker, 1, OS_NO_ERR);
+    ring_check_cqe(&ring_worker, 2, OS_NO_ERR);
+    ring_check_cqe(&ring_worker, 3, OS_ERR_SYSCALL_UNKNOWN);
+    ring_check_cqe(&ring_worker, 4, OS_ERR_NULL_POINTER);
+
+    if(get_params.error != OS_NO_ERR || set_params.error != OS_NO_ERR ||
+       get_params.tid != sched_get_tid() || get_params.priority != 3 ||
+       futex.error != OS_ERR_NO_SUCH_ID)
+    {
+        kernel_error("Wrong ring results %d %d %d\n",
+                     get_params.error, set_params.error, futex.error);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Ring batch test passed\n");
+    }
+
+    /* Full submission queue */
+    for(i = 0; i < SYSCALL_RING_SIZE; ++i)
+    {
+        if(syscall_ring_push(&ring_worker, SYSCALL_SCHED_GET_PARAMS,
+                             &get_params, i) != OS_NO_ERR)
+        {
+            kernel_error("Failed to push in ring %d\n", i);
+        }
+    }
+    if(syscall_ring_push(&ring_worker, SYSCALL_SCHED_GET_PARAMS,
+                         &get_params, i) != OS_ERR_OUT_OF_BOUND)
+    {
+        kernel_error("Push in full ring did not fail\n");
+    }
+    if(syscall_ring_submit(&ring_worker, &processed) != OS_NO_ERR ||
+       processed != SYSCALL_RING_SIZE)
+    {
+        kernel_error("Wrong full ring submit %d\n", processed);
+    }
+
+    /* Full completion queue, the entry stays queued */
+    syscall_ring_push(&ring_worker, SYSCALL_SCHED_GET_PARAMS, &get_params, i);
+    if(syscall_ring_submit(&ring_worker, &processed) != OS_NO_ERR ||
+       processed != 0)
+    {
+        kernel_error("Submit with full completions %d\n", processed);
+    }
+    for(i = 0; i < SYSCALL_RING_SIZE; ++i)
+    {
+        ring_check_cqe(&ring_worker, i, OS_NO_ERR);
+    }
+    if(syscall_ring_submit(&ring_worker, &processed) != OS_NO_ERR ||
+       processed != 1)
+    {
+        kernel_error("Wrong resubmit %d\n", processed);
+    }
+    ring_check_cqe(&ring_worker, i, OS_NO_ERR);
+    if(syscall_ring_poll(&ring_worker, &cqe) != OS_ERR_NO_SUCH_ID)
+    {
+        kernel_error("Poll on empty ring did not fail\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Ring full test passed\n");
+    }
+
+    return NULL;
+}
+
+void *ring_wait_worker(void *args)
+{
+    sched_param_t params;
+    futex_t       futex;
+    uint32_t      processed;
+
+    (void)args;
+
+    if(syscall_ring_init(&ring_waiter) != OS_NO_ERR)
+    {
+        kernel_error("Failed to init waiter ring\n");
+        return NULL;
+    }
+
+    /* The batch blocks on the futex and resumes with the next entry */
+    futex.addr = (uint32_t*)&ring_word;
+    futex.val  = 0;
+    syscall_ring_push(&ring_waiter, SYSCALL_FUTEX_WAIT, &futex, 0);
+    syscall_ring_push(&ring_waiter, SYSCALL_SCHED_GET_PARAMS, &params, 1);
+
+    if(syscall_ring_submit(&ring_waiter, &processed) != OS_NO_ERR ||
+       processed != 2 || futex.error != OS_NO_ERR ||
+       params.error != OS_NO_ERR)
+    {
+        kernel_error("Wrong blocking batch %d %d\n", processed, futex.error);
+    }
+
+    ring_check_cqe(&ring_waiter, 0, OS_NO_ERR);
+    ring_check_cqe(&ring_waiter, 1, OS_NO_ERR);
+
+    ring_waiter_done = 1;
+
+    return NULL;
+}
+
+void syscall_ring_test(void)
+{
+    kernel_thread_t* thread;
+    futex_t          futex;
+
+    kernel_printf("[TESTMODE] Syscall ring test start\n");
+
+    ring_word        = 0;
+    ring_waiter_done = 0;
+
+    if(sched_create_kernel_thread(&thread, 3, "ring_batch",
+                                  THREAD_TYPE_KERNEL, 0x1000,
+                                  ring_batch_worker, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while creating the ring thread!\n");
+    }
+    sched_join_thread(thread, NULL, NULL);
+
+    if(sched_create_kernel_thread(&thread, 3, "ring_wait",
+                                  THREAD_TYPE_KERNEL, 0x1000,
+                                  ring_wait_worker, NULL) != OS_NO_ERR)
+    {
+        kernel_error("Error while creating the ring thread!\n");
+    }
+    sched_sleep(50);
+
+    if(ring_waiter_done != 0)
+    {
+        kernel_error("Blocking batch did not block\n");
+    }
+
+    ring_word  = 1;
+    futex.addr = (uint32_t*)&ring_word;
+    futex.val  = 1;
+    syscall_do(SYSCALL_FUTEX_WAKE, &futex);
+    sched_join_thread(thread, NULL, NULL);
+
+    if(ring_waiter_done != 1)
+    {
+        kernel_error("Blocking batch did not complete\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Ring blocking test passed\n");
+    }
+
+    kernel_printf("[TESTMODE] Syscall ring test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void syscall_ring_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,141 @@
+
+
+#include <test_bank.h>
+
+#if TRACE_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <cpu_api.h>
+#include <trace.h>
+
+#define TRACE_TEST_CALLS 1000
+
+static uint64_t trace_test_calls(void)
+{
+    uint64_t start;
+    int      i;
+
+    start = cpu_get_timestamp();
+    for(i = 0; i < TRACE_TEST_CALLS; ++i)
+    {
+        sched_get_current_thread();
+    }
+    return cpu_get_timestamp() - start;
+}
+
+static void trace_test_unsupported(void)
+{
+    trace_event_t event;
+    uint32_t      count;
+
+    if(trace_start() != OS_ERR_NOT_SUPPORTED ||
+       trace_stop() != OS_ERR_NOT_SUPPORTED ||
+       trace_get_event_count(0, &count) != OS_ERR_NOT_SUPPORTED ||
+       trace_get_event(0, 0, &event) != OS_ERR_NOT_SUPPORTED ||
+       trace_dump(1) != OS_ERR_NOT_SUPPORTED)
+    {
+        kernel_error("Trace API without tracer failed\n");
+        return;
+    }
+
+    kernel_printf("[TESTMODE] Trace API test passed\n");
+}
+
+static void trace_test_supported(void)
+{
+    trace_event_t event;
+    uint64_t      traced_cycles;
+    uint64_t      cycles;
+    uint32_t      cpu_id;
+    uint32_t      count;
+    uint32_t      entries;
+    uint32_t      exits;
+    uint32_t      i;
+    int32_t       id;
+
+    id = cpu_get_id();
+    cpu_id = (id < 0 || id >= MAX_CPU_COUNT) ? 0 : (uint32_t)id;
+
+    if(trace_get_event_count(MAX_CPU_COUNT, &count) != OS_ERR_OUT_OF_BOUND ||
+       trace_get_event_count(cpu_id, NULL) != OS_ERR_NULL_POINTER ||
+       trace_get_event(cpu_id, 0, NULL) != OS_ERR_NULL_POINTER)
+    {
+        kernel_error("Trace API parameters check failed\n");
+        return;
+    }
+
+    trace_stop();
+    trace_clear();
+    cycles = trace_test_calls();
+
+    trace_start();
+    traced_cycles = trace_test_calls();
+    trace_stop();
+
+    if(trace_get_event_count(cpu_id, &count) != OS_NO_ERR ||
+       count < TRACE_TEST_CALLS * 2)
+    {
+        kernel_error("Trace events count mismatch %d\n", count);
+        trace_start();
+        return;
+    }
+
+    entries = 0;
+    exits   = 0;
+    for(i = 0; trace_get_event(cpu_id, i, &event) == OS_NO_ERR; ++i)
+    {
+        if(event.function != (uintptr_t)sched_get_current_thread)
+        {
+            continue;
+        }
+        if(event.type == TRACE_EVENT_ENTRY)
+        {
+            ++entries;
+        }
+        else
+        {
+            ++exits;
+        }
+    }
+    if(entries == 0 || entries != exits)
+    {
+        kernel_error("Trace events mismatch %d %d\n", entries, exits);
+        trace_start();
+        return;
+    }
+
+    kernel_printf("Trace cost: %llu cycles per event\n",
+                  traced_cycles > cycles ?
+                    (traced_cycles - cycles) / (TRACE_TEST_CALLS * 2) : 0);
+
+    trace_dump(8);
+    trace_start();
+
+    kernel_printf("[TESTMODE] Trace API test passed\n");
+}
+
+void trace_test(void)
+{
+    kernel_printf("[TESTMODE] Trace test start\n");
+
+    if(trace_clear() == OS_ERR_NOT_SUPPORTED)
+    {
+        trace_test_unsupported();
+    }
+    else
+    {
+        trace_test_supported();
+    }
+
+    kernel_printf("[TESTMODE] Trace test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void trace_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+
+
+#include <test_bank.h>
+
+#if UART_IRQ_TEST == 1
+
+#include <kernel_output.h>
+#include <uart.h>
+#include <cpu_api.h>
+#include <string.h>
+
+#define UART_IRQ_TEST_LENGTH 1000
+
+static char uart_message[UART_IRQ_TEST_LENGTH + 2];
+
+void uart_irq_test(void)
+{
+    uint64_t start;
+    uint64_t cycles;
+
+    kernel_printf("[TESTMODE] UART interrupt test start\n");
+
+    if(uart_enable_interrupts() != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("UART interrupts enabled twice\n");
+    }
+
+    /* The message fits in the transmit ring, the call does not wait */
+    memset(uart_message, 'U', UART_IRQ_TEST_LENGTH);
+    uart_message[UART_IRQ_TEST_LENGTH]     = '\n';
+    uart_message[UART_IRQ_TEST_LENGTH + 1] = 0;
+
+    start = cpu_get_timestamp();
+    uart_put_string(uart_message);
+    cycles = cpu_get_timestamp() - start;
+
+    kernel_printf("UART write cost: %llu cycles per character\n",
+                  cycles / UART_IRQ_TEST_LENGTH);
+
+    if(uart_get_recv_dropped() != 0)
+    {
+        kernel_error("UART dropped received characters\n");
+    }
+
+    kernel_printf("[TESTMODE] UART interrupt test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void uart_irq_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,173 @@
+
+
+#include <test_bank.h>
+
+#if VDSO_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <time_management.h>
+#include <vdso.h>
+#include <sys/process.h>
+#include <sys/syscall_api.h>
+
+#define VDSO_TEST_THREADS 4
+#define VDSO_TEST_READS   10000
+
+static volatile uint32_t vdso_errors;
+
+void *vdso_thread(void *args);
+
+static void vdso_check_identity(void)
+{
+    kernel_thread_t* thread;
+
+    thread = sched_get_current_thread();
+    if(vdso_get_tid() != sched_get_tid() || gettid() != sched_get_tid() ||
+       vdso_get_pid() != sched_get_pid() || getpid() != sched_get_pid() ||
+       vdso_get_priority() != thread->priority)
+    {
+        kernel_error("Wrong shared identity %d %d %d\n",
+                     vdso_get_tid(), vdso_get_pid(), vdso_get_priority());
+        ++vdso_errors;
+    }
+}
+
+void *vdso_thread(void *args)
+{
+    sched_param_t params;
+
+    (void)args;
+
+    vdso_check_identity();
+
+    /* Let the other threads run */
+    sched_sleep(10);
+    vdso_check_identity();
+
+    params.priority = vdso_get_priority() + 1;
+    syscall_do(SYSCALL_SCHED_SET_PARAMS, &params);
+    if(params.error != OS_NO_ERR || vdso_get_priority() != params.priority)
+    {
+        kernel_error("Wrong shared priority %d\n", vdso_get_priority());
+        ++vdso_errors;
+    }
+
+    sched_sleep(10);
+    vdso_check_identity();
+
+    return NULL;
+}
+
+static void vdso_test_identity(void)
+{
+    kernel_thread_t* threads[VDSO_TEST_THREADS];
+    int              i;
+
+    vdso_errors = 0;
+
+    vdso_check_identity();
+
+    for(i = 0; i < VDSO_TEST_THREADS; ++i)
+    {
+        if(sched_create_kernel_thread(&threads[i], i + 1, "vdso_thread",
+                                      THREAD_TYPE_KERNEL, 0x1000,
+                                      vdso_thread, NULL) != OS_NO_ERR)
+        {
+            kernel_error("Error while creating the vdso thread!\n");
+        }
+    }
+    for(i = 0; i < VDSO_TEST_THREADS; ++i)
+    {
+        sched_join_thread(threads[i], NULL, NULL);
+    }
+
+    vdso_check_identity();
+
+    if(vdso_errors == 0)
+    {
+        kernel_printf("[TESTMODE] Shared identity test passed\n");
+    }
+}
+
+static void vdso_test_time(void)
+{
+    uint64_t before;
+    uint64_t after;
+    uint64_t uptime;
+    uint64_t last;
+    uint64_t period;
+    uint32_t sub_tick;
+    int      i;
+
+    /* The tick count is published on each tick */
+    before = time_get_tick_count();
+    uptime = vdso_get_tick_count();
+    after  = time_get_tick_count();
+    if(uptime < before || uptime > after)
+    {
+        kernel_error("Wrong shared tick count %llu %llu\n", uptime, before);
+    }
+
+    /* Wait for the timestamp counter calibration */
+    for(i = 0; i < 50 && vdso_data->tsc_mult == 0; ++i)
+    {
+        sched_sleep(100);
+    }
+    if(vdso_data->tsc_mult == 0)
+    {
+        kernel_error("Timestamp counter not calibrated\n");
+        return;
+    }
+
+    period   = vdso_data->tick_period;
+    last     = 0;
+    sub_tick = 0;
+    for(i = 0; i < VDSO_TEST_READS; ++i)
+    {
+        before = time_get_current_uptime();
+        uptime = vdso_get_uptime();
+        after  = time_get_current_uptime();
+
+        /* Between the enclosing ticks and never going back */
+        if(uptime < before || uptime >= after + period || uptime < last)
+        {
+            kernel_error("Wrong shared uptime %llu %llu %llu\n",
+                         before, uptime, last);
+            return;
+        }
+        if(uptime != before)
+        {
+            ++sub_tick;
+        }
+        last = uptime;
+    }
+
+    if(sub_tick == 0)
+    {
+        kernel_error("Shared uptime has no sub tick resolution\n");
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Shared time test passed\n");
+    }
+}
+
+void vdso_test(void)
+{
+    kernel_printf("[TESTMODE] Shared data page test start\n");
+
+    vdso_test_identity();
+    vdso_test_time();
+
+    kernel_printf("[TESTMODE] Shared data page test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void vdso_test(void)
+{
+
+}
+#endif
\ No newline at end of file
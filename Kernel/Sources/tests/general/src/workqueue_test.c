@@ -0,0 +1,175 @@
+
+
+#include <test_bank.h>
+
+#if WORKQUEUE_TEST == 1
+
+#include <kernel_output.h>
+#include <scheduler.h>
+#include <workqueue.h>
+
+#define WORKQUEUE_TEST_ITEMS 4
+
+static work_t work_items[WORKQUEUE_TEST_ITEMS];
+static work_t delayed_work;
+static work_t flush_work;
+
+static volatile uint32_t work_order[WORKQUEUE_TEST_ITEMS];
+static volatile uint32_t work_count;
+static volatile uint32_t delayed_count;
+static volatile OS_RETURN_E flush_error;
+
+static void workqueue_test_routine(void* args)
+{
+    if(work_count < WORKQUEUE_TEST_ITEMS)
+    {
+        work_order[work_count] = (uint32_t)(uintptr_t)args;
+    }
+    ++work_count;
+}
+
+static void workqueue_test_delayed(void* args)
+{
+    (void)args;
+
+    ++delayed_count;
+}
+
+static void workqueue_test_flush(void* args)
+{
+    (void)args;
+
+    flush_error = workqueue_flush();
+}
+
+static void workqueue_test_queue(void)
+{
+    uint32_t i;
+    work_t   work;
+
+    work_count = 0;
+
+    work.routine = NULL;
+    if(work_init(NULL, workqueue_test_routine, NULL) != OS_ERR_NULL_POINTER ||
+       work_init(&work, NULL, NULL) != OS_ERR_NULL_POINTER ||
+       workqueue_queue_work(NULL) != OS_ERR_NULL_POINTER ||
+       workqueue_queue_work(&work) != OS_ERR_NOT_INITIALIZED)
+    {
+        kernel_error("Work parameters check failed\n");
+    }
+
+    for(i = 0; i < WORKQUEUE_TEST_ITEMS; ++i)
+    {
+        work_init(&work_items[i], workqueue_test_routine, (void*)(uintptr_t)i);
+        if(workqueue_queue_work(&work_items[i]) != OS_NO_ERR)
+        {
+            kernel_error("Failed to queue work %d\n", i);
+        }
+    }
+
+    /* Queuing a pending work has no effect */
+    workqueue_queue_work(&work_items[0]);
+
+    /* The worker has a lower priority, nothing ran yet */
+    if(work_count != 0)
+    {
+        kernel_error("Work executed before flush\n");
+    }
+
+    if(workqueue_flush() != OS_NO_ERR)
+    {
+        kernel_error("Failed to flush the workqueue\n");
+    }
+
+    for(i = 0; i < WORKQUEUE_TEST_ITEMS; ++i)
+    {
+        if(work_order[i] != i)
+        {
+            break;
+        }
+    }
+    if(work_count != WORKQUEUE_TEST_ITEMS || i != WORKQUEUE_TEST_ITEMS)
+    {
+        kernel_error("Work execution failed %d %d\n", work_count, i);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Workqueue order test passed\n");
+    }
+}
+
+static void workqueue_test_delay(void)
+{
+    delayed_count = 0;
+
+    work_init(&delayed_work, workqueue_test_delayed, NULL);
+    if(workqueue_queue_delayed_work(&delayed_work, 100) != OS_NO_ERR)
+    {
+        kernel_error("Failed to queue delayed work\n");
+    }
+
+    /* Flush does not wait for the pending delays */
+    if(workqueue_flush() != OS_NO_ERR || delayed_count != 0)
+    {
+        kernel_error("Delayed work executed early %d\n", delayed_count);
+    }
+
+    sched_sleep(50);
+    if(delayed_count != 0)
+    {
+        kernel_error("Delayed work executed early %d\n", delayed_count);
+    }
+
+    sched_sleep(100);
+    if(delayed_count != 1)
+    {
+        kernel_error("Delayed work not executed %d\n", delayed_count);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Workqueue delay test passed\n");
+    }
+}
+
+static void workqueue_test_worker_flush(void)
+{
+    flush_error = OS_NO_ERR;
+
+    work_init(&flush_work, workqueue_test_flush, NULL);
+    workqueue_queue_work(&flush_work);
+    workqueue_flush();
+
+    if(flush_error != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("Worker flush did not fail %d\n", flush_error);
+    }
+    else
+    {
+        kernel_printf("[TESTMODE] Workqueue worker flush test passed\n");
+    }
+}
+
+void workqueue_test(void)
+{
+    kernel_printf("[TESTMODE] Workqueue test start\n");
+
+    if(workqueue_init() != OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        kernel_error("Workqueue initialized twice\n");
+    }
+
+    workqueue_test_queue();
+    workqueue_test_delay();
+    workqueue_test_worker_flush();
+
+    kernel_printf("[TESTMODE] Workqueue test passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void workqueue_test(void)
+{
+
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,196 @@
+/*******************************************************************************
+ * @file bench.h
+ *
+ * @see bench.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 05/04/2022
+ *
+ * @version 1.0
+ *
+ * @brief Kernel benchmark harness.
+ *
+ * @details Kernel benchmark harness. A benchmark suite is a test bank entry
+ * called from a KERNEL_BENCH_POINT. Each benchmark of the suite is executed a
+ * number of warmup iterations, then each measured iteration is timed with the
+ * CPU timestamp counter. The minimum, median, 99th percentile, maximum and mean
+ * cycles are reported on a single line:
+ * [BENCH] RESULT,suite,name,samples,min,median,p99,max,mean
+ * Values that are not timings are reported on their own line:
+ * [BENCH] METRIC,suite,name,value
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __TEST_BENCH_H_
+#define __TEST_BENCH_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal number of samples kept for one benchmark. */
+#define BENCH_MAX_SAMPLES 4096
+
+/** @brief Prefix of the benchmark result lines. */
+#define BENCH_RESULT_TAG "[BENCH] RESULT"
+
+/** @brief Prefix of the benchmark metric lines. */
+#define BENCH_METRIC_TAG "[BENCH] METRIC"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Benchmark statistics, in CPU cycles. */
+typedef struct
+{
+    /** @brief Number of samples. */
+    uint32_t samples;
+
+    /** @brief Fastest sample. */
+    uint64_t min;
+
+    /** @brief Median sample. */
+    uint64_t median;
+
+    /** @brief 99th percentile sample. */
+    uint64_t p99;
+
+    /** @brief Slowest sample. */
+    uint64_t max;
+
+    /** @brief Mean of the samples. */
+    uint64_t mean;
+} bench_stats_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Starts a benchmark suite.
+ *
+ * @details Prints the suite start line and measures the overhead of reading
+ * the timestamp counter.
+ *
+ * @param[in] suite The suite name, must stay valid until the suite ends.
+ */
+void bench_suite_start(const char* suite);
+
+/**
+ * @brief Ends the benchmark suite.
+ *
+ * @details Prints the suite result line and stops QEMU. This function never
+ * returns.
+ */
+void bench_suite_end(void);
+
+/**
+ * @brief Marks the benchmark suite as failed.
+ *
+ * @param[in] reason The failure reason.
+ */
+void bench_fail(const char* reason);
+
+/**
+ * @brief Runs and reports a benchmark.
+ *
+ * @details Calls the routine warmup times, then times each of the iterations
+ * calls. The timestamp overhead is removed from the samples.
+ *
+ * @param[in] name The benchmark name.
+ * @param[in] routine The measured routine.
+ * @param[in] args The arguments given to the routine.
+ * @param[in] warmup The number of unmeasured iterations.
+ * @param[in] iterations The number of measured iterations, at most
+ * BENCH_MAX_SAMPLES are kept.
+ */
+void bench_run(const char* name,
+               void (*routine)(void* args),
+               void* args,
+               const uint32_t warmup,
+               const uint32_t iterations);
+
+/**
+ * @brief Records a sample measured by the benchmark itself.
+ *
+ * @details Used by the benchmarks that cannot be timed around a single call,
+ * such as a switch between two threads. The sample is recorded as is, the
+ * timed benchmarks use bench_record_elapsed. Samples above BENCH_MAX_SAMPLES
+ * are dropped.
+ *
+ * @param[in] cycles The sample, in CPU cycles.
+ */
+void bench_record(const uint64_t cycles);
+
+/**
+ * @brief Records the cycles elapsed since a timestamp.
+ *
+ * @details Removes the timestamp overhead from the cycles elapsed since the
+ * start timestamp, then divides them by the number of operations measured and
+ * records the result. All the timed samples go through this function so that
+ * the suites share the same baseline.
+ *
+ * @param[in] start The timestamp read before the measured operations.
+ * @param[in] divider The number of operations measured, 0 is treated as 1.
+ *
+ * @return The recorded sample, in CPU cycles.
+ */
+uint64_t bench_record_elapsed(const uint64_t start, const uint32_t divider);
+
+/**
+ * @brief Reports the recorded samples.
+ *
+ * @details Computes the statistics of the samples recorded since the last
+ * report, prints the result line and clears the samples.
+ *
+ * @param[in] name The benchmark name.
+ * @param[out] stats The buffer receiving the statistics, can be NULL.
+ */
+void bench_report(const char* name, bench_stats_t* stats);
+
+/**
+ * @brief Reports a benchmark value that is not a timing.
+ *
+ * @param[in] name The metric name, including its unit.
+ * @param[in] value The metric value, negative values are reported as is.
+ */
+void bench_metric(const char* name, const int64_t value);
+
+/**
+ * @brief Returns the overhead of reading the timestamp counter.
+ *
+ * @return The cycles measured between two consecutive timestamp reads.
+ */
+uint64_t bench_get_timer_overhead(void);
+
+#endif /* #ifndef __TEST_BENCH_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
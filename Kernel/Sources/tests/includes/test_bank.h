@@ -23,6 +23,10 @@
     func();                       \
 }
 
+#define KERNEL_BENCH_POINT(func) { \
+    func();                        \
+}
+
 void kill_qemu(void);
 
 #ifdef ARCH_I386
@@ -42,6 +46,7 @@ void kill_qemu(void);
 #define PIC_TEST3 0
 #define IO_APIC_TEST 0
 #define IO_APIC_TEST2 0
+#define IO_APIC_TEST3 0
 #define LAPIC_TEST 0
 #define LAPIC_TEST2 0
 #define PIT_TEST 0
@@ -67,6 +72,7 @@ void pic_test2(void);
 void pic_test3(void);
 void io_apic_test(void);
 void io_apic_test2(void);
+void io_apic_test3(void);
 void lapic_test(void);
 void lapic_test2(void);
 void pit_test(void);
@@ -95,9 +101,24 @@ void lapic_timer_test(void);
 #define SCHEDULER_LOAD_TEST 0
 #define SCHEDULER_PREEMPT_TEST 0
 #define SCHEDULER_SLEEP_TEST 0
+#define SCHEDULER_WAKEUP_TEST 0
 #define FUTEX_TEST 0
 #define MUTEX_TEST 0
 #define SEMAPHORE_TEST 0
+#define RWLOCK_TEST 0
+#define COND_TEST 0
+#define BARRIER_TEST 0
+#define SYSCALL_RING_TEST 0
+#define VDSO_TEST 0
+#define SOFTIRQ_TEST 0
+#define WORKQUEUE_TEST 0
+#define INTERRUPT_STATS_TEST 0
+#define PROFILER_TEST 0
+#define TRACE_TEST 0
+#define KERNEL_LOG_TEST 0
+#define UART_IRQ_TEST 0
+#define EVENT_LOG_TEST 0
+#define SCHED_STATS_TEST 0
 #define SPINLOCK_TEST 0
 #define EXIT_TEST 0
 
@@ -117,14 +138,50 @@ void critical_test(void);
 void scheduler_load_test(void);
 void scheduler_preempt_test(void);
 void scheduler_sleep_test(void);
+void scheduler_wakeup_test(void);
 void futex_test(void);
 void mutex_test(void);
 void semaphore_test(void);
+void rwlock_test(void);
+void cond_test(void);
+void barrier_test(void);
+void syscall_ring_test(void);
+void vdso_test(void);
+void softirq_test(void);
+void workqueue_test(void);
+void interrupt_stats_test(void);
+void profiler_test(void);
+void trace_test(void);
+void kernel_log_test(void);
+void uart_irq_test(void);
+void event_log_test(void);
+void sched_stats_test(void);
 void spinlock_test(void);
 void exit_test(void);
 
+#define FUTEX_BENCH 0
+#define KHEAP_BENCH 0
+#define CONTEXT_SWITCH_BENCH 0
+#define ALLOC_BENCH 0
+#define PROCESS_BENCH 0
+#define BARRIER_BENCH 0
+#define SYSCALL_BENCH 0
+#define INTERRUPT_DISPATCH_BENCH 0
+#define PRINTF_BENCH 0
+
+void futex_bench(void);
+void kheap_bench(void);
+void context_switch_bench(void);
+void alloc_bench(void);
+void process_bench(void);
+void barrier_bench(void);
+void syscall_bench(void);
+void interrupt_dispatch_bench(void);
+void printf_bench(void);
+
 #else
 #define KERNEL_TEST_POINT(func)
+#define KERNEL_BENCH_POINT(func)
 #endif
 
 #endif /* __TEST_BANK_H_ */
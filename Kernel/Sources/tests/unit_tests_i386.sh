@@ -1,5 +1,12 @@
 #!/bin/bash
 
+# Build flags required by the tests of features compiled out by default
+function testflags() {
+    case $1 in
+        event_log_test) echo "EVENT_LOG=TRUE" ;;
+    esac
+}
+
 function testcase() {
     entry=$1
 
@@ -7,14 +14,18 @@ function testcase() {
     filename="${filename%.*}"
     filename_up=${filename^^}
 
+    flags=$(testflags $filename)
+
     echo -e "\e[94m################### Test $i/$total : $filename_up \e[39m"
     # Select the test
     sed -i "s/ $filename_up 0/ $filename_up 1/g" includes/test_bank.h
-    # Execute the test
+    # Execute the test, objects built with other flags must not be reused
     {
     rm -f *.out
     cd ../../
-    make target=x86_i386 TESTS=TRUE && (make target=x86_i386 qemu-test-mode | tee test.out)
+    if [ -n "$flags" ]; then make clean; fi
+    make target=x86_i386 TESTS=TRUE $flags && (make target=x86_i386 qemu-test-mode | tee test.out)
+    if [ -n "$flags" ]; then make clean; fi
     mv test.out Sources/tests/test.out
     cd Sources/tests
     } &> /dev/null
@@ -0,0 +1,70 @@
+#include <test_bank.h>
+
+#if IO_APIC_TEST3 == 1
+
+#include <panic.h>
+#include <interrupts.h>
+#include <kernel_output.h>
+#include <cpu.h>
+#include <io_apic.h>
+#include <stdint.h>
+#include <stddef.h>
+
+void io_apic_test3(void)
+{
+    uint32_t lapic_id;
+    uint32_t cpus[1];
+
+    /* TEST DEFAULT AFFINITY */
+    if(io_apic_get_irq_affinity(0, &lapic_id) != OS_NO_ERR || lapic_id != 0)
+    {
+        kernel_error("IO-APIC default affinity %d\n", lapic_id);
+    }
+
+    /* TEST SET / GET AFFINITY */
+    if(io_apic_set_irq_affinity(2, 0) != OS_NO_ERR ||
+       io_apic_get_irq_affinity(2, &lapic_id) != OS_NO_ERR || lapic_id != 0)
+    {
+        kernel_error("IO-APIC set affinity failed\n");
+    }
+
+    /* TEST MASK KEEPS AFFINITY */
+    io_apic_set_irq_mask(2, 1);
+    io_apic_set_irq_mask(2, 0);
+    if(io_apic_get_irq_affinity(2, &lapic_id) != OS_NO_ERR || lapic_id != 0)
+    {
+        kernel_error("IO-APIC mask changed affinity %d\n", lapic_id);
+    }
+
+    /* TEST ERRORS */
+    if(io_apic_set_irq_affinity(2, 0xFE) != OS_ERR_NO_SUCH_ID ||
+       io_apic_set_irq_affinity(255, 0) != OS_ERR_NO_SUCH_IRQ ||
+       io_apic_get_irq_affinity(255, &lapic_id) != OS_ERR_NO_SUCH_IRQ ||
+       io_apic_get_irq_affinity(2, NULL) != OS_ERR_NULL_POINTER)
+    {
+        kernel_error("IO-APIC affinity errors check failed\n");
+    }
+
+    /* TEST BALANCER */
+    cpus[0] = 0;
+    if(io_apic_balance_irqs(NULL, 1) != OS_ERR_NULL_POINTER ||
+       io_apic_balance_irqs(cpus, 0) != OS_ERR_OUT_OF_BOUND ||
+       io_apic_balance_irqs(cpus, 1) != OS_NO_ERR)
+    {
+        kernel_error("IO-APIC balancer failed\n");
+    }
+    if(io_apic_get_irq_affinity(0, &lapic_id) != OS_NO_ERR || lapic_id != 0)
+    {
+        kernel_error("IO-APIC balancer affinity %d\n", lapic_id);
+    }
+
+    kernel_printf("[TESTMODE] IO-APIC affinity tests passed\n");
+
+    /* Kill QEMU */
+    kill_qemu();
+}
+#else
+void io_apic_test3(void)
+{
+}
+#endif
\ No newline at end of file
@@ -1,9 +1,14 @@
 #ifdef TEST_MODE_ENABLED
 
+#include <kernel_output.h>
+
 void kill_qemu(void);
 
 void kill_qemu(void)
 {
+    /* Output the pending log messages before exiting */
+    kernel_log_sync();
+
     while(1)
     {
         __asm__ __volatile__("outw %w0, %w1" : : "ax" (0x2000), "Nd" (0x604));
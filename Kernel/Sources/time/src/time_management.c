@@ -34,6 +34,10 @@
 #include <bsp_api.h>       /* BSP API */
 #include <kernel_output.h> /* Kernel output manager */
 #include <interrupts.h>    /* Interrupt manager */
+#include <vdso.h>          /* Kernel shared data page */
+#include <softirq.h>       /* Deferred interrupt work */
+#include <workqueue.h>     /* Kernel workqueue */
+#include <profiler.h>      /* Kernel profiler */
 
 /* Configuration files */
 #include <config.h>
@@ -77,6 +81,9 @@ extern kernel_timer_t null_timer;
  */
 static uint64_t* sys_tick_count;
 
+/** @brief Duration of a main timer tick in nanoseconds, set in time_init. */
+static uint64_t sys_tick_slice;
+
 /** @brief The kernel's main timer interrupt source.
  *
  *  @details The kernel's main timer interrupt source. If it's function pointers
@@ -100,6 +107,9 @@ void (*schedule_routine)(cpu_state_t*, uintptr_t, stack_state_t*) = NULL;
 /** @brief RTC interrupt managet */
 void (*rtc_int_manager)(void) = NULL;
 
+/** @brief RTC interrupt bottom half. */
+static tasklet_t rtc_tasklet;
+
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
@@ -132,6 +142,16 @@ static void time_rtc_timer_handler(cpu_state_t* cpu_state,
                                    uintptr_t int_id,
                                    stack_state_t* stack);
 
+/**
+ * @brief The kernel's RTC timer bottom half.
+ *
+ * @details The kernel's RTC timer bottom half. Calls the RTC manager outside
+ * of the interrupt handler, the RTC registers reads are slow.
+ *
+ * @param[in] args Unused.
+ */
+static void time_rtc_tasklet(void* args);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -155,6 +175,14 @@ static void time_main_timer_handler(cpu_state_t* cpu_state,
     /* Add a tick count */
     ++sys_tick_count[cpu_id];
 
+    vdso_update_tick(sys_tick_count[cpu_id], sys_tick_slice);
+
+    /* Release the expired delayed work */
+    workqueue_update();
+
+    /* Sample the interrupted context */
+    profiler_update(cpu_state, stack);
+
     /* EOI */
     kernel_interrupt_set_irq_eoi(sys_main_timer.get_irq());
 
@@ -192,7 +220,7 @@ static void time_rtc_timer_handler(cpu_state_t* cpu_state,
 
     if(rtc_int_manager != NULL)
     {
-        rtc_int_manager();
+        tasklet_schedule(&rtc_tasklet);
     }
 
     KERNEL_DEBUG(TIME_MGT_DEBUG_ENABLED, "TIME", "Time manager RTC handler");
@@ -201,6 +229,16 @@ static void time_rtc_timer_handler(cpu_state_t* cpu_state,
     kernel_interrupt_set_irq_eoi(sys_rtc_timer.get_irq());
 }
 
+static void time_rtc_tasklet(void* args)
+{
+    (void)args;
+
+    if(rtc_int_manager != NULL)
+    {
+        rtc_int_manager();
+    }
+}
+
 OS_RETURN_E time_init(const kernel_timer_t* main_timer,
                       const kernel_timer_t* rtc_timer)
 {
@@ -261,6 +299,10 @@ OS_RETURN_E time_init(const kernel_timer_t* main_timer,
     /* Sets all the possible timer interrutps */
     sys_main_timer.set_frequency(KERNEL_MAIN_TIMER_FREQ);
 
+    /* Keep the 64 bits division out of the tick handler */
+    sys_tick_slice = 1000000000ULL /
+                     (uint64_t)sys_main_timer.get_frequency();
+
     err = sys_main_timer.set_handler(time_main_timer_handler);
     if(err != OS_NO_ERR)
     {
@@ -275,6 +317,7 @@ OS_RETURN_E time_init(const kernel_timer_t* main_timer,
     {
         sys_rtc_timer.set_frequency(KERNEL_RTC_TIMER_FREQ);
 
+        tasklet_init(&rtc_tasklet, time_rtc_tasklet, NULL);
         err = sys_rtc_timer.set_handler(time_rtc_timer_handler);
         if(err != OS_NO_ERR)
         {
@@ -300,7 +343,6 @@ OS_RETURN_E time_init(const kernel_timer_t* main_timer,
 
 uint64_t time_get_current_uptime(void)
 {
-    uint64_t time_slice;
     int32_t  cpu_id;
 
     cpu_id = cpu_get_id();
@@ -314,8 +356,7 @@ uint64_t time_get_current_uptime(void)
         return 0;
     }
 
-    time_slice = 1000000000ULL / (uint64_t)sys_main_timer.get_frequency();
-    return time_slice * sys_tick_count[cpu_id];
+    return sys_tick_slice * sys_tick_count[cpu_id];
 }
 
 uint64_t time_get_tick_count(void)